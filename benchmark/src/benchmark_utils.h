@@ -0,0 +1,472 @@
+#ifndef JIFFY_BENCHMARK_UTILS_H
+#define JIFFY_BENCHMARK_UTILS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/program_options.hpp>
+#include <jiffy/utils/logger.h>
+#include <jiffy/utils/string_utils.h>
+#include <jiffy/utils/thread_utils.h>
+
+/**
+ * @brief Latency histogram with HDR-style log-linear buckets.
+ *
+ * Values below 256 are recorded exactly; larger values land in one of 128
+ * buckets per power of two, so every reported value is within 0.8% of the
+ * recorded one.
+ */
+class latency_histogram {
+ public:
+  latency_histogram() : counts_(NUM_BUCKETS, 0), count_(0), sum_(0), min_(UINT64_MAX), max_(0) {}
+
+  /**
+   * @brief Record a value
+   * @param value Value
+   */
+  void record(uint64_t value) {
+    ++counts_[bucket(value)];
+    ++count_;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  /**
+   * @brief Add all values recorded in another histogram
+   * @param other Other histogram
+   */
+  void merge(const latency_histogram &other) {
+    for (std::size_t i = 0; i < NUM_BUCKETS; ++i) {
+      counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+  }
+
+  /**
+   * @brief Fetch value at a percentile
+   * @param percentile Percentile between 0 and 100
+   * @return Highest value equivalent to the value at the percentile
+   */
+  uint64_t percentile(double percentile) const {
+    if (count_ == 0) {
+      return 0;
+    }
+    auto rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count_)));
+    rank = std::max<uint64_t>(1, std::min(rank, count_));
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < NUM_BUCKETS; ++i) {
+      seen += counts_[i];
+      if (seen >= rank) {
+        return std::min(highest_value(i), max_);
+      }
+    }
+    return max_;
+  }
+
+  uint64_t count() const {
+    return count_;
+  }
+
+  uint64_t min() const {
+    return count_ == 0 ? 0 : min_;
+  }
+
+  uint64_t max() const {
+    return max_;
+  }
+
+  double mean() const {
+    return count_ == 0 ? 0.0 : static_cast<double>(sum_) / static_cast<double>(count_);
+  }
+
+ private:
+  static const std::size_t SUB_BUCKETS = 256;
+  static const std::size_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+  static const std::size_t NUM_BUCKETS = SUB_BUCKETS + (64 - 8) * HALF_SUB_BUCKETS;
+
+  static std::size_t bucket(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+      return static_cast<std::size_t>(value);
+    }
+    std::size_t shift = static_cast<std::size_t>(63 - __builtin_clzll(value)) - 7;
+    return SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS + static_cast<std::size_t>((value >> shift) - HALF_SUB_BUCKETS);
+  }
+
+  static uint64_t highest_value(std::size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+      return bucket;
+    }
+    std::size_t shift = (bucket - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+    uint64_t sub = (bucket - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+  }
+
+  std::vector<uint64_t> counts_;
+  uint64_t count_;
+  uint64_t sum_;
+  uint64_t min_;
+  uint64_t max_;
+};
+
+/**
+ * @brief Load generation parameters.
+ *
+ * In the "closed" mode every client issues its next request as soon as the
+ * previous one returns. In the "constant" and "poisson" modes requests are
+ * scheduled at a fixed aggregate rate, with fixed or exponentially distributed
+ * gaps, and latency is measured from the scheduled start so that a slow
+ * request also counts against the requests queued up behind it.
+ */
+struct load_spec {
+  /* Load mode, closed, constant or poisson */
+  std::string mode = "closed";
+  /* Aggregate request rate in requests per second, for open loop modes */
+  double rate = 0;
+  /* Number of requests per client run before measuring */
+  std::size_t warmup_ops = 0;
+  /* Random seed */
+  uint64_t seed = 0;
+  /* Bool for pinning clients to cores */
+  bool pin_clients = false;
+};
+
+/* Benchmark result */
+struct benchmark_result {
+  /* Number of measured requests */
+  std::size_t num_ops = 0;
+  /* Measurement duration in seconds */
+  double duration_s = 0;
+  /* Latency in nanoseconds */
+  latency_histogram latency_ns;
+
+  double throughput() const {
+    return duration_s > 0 ? static_cast<double>(num_ops) / duration_s : 0;
+  }
+};
+
+/**
+ * @brief Runs a benchmark operation on a number of clients, one thread each.
+ *
+ * Each client first runs an optional setup, then warm-up requests, and then
+ * the measured requests; all clients start warm-up and measurement together.
+ * The operation is called with the client index and a request index that
+ * counts warm-up and measured requests, so it never exceeds
+ * warmup_ops + num_ops.
+ */
+class benchmark_harness {
+ public:
+  typedef std::function<void(std::size_t, std::size_t)> op_type;
+  typedef std::function<void(std::size_t)> setup_type;
+  typedef std::chrono::steady_clock clock_type;
+
+  /**
+   * @brief Constructor
+   * @param num_clients Number of clients
+   * @param num_ops Number of measured requests per client
+   * @param spec Load generation parameters
+   */
+  benchmark_harness(std::size_t num_clients, std::size_t num_ops, const load_spec &spec)
+      : num_clients_(num_clients), num_ops_(num_ops), spec_(spec) {
+    if (spec_.mode != "closed" && spec_.mode != "constant" && spec_.mode != "poisson") {
+      throw std::invalid_argument("No such load mode " + spec_.mode);
+    }
+    if (spec_.mode != "closed" && spec_.rate <= 0) {
+      throw std::invalid_argument("Open loop load needs a positive rate");
+    }
+  }
+
+  /**
+   * @brief Run benchmark
+   * @param op Operation
+   * @param setup Per-client setup, run before timing starts
+   * @return Benchmark result
+   */
+  benchmark_result run(const op_type &op, const setup_type &setup = nullptr) {
+    std::vector<std::thread> workers(num_clients_);
+    std::vector<latency_histogram> histograms(num_clients_);
+    std::vector<clock_type::time_point> ends(num_clients_);
+    clock_type::time_point measure_begin;
+    barrier ready(num_clients_), warm(num_clients_);
+    for (std::size_t i = 0; i < num_clients_; ++i) {
+      workers[i] = std::thread([&, i] {
+        if (setup) {
+          setup(i);
+        }
+        std::mt19937_64 rng(spec_.seed * 1000003 + i);
+        // Each client issues an equal share of the aggregate rate
+        double gap_ns = spec_.mode == "closed" ? 0 : 1E9 * static_cast<double>(num_clients_) / spec_.rate;
+        std::exponential_distribution<double> poisson_gap(gap_ns > 0 ? 1.0 / gap_ns : 1.0);
+        ready.wait();
+        run_client(op, i, 0, spec_.warmup_ops, gap_ns, poisson_gap, rng, nullptr);
+        warm.wait([&] { measure_begin = clock_type::now(); });
+        run_client(op, i, spec_.warmup_ops, spec_.warmup_ops + num_ops_, gap_ns, poisson_gap, rng, &histograms[i]);
+        ends[i] = clock_type::now();
+      });
+      if (spec_.pin_clients) {
+        jiffy::utils::thread_utils::set_core_affinity(workers[i], static_cast<int>(i));
+      }
+    }
+    for (auto &worker: workers) {
+      worker.join();
+    }
+    benchmark_result result;
+    auto measure_end = *std::max_element(ends.begin(), ends.end());
+    result.duration_s = std::chrono::duration<double>(measure_end - measure_begin).count();
+    for (auto &histogram: histograms) {
+      result.latency_ns.merge(histogram);
+    }
+    result.num_ops = result.latency_ns.count();
+    return result;
+  }
+
+ private:
+  /* Single use barrier; the last thread to arrive runs a callback before releasing the others */
+  class barrier {
+   public:
+    explicit barrier(std::size_t count) : count_(count), arrived_(0) {}
+
+    void wait(const std::function<void()> &on_last = nullptr) {
+      std::unique_lock<std::mutex> lock(mtx_);
+      if (++arrived_ == count_) {
+        if (on_last) {
+          on_last();
+        }
+        cv_.notify_all();
+        return;
+      }
+      cv_.wait(lock, [&] { return arrived_ == count_; });
+    }
+
+   private:
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::size_t count_;
+    std::size_t arrived_;
+  };
+
+  void run_client(const op_type &op,
+                  std::size_t client,
+                  std::size_t begin,
+                  std::size_t end,
+                  double gap_ns,
+                  std::exponential_distribution<double> &poisson_gap,
+                  std::mt19937_64 &rng,
+                  latency_histogram *histogram) {
+    auto scheduled = clock_type::now();
+    for (std::size_t j = begin; j < end; ++j) {
+      clock_type::time_point start;
+      if (spec_.mode == "closed") {
+        start = clock_type::now();
+      } else {
+        auto gap = spec_.mode == "constant" ? gap_ns : poisson_gap(rng);
+        scheduled += std::chrono::nanoseconds(static_cast<int64_t>(gap));
+        std::this_thread::sleep_until(scheduled);
+        start = scheduled;
+      }
+      op(client, j);
+      if (histogram != nullptr) {
+        histogram->record(static_cast<uint64_t>(
+                              std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start).count()));
+      }
+    }
+  }
+
+  std::size_t num_clients_;
+  std::size_t num_ops_;
+  load_spec spec_;
+};
+
+/* Options shared by the benchmarks */
+struct benchmark_options {
+  std::string address = "127.0.0.1";
+  int service_port = 9090;
+  int lease_port = 9091;
+  int num_blocks = 1;
+  int chain_length = 1;
+  std::size_t num_ops = 100000;
+  std::size_t data_size = 64;
+  std::size_t max_clients = 64;
+  std::vector<std::string> op_types;
+  std::string path = "/tmp";
+  std::string backing_path = "local://tmp";
+  std::string key_distribution = "uniform";
+  double theta = 0;
+  std::string json_path;
+  load_spec load;
+
+  /**
+   * @brief Parse command line
+   * @param argc Number of arguments
+   * @param argv Arguments
+   * @param default_ops Comma separated operations run by default
+   * @param default_data_size Default payload size
+   * @param default_pin_clients Default for pinning clients to cores
+   * @return False if the benchmark should not run, e.g. for --help
+   */
+  bool parse(int argc,
+             char **argv,
+             const std::string &default_ops,
+             std::size_t default_data_size,
+             bool default_pin_clients) {
+    namespace po = boost::program_options;
+    std::string ops;
+    po::options_description desc("options");
+    desc.add_options()
+        ("help,h", "Print help message")
+        ("host,H", po::value<std::string>(&address)->default_value("127.0.0.1"), "Directory server host")
+        ("service-port,s", po::value<int>(&service_port)->default_value(9090), "Directory service port")
+        ("lease-port,l", po::value<int>(&lease_port)->default_value(9091), "Directory lease port")
+        ("num-blocks,b", po::value<int>(&num_blocks)->default_value(1), "Number of blocks")
+        ("chain-length,c", po::value<int>(&chain_length)->default_value(1), "Replica chain length")
+        ("num-ops,n", po::value<std::size_t>(&num_ops)->default_value(100000), "Measured requests per run")
+        ("data-size,d", po::value<std::size_t>(&data_size)->default_value(default_data_size), "Payload size")
+        ("max-clients,C", po::value<std::size_t>(&max_clients)->default_value(64),
+         "Largest number of clients; runs double from one")
+        ("ops,o", po::value<std::string>(&ops)->default_value(default_ops), "Comma separated operations")
+        ("path,p", po::value<std::string>(&path)->default_value("/tmp"), "Data structure path")
+        ("backing-path,P", po::value<std::string>(&backing_path)->default_value("local://tmp"), "Backing path")
+        ("mode,m", po::value<std::string>(&load.mode)->default_value("closed"), "Load mode: closed, constant or poisson")
+        ("rate,r", po::value<double>(&load.rate)->default_value(0), "Aggregate requests per second for open loop modes")
+        ("warmup-ops,w", po::value<std::size_t>(&load.warmup_ops)->default_value(0),
+         "Requests per client run before measuring")
+        ("seed", po::value<uint64_t>(&load.seed)->default_value(0), "Random seed")
+        ("pin-clients", po::value<bool>(&load.pin_clients)->default_value(default_pin_clients),
+         "Pin clients to cores")
+        ("key-distribution,k", po::value<std::string>(&key_distribution)->default_value("uniform"),
+         "Key distribution: uniform or zipf")
+        ("theta,t", po::value<double>(&theta)->default_value(0),
+         "Zipf skew parameter (0: pure zipf, 1: uniform)")
+        ("json,j", po::value<std::string>(&json_path)->default_value(""), "Append results as JSON lines to file");
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    if (vm.count("help")) {
+      std::cout << desc << std::endl;
+      return false;
+    }
+    po::notify(vm);
+    op_types = jiffy::utils::string_utils::split(ops, ',');
+    return true;
+  }
+
+  /**
+   * @brief Log all options
+   */
+  void log() const {
+    using namespace jiffy::utils;
+    LOG(log_level::info) << "host: " << address;
+    LOG(log_level::info) << "service-port: " << service_port;
+    LOG(log_level::info) << "lease-port: " << lease_port;
+    LOG(log_level::info) << "num-blocks: " << num_blocks;
+    LOG(log_level::info) << "chain-length: " << chain_length;
+    LOG(log_level::info) << "num-ops: " << num_ops;
+    LOG(log_level::info) << "data-size: " << data_size;
+    LOG(log_level::info) << "max-clients: " << max_clients;
+    LOG(log_level::info) << "path: " << path;
+    LOG(log_level::info) << "backing-path: " << backing_path;
+    LOG(log_level::info) << "mode: " << load.mode;
+    LOG(log_level::info) << "rate: " << load.rate;
+    LOG(log_level::info) << "warmup-ops: " << load.warmup_ops;
+    LOG(log_level::info) << "pin-clients: " << load.pin_clients;
+    LOG(log_level::info) << "key-distribution: " << key_distribution;
+    LOG(log_level::info) << "theta: " << theta;
+    LOG(log_level::info) << "json: " << json_path;
+  }
+};
+
+/**
+ * @brief Log a benchmark result and append it to the JSON lines file, if any
+ * @param benchmark Benchmark name
+ * @param op_type Operation
+ * @param num_clients Number of clients
+ * @param options Benchmark options
+ * @param result Benchmark result
+ */
+inline void report_result(const std::string &benchmark,
+                          const std::string &op_type,
+                          std::size_t num_clients,
+                          const benchmark_options &options,
+                          const benchmark_result &result) {
+  using namespace jiffy::utils;
+  const auto &latency = result.latency_ns;
+  LOG(log_level::info) << "===== " << op_type << " ======";
+  LOG(log_level::info) << "\t" << result.num_ops << " requests completed in " << result.duration_s << " s";
+  LOG(log_level::info) << "\t" << num_clients << " parallel clients, " << options.load.mode << " load";
+  LOG(log_level::info) << "\t" << options.data_size << " payload";
+  LOG(log_level::info) << "\tThroughput: " << result.throughput() << " requests per second";
+  LOG(log_level::info) << "\tLatency (us): mean " << latency.mean() / 1E3
+                       << " p50 " << latency.percentile(50) / 1E3
+                       << " p99 " << latency.percentile(99) / 1E3
+                       << " p999 " << latency.percentile(99.9) / 1E3
+                       << " max " << latency.max() / 1E3;
+  if (options.json_path.empty()) {
+    return;
+  }
+  std::ostringstream out;
+  out << std::setprecision(10)
+      << "{\"benchmark\": \"" << benchmark << "\""
+      << ", \"op\": \"" << op_type << "\""
+      << ", \"num_clients\": " << num_clients
+      << ", \"num_blocks\": " << options.num_blocks
+      << ", \"chain_length\": " << options.chain_length
+      << ", \"data_size\": " << options.data_size
+      << ", \"mode\": \"" << options.load.mode << "\""
+      << ", \"rate\": " << options.load.rate
+      << ", \"warmup_ops\": " << options.load.warmup_ops
+      << ", \"key_distribution\": \"" << options.key_distribution << "\""
+      << ", \"theta\": " << options.theta
+      << ", \"num_ops\": " << result.num_ops
+      << ", \"duration_s\": " << result.duration_s
+      << ", \"throughput_ops\": " << result.throughput()
+      << ", \"latency_us\": {\"mean\": " << latency.mean() / 1E3
+      << ", \"min\": " << latency.min() / 1E3
+      << ", \"p50\": " << latency.percentile(50) / 1E3
+      << ", \"p90\": " << latency.percentile(90) / 1E3
+      << ", \"p99\": " << latency.percentile(99) / 1E3
+      << ", \"p999\": " << latency.percentile(99.9) / 1E3
+      << ", \"max\": " << latency.max() / 1E3 << "}}";
+  std::ofstream json(options.json_path, std::ios::app);
+  json << out.str() << std::endl;
+}
+
+/**
+ * @brief Generate key indices for a client
+ * @param num_keys Number of keys to draw from
+ * @param count Number of key indices
+ * @param options Benchmark options
+ * @param zipf Zipf generator, used for the zipf distribution
+ * @param rng Random number generator, used for the uniform distribution
+ * @return Key indices
+ */
+template<typename Generator>
+std::vector<std::size_t> key_indices(std::size_t num_keys,
+                                     std::size_t count,
+                                     const benchmark_options &options,
+                                     Generator *zipf,
+                                     std::mt19937_64 &rng) {
+  std::vector<std::size_t> indices(count);
+  std::uniform_int_distribution<std::size_t> uniform(0, num_keys - 1);
+  for (auto &index: indices) {
+    index = options.key_distribution == "zipf" ? static_cast<std::size_t>(zipf->next()) % num_keys : uniform(rng);
+  }
+  return indices;
+}
+
+#endif //JIFFY_BENCHMARK_UTILS_H
@@ -2,6 +2,8 @@
 #include <thread>
 #include <iostream>
 #include <string>
+#include <random>
+#include <algorithm>
 #include <boost/program_options.hpp>
 #include <jiffy/utils/logger.h>
 #include <jiffy/utils/signal_handling.h>
@@ -11,25 +13,98 @@
 #include "jiffy/storage/hashtable/hash_table_ops.h"
 #include "jiffy/storage/hashtable/hash_table_partition.h"
 
-using namespace ::jiffy::client;
-using namespace ::jiffy::directory;
 using namespace ::jiffy::storage;
 using namespace ::jiffy::utils;
 
-using namespace ::apache::thrift;
-
 namespace  bpo = boost::program_options;
 
+static void report(const std::string &op, const std::string &index_type, std::size_t num_ops, uint64_t tot_time) {
+    LOG(log_level::info) << "===== " << op << " (" << index_type << ") ======";
+    LOG(log_level::info) << "\t" << num_ops << " requests completed in " << tot_time << " us";
+    LOG(log_level::info) << "\tLatency: " << static_cast<double>(tot_time) * 1E3 / num_ops << " ns per request";
+    LOG(log_level::info) << "\tThroughput: " << num_ops * 1E6 / tot_time << " requests per second";
+}
+
+// Index only: lookups and bytes per entry, without the partition's request handling
+static void bench_index(const std::string &index_type, hash_table_index_type type, block_memory_manager &manager,
+                        const std::vector<std::string> &keys, const std::string &value) {
+    binary_allocator alloc(&manager);
+    hash_table_type table(type, alloc);
+    std::vector<binary> lookup_keys;
+    lookup_keys.reserve(keys.size());
+    for (const auto &key: keys) {
+        lookup_keys.emplace_back(key, alloc);
+    }
+
+    auto bench_begin = time_utils::now_us();
+    for (const auto &key: keys) {
+        table.emplace(binary(key, alloc), binary(value, alloc));
+    }
+    report("index_insert", index_type, keys.size(), time_utils::now_us() - bench_begin);
+
+    std::vector<std::size_t> order(keys.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    std::size_t found = 0;
+    bench_begin = time_utils::now_us();
+    for (auto i: order) {
+        found += table.find(lookup_keys[i]) != table.end();
+    }
+    report("index_lookup", index_type, keys.size(), time_utils::now_us() - bench_begin);
+    LOG(log_level::info) << "\tFound: " << found;
+    LOG(log_level::info) << "\tIndex overhead: " << static_cast<double>(table.footprint()) / table.size()
+                         << " bytes per entry";
+
+    bench_begin = time_utils::now_us();
+    for (auto i: order) {
+        table.erase(lookup_keys[i]);
+    }
+    report("index_erase", index_type, keys.size(), time_utils::now_us() - bench_begin);
+}
+
+// Full partition: put, get and remove requests against a block configured with the index
+static void bench_partition(const std::string &index_type, block_memory_manager &manager,
+                            const std::vector<std::string> &keys, const std::string &value) {
+    property_map conf;
+    conf.set("hashtable.index_type", index_type);
+    hash_table_partition block(&manager, "local://tmp", "0_65536", "regular", conf);
+
+    auto bench_begin = time_utils::now_us();
+    for (const auto &key: keys) {
+        response resp;
+        block.put(resp, {"put", key, value});
+    }
+    report("hash_table_put", index_type, keys.size(), time_utils::now_us() - bench_begin);
+
+    bench_begin = time_utils::now_us();
+    for (const auto &key: keys) {
+        response resp;
+        block.get(resp, {"get", key});
+    }
+    report("hash_table_get", index_type, keys.size(), time_utils::now_us() - bench_begin);
+
+    bench_begin = time_utils::now_us();
+    for (const auto &key: keys) {
+        response resp;
+        block.remove(resp, {"remove", key});
+    }
+    report("hash_table_remove", index_type, keys.size(), time_utils::now_us() - bench_begin);
+}
+
 int main(int argc, char const *argv[])
 {
-
-    bpo::options_description opts("all options"); 
+    bpo::options_description opts("all options");
     bpo::variables_map vm;
 
-    opts.add_options()  
+    opts.add_options()
     ("pmem", bpo::value<std::string>(), "Run the benchmark under PMEM mode. Usage: '-pmem=PMEM_ADDRESS'.")
     ("dram", "Run the benchmark under DRAM mode. Usage: '-dram'.")
-    ("help", "This benchmark only runs by block.");
+    ("num-ops", bpo::value<int>()->default_value(1000000), "Number of keys.")
+    ("key-size", bpo::value<int>()->default_value(16), "Key size in bytes.")
+    ("data-size", bpo::value<int>()->default_value(64), "Value size in bytes.")
+    ("help", "Compares the hash table index types on a single block.");
 
     try {
         bpo::store(bpo::parse_command_line(argc, argv, opts), vm);
@@ -38,99 +113,49 @@ int main(int argc, char const *argv[])
         std::cout << "Wrong command line arguments! Please use '-help' to see how to correctly use arguments.\n";
         return 0;
     }
-    
-    if (vm.size() > 1 || vm.empty()) {
-        std::cout << "Please use one option. See '-help' for more information. \n";
-    }
+
     if (vm.count("help")) {
-        std::cout << opts << std::endl;   
-    }
-    
-    else if (vm.count("dram")) {
-        std::string memory_mode = "DRAM";
-        std::string pmem_path = "";
-        void* mem_kind = mem_utils::init_kind(memory_mode, pmem_path);
+        std::cout << opts << std::endl;
+        return 0;
     }
-    else if (vm.count("pmem")) {
-        std::string memory_mode = "PMEM";
-        std::string pmem_path = vm["pmem"].as<std::string>();
-        void* mem_kind = mem_utils::init_kind(memory_mode, pmem_path);
+
+    std::string memory_mode = "DRAM";
+    std::string pmem_path = "";
+    if (vm.count("pmem")) {
+        memory_mode = "PMEM";
+        pmem_path = vm["pmem"].as<std::string>();
     }
+    void* mem_kind = mem_utils::init_kind(memory_mode, pmem_path);
 
-    std::string address = "127.0.0.1";
-    int service_port = 9090;
-    int lease_port = 9091;
-    int num_blocks = 1;
-    int chain_length = 1;
-    int num_ops = 100000;
-    int data_size = 1024;
-    
-    std::string path = "/tmp";
-    std::string backing_path = "local://tmp";
-    // Output all the configuration parameters:
-    LOG(log_level::info) << "host: " << address;
-    LOG(log_level::info) << "service-port: " << service_port;
-    LOG(log_level::info) << "lease-port: " << lease_port;
-    LOG(log_level::info) << "num-blocks: " << num_blocks;
-    LOG(log_level::info) << "chain-length: " << chain_length;
+    int num_ops = vm["num-ops"].as<int>();
+    int key_size = vm["key-size"].as<int>();
+    int data_size = vm["data-size"].as<int>();
+    LOG(log_level::info) << "memory-mode: " << memory_mode;
     LOG(log_level::info) << "num-ops: " << num_ops;
+    LOG(log_level::info) << "key-size: " << key_size;
     LOG(log_level::info) << "data-size: " << data_size;
-    LOG(log_level::info) << "path: " << path;
-    LOG(log_level::info) << "backing-path: " << backing_path;
-
-    size_t capacity = 134217728;
-    block_memory_manager manager(capacity, memory_mode, mem_kind);
-    hash_table_partition block(&manager);
-    block.slot_range(0, hash_slot::MAX);
-
-    auto bench_begin = time_utils::now_us();
-    uint64_t tot_time = 0;
-    std::string data_ (data_size, 'x');
 
+    std::vector<std::string> keys;
+    keys.reserve(static_cast<std::size_t>(num_ops));
     for (int i = 0; i < num_ops; ++i) {
-        response resp;
-        block.put(resp, {"put", std::to_string(i), data_});
+        auto key = std::to_string(i);
+        key.resize(std::max<std::size_t>(key.size(), static_cast<std::size_t>(key_size)), '0');
+        keys.push_back(key);
     }
-	auto bench_end = time_utils::now_us();
-	tot_time = bench_end - bench_begin;
-	LOG(log_level::info) << "===== " << "hash_table_put" << " ======";
-	LOG(log_level::info) << "total_time: " << tot_time;
-	LOG(log_level::info) << "\t" << num_ops << " requests completed in " << tot_time
-											<< " us";
-	LOG(log_level::info) << "\t" << data_size << " payload";
-	LOG(log_level::info) << "\tThroughput: " << num_ops * 1E3 / tot_time << " requests per microsecond";
+    std::string data_(static_cast<std::size_t>(data_size), 'x');
 
-    bench_begin = time_utils::now_us();
-    tot_time = 0;
-
-    for (int i = 0; i < num_ops; ++i) {
-        response resp;
-        block.get(resp, {"get", std::to_string(i)});
+    size_t capacity = 1UL << 32;
+    std::vector<std::pair<std::string, hash_table_index_type>> index_types = {
+        {"unordered_map", unordered_map_index},
+        {"open_addressing", open_addressing_index}
+    };
+    for (const auto &index_type: index_types) {
+        block_memory_manager manager(capacity, memory_mode, mem_kind);
+        bench_index(index_type.first, index_type.second, manager, keys, data_);
     }
-	bench_end = time_utils::now_us();
-	tot_time = bench_end - bench_begin;
-	LOG(log_level::info) << "===== " << "hash_table_get" << " ======";
-	LOG(log_level::info) << "total_time: " << tot_time;
-	LOG(log_level::info) << "\t" << num_ops << " requests completed in " << tot_time
-											<< " us";
-	LOG(log_level::info) << "\t" << data_size << " payload";
-	LOG(log_level::info) << "\tThroughput: " << num_ops * 1E3 / tot_time << " requests per microsecond";
-  
-	bench_begin = time_utils::now_us();
-    tot_time = 0;
-
-	for (int i = 0; i < num_ops; ++i) {
-        response resp;
-        block.remove(resp, {"remove", std::to_string(i)});
+    for (const auto &index_type: index_types) {
+        block_memory_manager manager(capacity, memory_mode, mem_kind);
+        bench_partition(index_type.first, manager, keys, data_);
     }
-  
-	bench_end = time_utils::now_us();
-	tot_time = bench_end - bench_begin;
-	LOG(log_level::info) << "===== " << "hash_table_remove" << " ======";
-	LOG(log_level::info) << "total_time: " << tot_time;
-	LOG(log_level::info) << "\t" << num_ops << " requests completed in " << tot_time
-											<< " us";
-	LOG(log_level::info) << "\t" << data_size << " payload";
-	LOG(log_level::info) << "\tThroughput: " << num_ops * 1E3 / tot_time << " requests per microsecond";
-	
-}
\ No newline at end of file
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include "auto_scaling_scheduler.h"
+#include "jiffy/utils/logger.h"
+#include "jiffy/utils/time_utils.h"
+
+namespace jiffy {
+namespace auto_scaling {
+
+using namespace utils;
+
+auto_scaling_scheduler::auto_scaling_scheduler(std::size_t num_workers)
+    : num_workers_(num_workers == 0 ? 1 : num_workers), stop_(false) {}
+
+auto_scaling_scheduler::~auto_scaling_scheduler() {
+  stop();
+}
+
+void auto_scaling_scheduler::start() {
+  for (std::size_t i = 0; i < num_workers_; ++i) {
+    workers_.emplace_back([&] { run(); });
+  }
+}
+
+void auto_scaling_scheduler::stop() {
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    stop_.store(true);
+  }
+  cv_.notify_all();
+  for (auto &worker: workers_) {
+    if (worker.joinable())
+      worker.join();
+  }
+  workers_.clear();
+}
+
+void auto_scaling_scheduler::submit(const std::string &key, task_type task) {
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    auto &queue = keys_[key];
+    queue.tasks.push_back(queued_task{std::move(task), time_utils::now_us()});
+    if (!queue.running && queue.tasks.size() == 1) {
+      ready_.push_back(key);
+    }
+    ++stats_.num_submitted;
+    ++stats_.num_queued;
+  }
+  cv_.notify_one();
+}
+
+auto_scaling_stats auto_scaling_scheduler::stats() const {
+  std::unique_lock<std::mutex> lock(mtx_);
+  return stats_;
+}
+
+void auto_scaling_scheduler::run() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (true) {
+    cv_.wait(lock, [&] { return stop_.load() || !ready_.empty(); });
+    if (stop_.load()) {
+      return;
+    }
+    auto key = std::move(ready_.front());
+    ready_.pop_front();
+    auto &queue = keys_[key];
+    auto next = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    queue.running = true;
+    auto now = time_utils::now_us();
+    auto queue_delay = now > next.submit_time_us ? now - next.submit_time_us : 0;
+    --stats_.num_queued;
+    ++stats_.num_running;
+    stats_.total_queue_delay_us += queue_delay;
+    stats_.max_queue_delay_us = std::max(stats_.max_queue_delay_us, queue_delay);
+    lock.unlock();
+
+    LOG(log_level::info) << "Auto-scaling " << key << " after waiting " << queue_delay << " us";
+    bool failed = false;
+    try {
+      next.task();
+    } catch (std::exception &e) {
+      LOG(log_level::error) << "Auto-scaling " << key << " failed: " << e.what();
+      failed = true;
+    }
+
+    lock.lock();
+    --stats_.num_running;
+    ++stats_.num_completed;
+    stats_.num_failed += failed;
+    auto it = keys_.find(key);
+    it->second.running = false;
+    if (it->second.tasks.empty()) {
+      keys_.erase(it);
+    } else {
+      ready_.push_back(key);
+      cv_.notify_one();
+    }
+  }
+}
+
+}
+}
@@ -0,0 +1,124 @@
+#ifndef JIFFY_AUTO_SCALING_SCHEDULER_H
+#define JIFFY_AUTO_SCALING_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace jiffy {
+namespace auto_scaling {
+
+/* Auto scaling statistics */
+struct auto_scaling_stats {
+  /* Number of requests submitted */
+  std::size_t num_submitted{0};
+  /* Number of requests completed, successfully or not */
+  std::size_t num_completed{0};
+  /* Number of requests that failed */
+  std::size_t num_failed{0};
+  /* Number of requests waiting to run */
+  std::size_t num_queued{0};
+  /* Number of requests running */
+  std::size_t num_running{0};
+  /* Total time requests spent waiting to run */
+  uint64_t total_queue_delay_us{0};
+  /* Longest time a request spent waiting to run */
+  uint64_t max_queue_delay_us{0};
+};
+
+/* Auto scaling scheduler class
+ * Runs auto scaling requests on a bounded pool of workers. Requests with the
+ * same key, i.e. touching the same partitions, run one at a time in arrival
+ * order, while requests with different keys run in parallel. */
+class auto_scaling_scheduler {
+ public:
+  typedef std::function<void()> task_type;
+
+  /**
+   * @brief Constructor
+   * @param num_workers Number of worker threads
+   */
+
+  explicit auto_scaling_scheduler(std::size_t num_workers = 8);
+
+  /**
+   * @brief Destructor
+   */
+
+  ~auto_scaling_scheduler();
+
+  /**
+   * @brief Start worker threads
+   */
+
+  void start();
+
+  /**
+   * @brief Stop worker threads, dropping requests that have not started
+   */
+
+  void stop();
+
+  /**
+   * @brief Queue auto scaling request
+   * @param key Key of the partitions being scaled
+   * @param task Auto scaling request
+   */
+
+  void submit(const std::string &key, task_type task);
+
+  /**
+   * @brief Fetch auto scaling statistics
+   * @return Auto scaling statistics
+   */
+
+  auto_scaling_stats stats() const;
+
+ private:
+  /* Queued request */
+  struct queued_task {
+    task_type task;
+    uint64_t submit_time_us;
+  };
+
+  /* Requests waiting on a key */
+  struct key_queue {
+    std::deque<queued_task> tasks;
+    bool running{false};
+  };
+
+  /**
+   * @brief Run requests as keys become ready
+   */
+
+  void run();
+
+  /* Mutex protecting the queues and statistics */
+  mutable std::mutex mtx_;
+  /* Condition variable signalled when a key becomes ready */
+  std::condition_variable cv_;
+  /* Requests waiting on each key */
+  std::map<std::string, key_queue> keys_;
+  /* Keys with waiting requests and no running request, in arrival order */
+  std::deque<std::string> ready_;
+  /* Statistics */
+  auto_scaling_stats stats_;
+  /* Number of worker threads */
+  std::size_t num_workers_;
+  /* Worker threads */
+  std::vector<std::thread> workers_;
+  /* Stop bool */
+  std::atomic_bool stop_;
+};
+
+}
+}
+
+#endif //JIFFY_AUTO_SCALING_SCHEDULER_H
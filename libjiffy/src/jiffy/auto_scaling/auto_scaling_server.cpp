@@ -17,9 +17,10 @@ using namespace ::apache::thrift::server;
 std::shared_ptr<TThreadedServer> auto_scaling_server::create(const std::string& directory_host,
                                                              int directory_port,
                                                              const std::string &address,
-                                                             int port) {
+                                                             int port,
+                                                             std::size_t num_workers) {
   std::shared_ptr<auto_scaling_serviceIfFactory>
-      clone_factory(new auto_scaling_service_factory(directory_host, directory_port));
+      clone_factory(new auto_scaling_service_factory(directory_host, directory_port, num_workers));
   std::shared_ptr<auto_scaling_serviceProcessorFactory>
       proc_factory(new auto_scaling_serviceProcessorFactory(clone_factory));
   std::shared_ptr<TServerSocket> sock(new TServerSocket(address, port));
@@ -14,12 +14,14 @@ class auto_scaling_server {
    * @param directory_port Directory server port number
    * @param address Auto scaling server host address
    * @param port Auto scaling server port number
+   * @param num_workers Number of auto scaling requests that can run in parallel
    * @return Server
    */
   static std::shared_ptr<apache::thrift::server::TThreadedServer> create(const std::string& directory_host,
                                                                          int directory_port,
                                                                          const std::string &address,
-                                                                         int port);
+                                                                         int port,
+                                                                         std::size_t num_workers = 8);
 
 };
 
@@ -2,6 +2,7 @@
 #define JIFFY_AUTO_SCALING_RPC_SERVICE_FACTORY_H
 
 #include "auto_scaling_service.h"
+#include "auto_scaling_scheduler.h"
 
 namespace jiffy {
 namespace auto_scaling {
@@ -12,8 +13,15 @@ class auto_scaling_service_factory : public auto_scaling_serviceIfFactory {
    * @brief Constructor
    * @param directory_host Directory server host name
    * @param directory_port Directory server port number
+   * @param num_workers Number of auto scaling requests that can run in parallel
    */
-  explicit auto_scaling_service_factory(const std::string directory_host, int directory_port);
+  explicit auto_scaling_service_factory(const std::string directory_host, int directory_port, std::size_t num_workers);
+
+  /**
+   * @brief Destructor
+   */
+
+  ~auto_scaling_service_factory() override;
 
   /**
    * @brief Fetch auto scaling service handler
@@ -35,6 +43,8 @@ class auto_scaling_service_factory : public auto_scaling_serviceIfFactory {
   std::string directory_host_;
   /* Directory port number */
   int directory_port_;
+  /* Scheduler shared by all handlers */
+  std::shared_ptr<auto_scaling_scheduler> scheduler_;
 
 };
 
@@ -6,7 +6,6 @@
 #include "jiffy/storage/hashtable/hash_table_ops.h"
 #include "jiffy/storage/fifoqueue/fifo_queue_ops.h"
 #include "jiffy/utils/string_utils.h"
-#include <mutex>
 #include <chrono>
 #include <jiffy/storage/client/data_structure_client.h>
 
@@ -16,26 +15,35 @@ namespace auto_scaling {
 using namespace utils;
 using namespace storage;
 
-/* Mutex to make sure auto_scaling server handles one request at a time */
-std::mutex MTX;
-
-#define LOCK MTX.lock()
-#define UNLOCK MTX.unlock()
-#define UNLOCK_AND_RETURN \
-  MTX.unlock();           \
-  return
-#define UNLOCK_AND_THROW(ex)  \
-  MTX.unlock();               \
-  throw make_exception(ex)
-
-auto_scaling_service_handler::auto_scaling_service_handler(const std::string &directory_host, int directory_port)
-    : directory_host_(directory_host), directory_port_(directory_port) {}
+auto_scaling_service_handler::auto_scaling_service_handler(const std::string &directory_host,
+                                                           int directory_port,
+                                                           std::shared_ptr<auto_scaling_scheduler> scheduler)
+    : directory_host_(directory_host), directory_port_(directory_port), scheduler_(std::move(scheduler)) {}
 
 void auto_scaling_service_handler::auto_scaling(const std::vector<std::string> &cur_chain,
                                                 const std::string &path,
                                                 const std::map<std::string, std::string> &conf) {
+  // Merges pick their target among all partitions of the path, so they run one at a time per path;
+  // other requests only reshape their own partition, so they run one at a time per partition
+  auto key = path;
+  if (conf.at("type") != "hash_table_merge" && !cur_chain.empty()) {
+    key += "@" + cur_chain.front();
+  }
+  // The handler lives only as long as its connection, so the request must not refer to it
+  auto directory_host = directory_host_;
+  auto directory_port = directory_port_;
+  scheduler_->submit(key, [directory_host, directory_port, cur_chain, path, conf] {
+    scale(directory_host, directory_port, cur_chain, path, conf);
+  });
+}
+
+void auto_scaling_service_handler::scale(const std::string &directory_host,
+                                         int directory_port,
+                                         const std::vector<std::string> &cur_chain,
+                                         const std::string &path,
+                                         const std::map<std::string, std::string> &conf) {
   std::string scaling_type = conf.find("type")->second;
-  auto fs = std::make_shared<directory::directory_client>(directory_host_, directory_port_);
+  auto fs = std::make_shared<directory::directory_client>(directory_host, directory_port);
   if (scaling_type == "file") {
     LOG(log_level::info) << "Auto-scaling file";
     auto dst_name = std::stoi(conf.find("next_partition_name")->second);
@@ -44,13 +52,21 @@ void auto_scaling_service_handler::auto_scaling(const std::vector<std::string> &
     std::shared_ptr<replica_chain_client> src_vector;
     std::vector<std::string> args{"update_partition"};
     auto start = time_utils::now_us();
+    src_vector = std::make_shared<replica_chain_client>(fs, path, cur_chain, FILE_OPS);
     for(std::size_t i = 0; i < chain_to_add; i++) {
       // Add replica chain at directory server
-      args.push_back(pack(fs->add_block(path, std::to_string(dst_name + i), "regular")));
+      try {
+        args.push_back(pack(fs->add_block(path, std::to_string(dst_name + i), "regular")));
+      } catch (std::exception &e) {
+        if (i == 0) {
+          // Nothing was added, so the partition is told to ask again on its next add_blocks
+          src_vector->run_command({"update_partition"});
+        }
+        throw;
+      }
     }
     auto finish_adding_replica_chain = time_utils::now_us();
     // Update source partition
-    src_vector = std::make_shared<replica_chain_client>(fs, path, cur_chain, FILE_OPS);
     src_vector->run_command(args);
 
     auto finish_updating_partition = time_utils::now_us();
@@ -72,13 +88,21 @@ void auto_scaling_service_handler::auto_scaling(const std::vector<std::string> &
     std::shared_ptr<replica_chain_client> src_vector;
     std::vector<std::string> args{"update_partition"};
     auto start = time_utils::now_us();
+    src_vector = std::make_shared<replica_chain_client>(fs, path, cur_chain, SHARED_LOG_OPS);
     for(std::size_t i = 0; i < chain_to_add; i++) {
       // Add replica chain at directory server
-      args.push_back(pack(fs->add_block(path, std::to_string(dst_name + i), "regular")));
+      try {
+        args.push_back(pack(fs->add_block(path, std::to_string(dst_name + i), "regular")));
+      } catch (std::exception &e) {
+        if (i == 0) {
+          // Nothing was added, so the partition is told to ask again on its next add_blocks
+          src_vector->run_command({"update_partition"});
+        }
+        throw;
+      }
     }
     auto finish_adding_replica_chain = time_utils::now_us();
     // Update source partition
-    src_vector = std::make_shared<replica_chain_client>(fs, path, cur_chain, SHARED_LOG_OPS);
     src_vector->run_command(args);
 
     auto finish_updating_partition = time_utils::now_us();
@@ -102,19 +126,35 @@ void auto_scaling_service_handler::auto_scaling(const std::vector<std::string> &
     auto dst_name = std::to_string(split_range_beg) + "_" + std::to_string(split_range_end);
     auto src_name = std::to_string(slot_range_beg) + "_" + std::to_string(split_range_beg);
 
-    // Add replica chain at directory server
     auto start = time_utils::now_us();
-    // Making it split importing since we don't want the client to refresh and add this block
-    auto dst_chain = fs->add_block(path, dst_name, "split_importing");
-    auto finish_adding_replica_chain = time_utils::now_us();
-
-    // Update source and destination partitions before transfer
-    auto exp_target = pack(dst_chain);
     auto cur_name = std::to_string(slot_range_beg) + "_" + std::to_string(slot_range_end);
     auto src = std::make_shared<replica_chain_client>(fs, path, cur_chain, HT_OPS);
-    auto dst = std::make_shared<replica_chain_client>(fs, path, dst_chain, HT_OPS);
-    dst->run_command({"update_partition", dst_name, "importing$" + dst_name});
-    src->run_command({"update_partition", cur_name, "exporting$" + dst_name + "$" + exp_target});
+    directory::replica_chain dst_chain;
+    std::shared_ptr<replica_chain_client> dst;
+    auto finish_adding_replica_chain = start;
+    try {
+      // Add replica chain at directory server
+      // Making it split importing since we don't want the client to refresh and add this block
+      dst_chain = fs->add_block(path, dst_name, "split_importing");
+      finish_adding_replica_chain = time_utils::now_us();
+
+      // Update source and destination partitions before transfer
+      auto exp_target = pack(dst_chain);
+      dst = std::make_shared<replica_chain_client>(fs, path, dst_chain, HT_OPS);
+      dst->run_command({"update_partition", dst_name, "importing$" + dst_name});
+      src->run_command({"update_partition", cur_name, "exporting$" + dst_name + "$" + exp_target});
+    } catch (std::exception &e) {
+      // No data has moved yet, so the source goes back to regular and can split again later
+      if (!dst_chain.block_ids.empty()) {
+        try {
+          fs->remove_block(path, dst_name);
+        } catch (std::exception &re) {
+          LOG(log_level::warn) << "Could not remove partition " << dst_name << " of failed split: " << re.what();
+        }
+      }
+      src->run_command({"update_partition", cur_name, "regular"});
+      throw;
+    }
     auto finish_updating_partition_before = time_utils::now_us();
 
     // Transfer the data from source to destination
@@ -149,7 +189,6 @@ void auto_scaling_service_handler::auto_scaling(const std::vector<std::string> &
                          << finish_updating_partition_after - finish_updating_partition_dir;
 
   } else if (scaling_type == "hash_table_merge") {
-    LOCK;
     LOG(log_level::info) << "Auto-scaling hash table (merge)";
 
     auto storage_capacity = std::stoull(conf.at("storage_capacity"));
@@ -160,11 +199,11 @@ void auto_scaling_service_handler::auto_scaling(const std::vector<std::string> &
     try {
       src = std::make_shared<replica_chain_client>(fs, path, cur_chain, HT_OPS);
     } catch (std::exception &e) {
-      UNLOCK_AND_THROW("Unable to connect to src partition");
+      throw make_exception("Unable to connect to src partition");
     }
     auto update_resp = src->run_command({"update_partition", "merging", "merging"}); // TODO: Why "merging" twice?
     if (update_resp[0] == "!fail") {
-      UNLOCK_AND_THROW("Partition is under auto_scaling");
+      throw make_exception("Partition is under auto_scaling");
     }
     auto name = update_resp[1];
     auto slot_range = string_utils::split(name, '_', 2);
@@ -172,9 +211,16 @@ void auto_scaling_service_handler::auto_scaling(const std::vector<std::string> &
     auto merge_range_end = std::stoi(slot_range[1]);
 
     directory::replica_chain merge_target;
-    if (!find_merge_target(merge_target, fs, path, storage_capacity, merge_range_beg, merge_range_end)) {
+    bool found;
+    try {
+      found = find_merge_target(merge_target, fs, path, storage_capacity, merge_range_beg, merge_range_end);
+    } catch (std::exception &e) {
+      src->run_command({"update_partition", name, "regular$" + name});
+      throw;
+    }
+    if (!found) {
       src->run_command({"update_partition", name, "regular$" + name});
-      UNLOCK_AND_THROW("Adjacent partitions are not found or full");
+      throw make_exception("Adjacent partitions are not found or full");
     }
     auto finish_finding_chain_to_merge = time_utils::now_us();
 
@@ -187,7 +233,7 @@ void auto_scaling_service_handler::auto_scaling(const std::vector<std::string> &
       dst_old_name = dst->recv_response().front();
     } catch (std::exception &e) {
       src->run_command({"update_partition", name, "regular$" + name});
-      UNLOCK_AND_RETURN;
+      return;
     }
 
     auto exp_target = pack(merge_target);
@@ -196,9 +242,8 @@ void auto_scaling_service_handler::auto_scaling(const std::vector<std::string> &
     // We don't need to update the src partition cause it will be deleted anyway
     if (dst_old_name == "!fail") {
       src->run_command({"update_partition", name, "regular$" + name});
-      UNLOCK_AND_RETURN;
+      return;
     }
-    UNLOCK;
     auto dst_slot_range = string_utils::split(dst_old_name, '_', 2);
     auto dst_name = (std::stoi(dst_slot_range[0]) == merge_range_end) ?
                     std::to_string(merge_range_beg) + "_" + dst_slot_range[1]:
@@ -244,11 +289,18 @@ void auto_scaling_service_handler::auto_scaling(const std::vector<std::string> &
     // Add a replica chain at directory server
     auto start = time_utils::now_us();
     auto dst_name = conf.find("next_partition_name")->second;
-    auto dst_replica_chain = fs->add_block(path, dst_name, "regular");
+    auto src = std::make_shared<replica_chain_client>(fs, path, cur_chain, FQ_CMDS);
+    directory::replica_chain dst_replica_chain;
+    try {
+      dst_replica_chain = fs->add_block(path, dst_name, "regular");
+    } catch (std::exception &e) {
+      // The partition is told so that it can ask again once it is overloaded
+      src->run_command({"update_partition"});
+      throw;
+    }
     auto finish_adding_replica_chain = time_utils::now_us();
 
     // Update source partition
-    auto src = std::make_shared<replica_chain_client>(fs, path, cur_chain, FQ_CMDS);
     src->run_command({"update_partition", pack(dst_replica_chain)});
     auto finish_updating_partition = time_utils::now_us();
 
@@ -281,26 +333,38 @@ void auto_scaling_service_handler::hash_table_transfer_data(const std::shared_pt
                                                             size_t slot_end,
                                                             size_t batch_size) {
 
-  // Transfer the data from source to destination
-  bool has_more = true;
-  std::vector<std::string> read_args{"get_range_data",
-                                     std::to_string(slot_beg),
-                                     std::to_string(slot_end),
-                                     std::to_string(batch_size)};
-  while (has_more) {
+  // Transfer the data from source to destination, resuming the source scan at a cursor
+  // so each batch only touches the entries it returns. Entries can move behind the cursor
+  // while the source is modified, so the transfer only ends once a single scan of the whole
+  // source finds nothing left in the slot range
+  std::size_t cursor = 0;
+  while (true) {
     // Read data to split
-    auto write_args = src->run_command(read_args);
-    if (write_args.back() == "!empty") {
-      break;
-    } else if (write_args.size() < batch_size) {
-      has_more = false;
+    auto scan_begin = cursor;
+    auto write_args = src->run_command({"get_range_data",
+                                        std::to_string(slot_beg),
+                                        std::to_string(slot_end),
+                                        std::to_string(batch_size),
+                                        std::to_string(cursor)});
+    if (write_args[0] != "!ok") {
+      throw make_exception("Failed to read data to transfer: " + write_args[0]);
+    }
+    cursor = std::stoull(write_args[1]);
+    write_args.erase(write_args.begin() + 1);
+    if (write_args.size() == 1) {
+      if (scan_begin == 0 && cursor == 0) {
+        break;
+      }
+      continue;
     }
 
-    // write_args.insert(write_args.begin(), "scale_put"); // Add scale_put command name
     write_args[0] = "scale_put";
 
     // Write data to dst partition
     auto response = dst->run_command(write_args);
+    if (response[0] != "!ok") {
+      throw make_exception("Failed to write transferred data: " + response[0]);
+    }
 
     // Remove data from src partition
     auto transfer_size = write_args.size() - 1; // Account for "scale_put" command name
@@ -314,7 +378,11 @@ void auto_scaling_service_handler::hash_table_transfer_data(const std::shared_pt
     }
     assert(write_args.size() == 1);
     assert(remove_args.size() == transfer_size / 2 + 1);
+    // Entries left behind would be returned by every later scan, so the transfer cannot go on without this
     auto ret = src->run_command(remove_args);
+    if (ret[0] != "!ok") {
+      throw make_exception("Failed to remove transferred data: " + ret[0]);
+    }
   }
 }
 
@@ -3,6 +3,7 @@
 
 #include <jiffy/storage/client/replica_chain_client.h>
 #include "auto_scaling_service.h"
+#include "auto_scaling_scheduler.h"
 #include "jiffy/storage/client/replica_chain_client.h"
 
 namespace jiffy {
@@ -15,11 +16,14 @@ class auto_scaling_service_handler : public auto_scaling_serviceIf {
    * @brief Constructor
    * @param directory_host Directory server host name
    * @param directory_port Directory server port number
+   * @param scheduler Scheduler running the auto scaling requests
    */
-  explicit auto_scaling_service_handler(const std::string& directory_host, int directory_port);
+  auto_scaling_service_handler(const std::string& directory_host,
+                               int directory_port,
+                               std::shared_ptr<auto_scaling_scheduler> scheduler);
 
   /**
-   * @brief Auto scaling handling function
+   * @brief Auto scaling handling function, queues the request on the scheduler
    * @param cur_chain Current replica chain
    * @param path Path
    * @param conf Configuration map
@@ -29,6 +33,22 @@ class auto_scaling_service_handler : public auto_scaling_serviceIf {
                     const std::map<std::string, std::string> &conf) override;
 
  private:
+  /**
+   * @brief Run auto scaling request
+   * A request that fails before any data or partition has changed hands tells the
+   * source partition, so that it can ask to scale again
+   * @param directory_host Directory server host name
+   * @param directory_port Directory server port number
+   * @param cur_chain Current replica chain
+   * @param path Path
+   * @param conf Configuration map
+   */
+  static void scale(const std::string &directory_host,
+                    int directory_port,
+                    const std::vector<std::string> &cur_chain,
+                    const std::string &path,
+                    const std::map<std::string, std::string> &conf);
+
   /**
    * @brief Packs chain into a single string
    * @param chain Replica chain
@@ -84,6 +104,8 @@ class auto_scaling_service_handler : public auto_scaling_serviceIf {
   std::string directory_host_;
   /* Directory server port number */
   int directory_port_;
+  /* Auto scaling scheduler */
+  std::shared_ptr<auto_scaling_scheduler> scheduler_;
 };
 
 }
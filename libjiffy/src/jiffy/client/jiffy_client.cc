@@ -9,8 +9,10 @@ using namespace directory;
 
 jiffy_client::jiffy_client(const std::string &host, int dir_port, int lease_port)
     : fs_(std::make_shared<directory_client>(host, dir_port)),
-      lease_worker_(host, lease_port) {
+      lease_worker_(host, lease_port),
+      event_loop_(std::make_shared<storage::client_event_loop>()) {
   lease_worker_.start();
+  event_loop_->start();
 }
 
 std::shared_ptr<directory::directory_client> jiffy_client::fs() {
@@ -21,6 +23,10 @@ directory::lease_renewal_worker &jiffy_client::lease_worker() {
   return lease_worker_;
 }
 
+std::shared_ptr<storage::client_event_loop> jiffy_client::event_loop() {
+  return event_loop_;
+}
+
 void jiffy_client::begin_scope(const std::string &path) {
   lease_worker_.add_path(path);
 }
@@ -37,19 +43,12 @@ std::shared_ptr<storage::hash_table_client> jiffy_client::create_hash_table(cons
                                                                             int32_t permissions,
                                                                             const std::map<std::string,
                                                                                            std::string> &tags) {
-  std::vector<std::string> block_names;
-  std::vector<std::string> block_metadata;
-  int32_t slot_range = storage::hash_slot::MAX / num_blocks;
-  for (int32_t i = 0; i < num_blocks; ++i) {
-    int32_t begin = i * slot_range;
-    int32_t end = (i == num_blocks - 1) ? storage::hash_slot::MAX : (i + 1) * slot_range;
-    block_names.push_back(std::to_string(begin) + "_" + std::to_string(end));
-    block_metadata.emplace_back("regular");
-  }
+  auto block_names = storage::hash_slot::slot_ranges(num_blocks);
+  std::vector<std::string> block_metadata(block_names.size(), "regular");
   auto s = fs_->create(path, "hashtable", backing_path, num_blocks, chain_length, flags, permissions, block_names,
                        block_metadata, tags);
   begin_scope(path);
-  return std::make_shared<storage::hash_table_client>(fs_, path, s);
+  return attach(std::make_shared<storage::hash_table_client>(fs_, path, s));
 }
 
 std::shared_ptr<storage::file_client> jiffy_client::create_file(const std::string &path,
@@ -68,7 +67,7 @@ std::shared_ptr<storage::file_client> jiffy_client::create_file(const std::strin
   auto s = fs_->create(path, "file", backing_path, num_blocks, chain_length, flags, permissions, block_names,
                        block_metadata, tags);
   begin_scope(path);
-  return std::make_shared<storage::file_client>(fs_, path, s);
+  return attach(std::make_shared<storage::file_client>(fs_, path, s));
 }
 
 std::shared_ptr<storage::fifo_queue_client> jiffy_client::create_fifo_queue(const std::string &path,
@@ -88,13 +87,13 @@ std::shared_ptr<storage::fifo_queue_client> jiffy_client::create_fifo_queue(cons
   auto s = fs_->create(path, "fifoqueue", backing_path, num_blocks, chain_length, flags, permissions,
                        block_names, block_metadata, tags);
   begin_scope(path);
-  return std::make_shared<storage::fifo_queue_client>(fs_, path, s);
+  return attach(std::make_shared<storage::fifo_queue_client>(fs_, path, s));
 }
 
 std::shared_ptr<storage::hash_table_client> jiffy_client::open_hash_table(const std::string &path) {
   auto s = fs_->open(path);
   begin_scope(path);
-  return std::make_shared<storage::hash_table_client>(fs_, path, s);
+  return attach(std::make_shared<storage::hash_table_client>(fs_, path, s));
 }
 
 std::shared_ptr<storage::shared_log_client> jiffy_client::create_shared_log(const std::string &path,
@@ -113,25 +112,25 @@ std::shared_ptr<storage::shared_log_client> jiffy_client::create_shared_log(cons
   auto s = fs_->create(path, "shared_log", backing_path, num_blocks, chain_length, flags, permissions, block_names,
                        block_metadata, tags);
   begin_scope(path);
-  return std::make_shared<storage::shared_log_client>(fs_, path, s);
+  return attach(std::make_shared<storage::shared_log_client>(fs_, path, s));
 }
 
 std::shared_ptr<storage::file_client> jiffy_client::open_file(const std::string &path) {
   auto s = fs_->open(path);
   begin_scope(path);
-  return std::make_shared<storage::file_client>(fs_, path, s);
+  return attach(std::make_shared<storage::file_client>(fs_, path, s));
 }
 
 std::shared_ptr<storage::shared_log_client> jiffy_client::open_shared_log(const std::string &path) {
   auto s = fs_->open(path);
   begin_scope(path);
-  return std::make_shared<storage::shared_log_client>(fs_, path, s);
+  return attach(std::make_shared<storage::shared_log_client>(fs_, path, s));
 }
 
 std::shared_ptr<storage::fifo_queue_client> jiffy_client::open_fifo_queue(const std::string &path) {
   auto s = fs_->open(path);
   begin_scope(path);
-  return std::make_shared<storage::fifo_queue_client>(fs_, path, s);
+  return attach(std::make_shared<storage::fifo_queue_client>(fs_, path, s));
 }
 
 std::shared_ptr<storage::hash_table_client> jiffy_client::open_or_create_hash_table(const std::string &path,
@@ -143,19 +142,12 @@ std::shared_ptr<storage::hash_table_client> jiffy_client::open_or_create_hash_ta
                                                                                     int32_t permissions,
                                                                                     const std::map<std::string,
                                                                                                    std::string> &tags) {
-  std::vector<std::string> block_names;
-  std::vector<std::string> block_metadata;
-  int32_t slot_range = storage::hash_slot::MAX / num_blocks;
-  for (int32_t i = 0; i < num_blocks; ++i) {
-    int32_t begin = i * slot_range;
-    int32_t end = (i == num_blocks - 1) ? storage::hash_slot::MAX : (i + 1) * slot_range;
-    block_names.push_back(std::to_string(begin) + "_" + std::to_string(end));
-    block_metadata.emplace_back("regular");
-  }
+  auto block_names = storage::hash_slot::slot_ranges(num_blocks);
+  std::vector<std::string> block_metadata(block_names.size(), "regular");
   auto s = fs_->open_or_create(path, "hashtable", backing_path, num_blocks, chain_length, flags, permissions,
                                block_names, block_metadata, tags);
   begin_scope(path);
-  return std::make_shared<storage::hash_table_client>(fs_, path, s, timeout_ms);
+  return attach(std::make_shared<storage::hash_table_client>(fs_, path, s, timeout_ms));
 }
 
 std::shared_ptr<storage::file_client> jiffy_client::open_or_create_file(const std::string &path,
@@ -175,7 +167,7 @@ std::shared_ptr<storage::file_client> jiffy_client::open_or_create_file(const st
   auto s = fs_->open_or_create(path, "file", backing_path, num_blocks, chain_length, flags, permissions,
                                block_names, block_metadata, tags);
   begin_scope(path);
-  return std::make_shared<storage::file_client>(fs_, path, s);
+  return attach(std::make_shared<storage::file_client>(fs_, path, s));
 }
 
 std::shared_ptr<storage::shared_log_client> jiffy_client::open_or_create_shared_log(const std::string &path,
@@ -195,7 +187,7 @@ std::shared_ptr<storage::shared_log_client> jiffy_client::open_or_create_shared_
   auto s = fs_->open_or_create(path, "shared_log", backing_path, num_blocks, chain_length, flags, permissions,
                                block_names, block_metadata, tags);
   begin_scope(path);
-  return std::make_shared<storage::shared_log_client>(fs_, path, s);
+  return attach(std::make_shared<storage::shared_log_client>(fs_, path, s));
 }
 
 std::shared_ptr<storage::fifo_queue_client> jiffy_client::open_or_create_fifo_queue(const std::string &path,
@@ -215,7 +207,7 @@ std::shared_ptr<storage::fifo_queue_client> jiffy_client::open_or_create_fifo_qu
   auto s = fs_->open_or_create(path, "fifoqueue", backing_path, num_blocks, chain_length, flags, permissions,
                                block_names, block_metadata, tags);
   begin_scope(path);
-  return std::make_shared<storage::fifo_queue_client>(fs_, path, s);
+  return attach(std::make_shared<storage::fifo_queue_client>(fs_, path, s));
 }
 
 std::shared_ptr<storage::data_structure_listener> jiffy_client::listen(const std::string &path) {
@@ -36,6 +36,12 @@ class jiffy_client {
    */
   directory::lease_renewal_worker &lease_worker();
 
+  /**
+   * @brief Fetch event loop completing asynchronous requests of the data structure clients
+   * @return Event loop
+   */
+  std::shared_ptr<storage::client_event_loop> event_loop();
+
   /**
    * @brief Begin scope, add path to lease worker
    * @param path File Path
@@ -50,6 +56,13 @@ class jiffy_client {
 
   /**
    * @brief Create hash table
+   * A "hashtable.expected_bytes" tag pre-splits the table into as many slot range partitions as the
+   * expected data needs, and a "hashtable.expected_keys" tag pre-sizes the index of each partition
+   * A "chain.replica_reads" tag set to "true" lets gets and exists be served by any replica of a chain
+   * A "hashtable.incremental_sync" tag set to "true" makes sync write only the keys changed since the
+   * last sync, as deltas over a snapshot rewritten every "hashtable.max_deltas" syncs
+   * A "hashtable.background_sync" tag set to "true" makes sync write a point-in-time copy on a background
+   * thread, at no more than "hashtable.sync_bytes_per_sec" bytes per second if that tag is set
    * @param path File path
    * @param backing_path File backing path
    * @param num_blocks Number of blocks
@@ -69,6 +82,7 @@ class jiffy_client {
 
   /**
    * @brief Create file
+   * Reads go to any replica of a chain if the "chain.replica_reads" tag is "true"
    * @param path File path
    * @param backing_path File backing path
    * @param num_blocks Number of blocks
@@ -88,6 +102,7 @@ class jiffy_client {
 
 /**
    * @brief Create shared_log
+   * Reads and scans go to any replica of a chain if the "chain.replica_reads" tag is "true"
    * @param path shared_log path
    * @param backing_path shared_log backing path
    * @param num_blocks Number of blocks
@@ -154,6 +169,7 @@ class jiffy_client {
 
   /**
    * @brief Open or create hash table
+   * Capacity hint tags are applied as in create_hash_table when the table is created
    * @param path File path
    * @param backing_path File backing path
    * @param num_blocks Number of blocks
@@ -274,10 +290,24 @@ class jiffy_client {
   void load(const std::string &path, const std::string &dest);
 
  private:
+  /**
+   * @brief Complete asynchronous requests of the data structure client on the event loop
+   * @tparam T Data structure client type
+   * @param client Data structure client
+   * @return Data structure client
+   */
+  template<typename T>
+  std::shared_ptr<T> attach(std::shared_ptr<T> client) {
+    client->event_loop(event_loop_);
+    return client;
+  }
+
   /* Directory client */
   std::shared_ptr<directory::directory_client> fs_;
   /* Lease worker */
   directory::lease_renewal_worker lease_worker_;
+  /* Event loop for asynchronous requests, shared by all data structure clients */
+  std::shared_ptr<storage::client_event_loop> event_loop_;
 };
 
 }
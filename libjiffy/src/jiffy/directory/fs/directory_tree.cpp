@@ -1,6 +1,8 @@
 #include "directory_tree.h"
 
 #include "../../utils/retry_utils.h"
+#include "jiffy/storage/hashtable/hash_slot.h"
+#include <cmath>
 
 namespace jiffy {
 namespace directory {
@@ -84,27 +86,8 @@ data_status directory_tree::create(const std::string &path,
 
   auto parent = std::dynamic_pointer_cast<ds_dir_node>(node);
 
-  std::vector<replica_chain> blocks;
-  for (int32_t i = 0; i < num_blocks; ++i) {
-    replica_chain chain(allocator_->allocate(static_cast<size_t>(chain_length), {}), storage_mode::in_memory);
-    chain.name = partition_names[i];
-    chain.metadata = partition_metadata[i];
-    assert(chain.block_ids.size() == chain_length);
-    blocks.push_back(chain);
-    using namespace storage;
-    if (chain_length == 1) {
-      storage_->create_partition(chain.block_ids[0], type, backing_path, chain.name, chain.metadata, tags);
-      storage_->setup_chain(chain.block_ids[0], path, chain.block_ids, chain_role::singleton, "nil");
-    } else {
-      for (int32_t j = 0; j < chain_length; ++j) {
-        std::string block_id = chain.block_ids[j];
-        std::string next_block_id = (j == chain_length - 1) ? "nil" : chain.block_ids[j + 1];
-        int32_t role = (j == 0) ? chain_role::head : (j == chain_length - 1) ? chain_role::tail : chain_role::mid;
-        storage_->create_partition(block_id, type, backing_path, chain.name, chain.metadata, tags);
-        storage_->setup_chain(block_id, path, chain.block_ids, role, next_block_id);
-      }
-    }
-  }
+  auto blocks = allocate_partitions(path, type, backing_path, num_blocks, chain_length, partition_names,
+                                    partition_metadata, tags);
   auto child = std::make_shared<ds_file_node>(filename, type, backing_path, chain_length, blocks, flags, permissions,
                                               tags);
 
@@ -156,27 +139,8 @@ data_status directory_tree::open_or_create(const std::string &path,
   if (chain_length == 0) {
     throw directory_ops_exception("Chain length cannot be zero");
   }
-  std::vector<replica_chain> blocks;
-  for (int32_t i = 0; i < num_blocks; ++i) {
-    replica_chain chain(allocator_->allocate(static_cast<size_t>(chain_length), {}), storage_mode::in_memory);
-    chain.name = partition_names[i];
-    chain.metadata = partition_metadata[i];
-    assert(chain.block_ids.size() == chain_length);
-    blocks.push_back(chain);
-    using namespace storage;
-    if (chain_length == 1) {
-      storage_->create_partition(chain.block_ids[0], type, backing_path, chain.name, chain.metadata, tags);
-      storage_->setup_chain(chain.block_ids[0], path, chain.block_ids, chain_role::singleton, "nil");
-    } else {
-      for (int32_t j = 0; j < chain_length; ++j) {
-        std::string block_id = chain.block_ids[j];
-        std::string next_block_id = (j == chain_length - 1) ? "nil" : chain.block_ids[j + 1];
-        int32_t role = (j == 0) ? chain_role::head : (j == chain_length - 1) ? chain_role::tail : chain_role::mid;
-        storage_->create_partition(block_id, type, backing_path, chain.name, chain.metadata, tags);
-        storage_->setup_chain(block_id, path, chain.block_ids, role, next_block_id);
-      }
-    }
-  }
+  auto blocks = allocate_partitions(path, type, backing_path, num_blocks, chain_length, partition_names,
+                                    partition_metadata, tags);
   auto child = std::make_shared<ds_file_node>(filename, type, backing_path, chain_length, blocks, flags, permissions,
                                               tags);
   parent->add_child(child);
@@ -184,6 +148,104 @@ data_status directory_tree::open_or_create(const std::string &path,
   return child->dstatus();
 }
 
+std::vector<replica_chain> directory_tree::allocate_partitions(const std::string &path,
+                                                               const std::string &type,
+                                                               const std::string &backing_path,
+                                                               int32_t num_blocks,
+                                                               int32_t chain_length,
+                                                               const std::vector<std::string> &partition_names,
+                                                               const std::vector<std::string> &partition_metadata,
+                                                               const std::map<std::string, std::string> &tags){
+  std::vector<replica_chain> blocks;
+  try {
+    for (int32_t i = 0; i < num_blocks; ++i) {
+      replica_chain chain(allocator_->allocate(static_cast<size_t>(chain_length), {}), storage_mode::in_memory);
+      chain.name = partition_names[i];
+      chain.metadata = partition_metadata[i];
+      assert(chain.block_ids.size() == chain_length);
+      blocks.push_back(chain);
+    }
+    if (type == "hashtable" && tags.find("hashtable.expected_bytes") != tags.end()) {
+      auto num_partitions = hash_table_partitions(tags, storage_->storage_capacity(blocks.front().block_ids.front()));
+      if (num_partitions > num_blocks) {
+        LOG(log_level::info) << "Pre-splitting hash table " << path << " into " << num_partitions << " partitions";
+        auto names = storage::hash_slot::slot_ranges(num_partitions);
+        for (int32_t i = num_blocks; i < num_partitions; ++i) {
+          blocks.emplace_back(allocator_->allocate(static_cast<size_t>(chain_length), {}), storage_mode::in_memory);
+        }
+        for (int32_t i = 0; i < num_partitions; ++i) {
+          blocks[i].name = names[i];
+          blocks[i].metadata = "regular";
+        }
+      }
+    }
+    std::vector<storage::partition_setup> setups;
+    for (const auto &chain: blocks) {
+      add_partition_setups(setups, chain, path, type, backing_path, tags);
+    }
+    storage_->create_partitions(setups);
+  } catch (std::exception &e) {
+    // Blocks of a file that could not be created go back to the free list
+    std::vector<std::string> allocated;
+    for (const auto &chain: blocks) {
+      allocated.insert(allocated.end(), chain.block_ids.begin(), chain.block_ids.end());
+    }
+    allocator_->free(allocated);
+    throw;
+  }
+  return blocks;
+}
+
+int32_t directory_tree::hash_table_partitions(const std::map<std::string, std::string> &tags,
+                                              std::size_t block_capacity) {
+  double expected_bytes;
+  double threshold_hi = 0.95;
+  try {
+    expected_bytes = std::stod(tags.at("hashtable.expected_bytes"));
+    auto it = tags.find("hashtable.capacity_threshold_hi");
+    if (it != tags.end()) {
+      threshold_hi = std::stod(it->second);
+    }
+  } catch (std::exception &e) {
+    throw directory_ops_exception("Malformed hash table capacity hint: " + std::string(e.what()));
+  }
+  // Leave headroom below the split threshold for skew across slot ranges
+  auto partition_bytes = static_cast<double>(block_capacity) * threshold_hi * 0.8;
+  if (partition_bytes <= 0 || expected_bytes <= partition_bytes) {
+    return 1;
+  }
+  return static_cast<int32_t>(std::min(std::ceil(expected_bytes / partition_bytes),
+                                       static_cast<double>(storage::hash_slot::MAX)));
+}
+
+void directory_tree::add_partition_setups(std::vector<storage::partition_setup> &setups,
+                                          const replica_chain &chain,
+                                          const std::string &path,
+                                          const std::string &type,
+                                          const std::string &backing_path,
+                                          const std::map<std::string, std::string> &tags) {
+  using namespace storage;
+  auto chain_length = chain.block_ids.size();
+  for (std::size_t j = 0; j < chain_length; ++j) {
+    partition_setup setup;
+    setup.block_id = chain.block_ids[j];
+    setup.type = type;
+    setup.backing_path = backing_path;
+    setup.name = chain.name;
+    setup.metadata = chain.metadata;
+    setup.conf = tags;
+    setup.path = path;
+    setup.chain = chain.block_ids;
+    if (chain_length == 1) {
+      setup.role = chain_role::singleton;
+    } else {
+      setup.role = (j == 0) ? chain_role::head : (j == chain_length - 1) ? chain_role::tail : chain_role::mid;
+    }
+    setup.next_block_id = (j == chain_length - 1) ? "nil" : chain.block_ids[j + 1];
+    setups.push_back(std::move(setup));
+  }
+}
+
 bool directory_tree::exists(const std::string &path) const {
   return get_node_unsafe(path) != nullptr;
 }
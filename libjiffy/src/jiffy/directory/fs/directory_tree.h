@@ -393,6 +393,55 @@ class directory_tree : public directory_interface {
 
   void clear_storage(std::vector<std::string> &cleared_blocks, std::shared_ptr<ds_node> node);
 
+  /**
+   * @brief Allocate the replica chains of a new file and set up their partitions
+   * A hash table with a capacity hint tag is pre-split into as many slot ranges as the hint needs
+   * @param path File path
+   * @param type Partition type
+   * @param backing_path Backing path
+   * @param num_blocks Number of blocks
+   * @param chain_length Replica chain length
+   * @param partition_names Partition names
+   * @param partition_metadata Partition metadata
+   * @param tags Partition configuration parameters
+   * @return Replica chains
+   */
+
+  std::vector<replica_chain> allocate_partitions(const std::string &path,
+                                                 const std::string &type,
+                                                 const std::string &backing_path,
+                                                 int32_t num_blocks,
+                                                 int32_t chain_length,
+                                                 const std::vector<std::string> &partition_names,
+                                                 const std::vector<std::string> &partition_metadata,
+                                                 const std::map<std::string, std::string> &tags);
+
+  /**
+   * @brief Compute the number of slot range partitions a hash table needs for its capacity hint
+   * @param tags Tags holding the capacity hint
+   * @param block_capacity Block capacity
+   * @return Number of partitions
+   */
+
+  static int32_t hash_table_partitions(const std::map<std::string, std::string> &tags, std::size_t block_capacity);
+
+  /**
+   * @brief Add partition and chain setup for every block in a replica chain
+   * @param setups Partition setups
+   * @param chain Replica chain
+   * @param path File path
+   * @param type Partition type
+   * @param backing_path Backing path
+   * @param tags Partition configuration parameters
+   */
+
+  static void add_partition_setups(std::vector<storage::partition_setup> &setups,
+                                   const replica_chain &chain,
+                                   const std::string &path,
+                                   const std::string &type,
+                                   const std::string &backing_path,
+                                   const std::map<std::string, std::string> &tags);
+
   /**
    * @brief Touch file or directory node
    * If file node, modify last write time directly
@@ -101,6 +101,22 @@ class persistent_service {
 
   virtual void virtual_write(const storage::hash_table_type &table, const std::string &out_path) = 0;
 
+  /**
+   * @brief Virtual write for hash table delta
+   * @param delta Hash table delta
+   * @param out_path Persistent store path
+   */
+
+  virtual void virtual_write(const storage::hash_table_delta_type &delta, const std::string &out_path) = 0;
+
+  /**
+   * @brief Virtual write for hash table snapshot, read back as a hash table
+   * @param table Hash table snapshot
+   * @param out_path Persistent store path
+   */
+
+  virtual void virtual_write(const storage::hash_table_snapshot_type &table, const std::string &out_path) = 0;
+
   /**
    * @brief Virtual read for fifo queue
    * @param in_path Persistent store path
@@ -132,6 +148,14 @@ class persistent_service {
    */
 
   virtual void virtual_read(const std::string &in_path, storage::hash_table_type &table) = 0;
+
+  /**
+   * @brief Virtual read for hash table delta
+   * @param in_path Persistent store path
+   * @param delta Hash table delta
+   */
+
+  virtual void virtual_read(const std::string &in_path, storage::hash_table_delta_type &delta) = 0;
 };
 
 /**
@@ -190,6 +214,26 @@ class derived_persistent : public persistent_service_impl {
     return persistent_service_impl::write_impl(table, out_path);
   }
 
+  /**
+   * @brief Virtual write for hash table delta
+   * @param delta Hash table delta
+   * @param out_path Persistent store path
+   */
+
+  void virtual_write(const storage::hash_table_delta_type &delta, const std::string &out_path) final {
+    return persistent_service_impl::write_impl(delta, out_path);
+  }
+
+  /**
+   * @brief Virtual write for hash table snapshot
+   * @param table Hash table snapshot
+   * @param out_path Persistent store path
+   */
+
+  void virtual_write(const storage::hash_table_snapshot_type &table, const std::string &out_path) final {
+    return persistent_service_impl::write_impl(table, out_path);
+  }
+
   /**
    * @brief Virtual read for fifo queue
    * @param in_path Persistent store path
@@ -230,8 +274,19 @@ class derived_persistent : public persistent_service_impl {
     return persistent_service_impl::read_impl(in_path, table);
   }
 
+  /**
+   * @brief Virtual read for hash table delta
+   * @param in_path Persistent store path
+   * @param delta Hash table delta
+   */
+
+  void virtual_read(const std::string &in_path, storage::hash_table_delta_type &delta) final {
+    return persistent_service_impl::read_impl(in_path, delta);
+  }
+
 };
 
+#include <cstdio>
 #include <fstream>
 
 /* Local store, inherited persistent_service */
@@ -254,9 +309,17 @@ class local_store_impl : public persistent_service {
     size_t found = out_path.find_last_of("/\\");
     auto dir = out_path.substr(0, found);
     directory_utils::create_directory(dir);
-    std::shared_ptr<std::ofstream> out(new std::ofstream(out_path));
-    serde()->serialize<Datatype>(table, out_path);
-    out->close();
+    // Written aside and renamed over the previous file, so that a failed write leaves it whole
+    auto tmp_path = out_path + ".tmp";
+    serde()->serialize<Datatype>(table, tmp_path);
+    // The binary format keeps keys and value sizes in a file of its own
+    auto tmp_offset_path = tmp_path + "_offset";
+    if (std::ifstream(tmp_offset_path) && std::rename(tmp_offset_path.c_str(), (out_path + "_offset").c_str()) != 0) {
+      throw std::runtime_error("Error in writing data to " + out_path);
+    }
+    if (std::rename(tmp_path.c_str(), out_path.c_str()) != 0) {
+      throw std::runtime_error("Error in writing data to " + out_path);
+    }
   }
 
   /**
@@ -13,9 +13,10 @@ block::block(const std::string &id,
              const std::string memory_mode,
              void* mem_kind,
              const std::string &auto_scaling_host,
-             const int auto_scaling_port)
+             const int auto_scaling_port,
+             const std::string &allocator)
     : id_(id),
-      manager_(capacity, memory_mode, mem_kind),
+      manager_(capacity, memory_mode, mem_kind, allocator),
       impl_(partition_manager::build_partition(&manager_,
                                                "default",
                                                "local://tmp",
@@ -18,13 +18,15 @@ class block {
    * @param capacity The block memory capacity.
    * @param directory_host The directory host.
    * @param directory_port The directory port.
+   * @param allocator The block memory allocator type, "system" or "slab".
    */
   explicit block(const std::string &id,
         const size_t capacity = 134217728,
         const std::string memory_mode = "DRAM",
         void* mem_kind = nullptr,
         const std::string &auto_scaling_host = "127.0.0.1",
-        const int auto_scaling_port = 9095);
+        const int auto_scaling_port = 9095,
+        const std::string &allocator = "system");
 
   /**
    * @brief Get memory block identifier.
@@ -96,7 +96,7 @@ class block_memory_allocator {
   void deallocate(pointer p, size_type size) {
     if (p == nullptr)
       return;
-    manager_->mb_free(p, size);
+    manager_->mb_free(p, size * sizeof(T));
   }
 
   template<typename U>
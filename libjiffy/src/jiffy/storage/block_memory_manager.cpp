@@ -4,6 +4,7 @@
   #include <jemalloc/jemalloc.h>
 #endif
 #include <new>
+#include <stdexcept>
 #include "block_memory_manager.h"
 #include "jiffy/utils/logger.h"
 using namespace jiffy::utils;
@@ -11,10 +12,22 @@ using namespace jiffy::utils;
 namespace jiffy {
 namespace storage {
 
-block_memory_manager::block_memory_manager(size_t capacity, const std::string memory_mode, void* mem_kind)
-    : capacity_(capacity), used_(0), memory_mode_(memory_mode), mem_kind_(mem_kind) {}
+block_memory_manager::block_memory_manager(size_t capacity,
+                                           const std::string memory_mode,
+                                           void* mem_kind,
+                                           const std::string &allocator)
+    : capacity_(capacity), used_(0), memory_mode_(memory_mode), mem_kind_(mem_kind) {
+  if (allocator == "slab") {
+    slab_ = std::unique_ptr<slab_allocator>(new slab_allocator(memory_mode_, mem_kind_));
+  } else if (allocator != "system") {
+    throw std::invalid_argument("Unknown block allocator: " + allocator);
+  }
+}
 
 void *block_memory_manager::mb_malloc(size_t size) {
+  if (slab_ != nullptr) {
+    return slab_->used() > capacity_ ? nullptr : slab_->allocate(size);
+  }
   if (used_.load() > capacity_) {
     return nullptr;
   }
@@ -31,6 +44,10 @@ void *block_memory_manager::mb_malloc(size_t size) {
 }
 
 void block_memory_manager::mb_free(void *ptr) {
+  if (slab_ != nullptr) {
+    slab_->deallocate(ptr);
+    return;
+  }
   #ifdef MEMKIND_IN_USE
     auto size = memkind_malloc_usable_size((struct memkind*)mem_kind_, ptr);
     memkind_free((struct memkind*)mem_kind_, ptr);
@@ -42,6 +59,10 @@ void block_memory_manager::mb_free(void *ptr) {
 }
 
 void block_memory_manager::mb_free(void *ptr, size_t size) {
+  if (slab_ != nullptr) {
+    slab_->deallocate(ptr, size);
+    return;
+  }
   #ifdef MEMKIND_IN_USE
     memkind_free((struct memkind*)mem_kind_, ptr);
   #else
@@ -55,7 +76,7 @@ size_t block_memory_manager::mb_capacity() const {
 }
 
 size_t block_memory_manager::mb_used() const {
-  return used_.load();
+  return slab_ != nullptr ? slab_->used() : used_.load();
 }
 
 }
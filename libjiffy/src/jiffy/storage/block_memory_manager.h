@@ -4,8 +4,10 @@
 #include <cstdint>
 #include <cstddef>
 #include <atomic>
+#include <memory>
 #include <new>
 #include <string>
+#include "slab_allocator.h"
 
 namespace jiffy {
 namespace storage {
@@ -22,10 +24,14 @@ class block_memory_manager {
   /**
    * @brief Constructor.
    * @param capacity Maximum capacity of block.
+   * @param memory_mode Memory mode.
+   * @param mem_kind Memory kind.
+   * @param allocator Allocator type, "system" or "slab".
    */
   explicit block_memory_manager(size_t capacity = 134217728,
                                 const std::string memory_mode = "DRAM",
-                                void* mem_kind = nullptr);
+                                void* mem_kind = nullptr,
+                                const std::string &allocator = "system");
 
   /**
    * @brief Allocate memory.
@@ -43,7 +49,7 @@ class block_memory_manager {
   /**
    * @brief Free memory.
    * @param ptr Pointer to memory allocation.
-   * @param size Number of bytes to free.
+   * @param size Number of bytes requested when allocating.
    */
   void mb_free(void *ptr, size_t size);
 
@@ -82,6 +88,7 @@ class block_memory_manager {
   std::atomic<size_t> used_;
   std::string memory_mode_;
   void* mem_kind_;
+  std::unique_ptr<slab_allocator> slab_;
 };
 
 }
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "chain_module.h"
 #include "jiffy/utils/logger.h"
 #include "jiffy/utils/time_utils.h"
@@ -14,10 +15,10 @@ chain_module::chain_module(block_memory_manager *manager,
                            const command_map &supported_cmds)
     : partition(manager, backing_path, name, metadata, supported_cmds),
       next_(std::make_unique<next_chain_module_cxn>("nil")),
-      prev_(std::make_unique<prev_chain_module_cxn>()),
-      pending_(0) {}
+      prev_(std::make_unique<prev_chain_module_cxn>()) {}
 
 chain_module::~chain_module() {
+  stop_replication();
   next_->reset("nil");
   if (response_processor_.joinable())
     response_processor_.join();
@@ -30,6 +31,8 @@ void chain_module::setup(const std::string &path,
   path_ = path;
   chain_ = chain;
   role_ = role;
+  // Writes that were queued for the old next module are still pending, and are re-sent from there
+  stop_replication();
   auto protocol = next_->reset(next_block_id);
   if (protocol && role_ != chain_role::tail) {
     auto handler = std::make_shared<chain_response_handler>(this);
@@ -47,24 +50,39 @@ void chain_module::setup(const std::string &path,
         }
       }
     });
+    if (role_ == chain_role::head) {
+      replicator_ = std::thread(&chain_module::replicate, this);
+    }
   }
 }
 
 void chain_module::resend_pending() {
-  auto ops = pending_.lock_table();
-  try {
-    for (const auto &op: ops) {
-      next_->request(op.second.seq, op.second.args);
+  // The send lock keeps new requests from going out ahead of the re-sent ones; the batches are
+  // copied so that acknowledgements, which remove pending requests, are not held up by the sends
+  std::unique_lock<std::mutex> send_lock(send_mtx_);
+  std::vector<chain_op> batches;
+  {
+    std::unique_lock<std::mutex> lock(pending_mtx_);
+    for (auto it = pending_.begin(); it != pending_.end();) {
+      auto end = it + std::min<std::ptrdiff_t>(MAX_CHAIN_BATCH, pending_.end() - it);
+      batches.push_back(chain_op{(end - 1)->seq, encode_batch(it, end)});
+      it = end;
     }
-  } catch (...) {
-    ops.unlock();
-    std::rethrow_exception(std::current_exception());
+    next_to_send_ = chain_seq_no_ + 1;
+  }
+  for (const auto &batch: batches) {
+    next_->request(batch.seq, batch.args);
   }
-  ops.unlock();
 }
 
 void chain_module::ack(const sequence_id &seq) {
-  remove_pending(seq);
+  auto acked = acked_seq_no_.load();
+  while (seq.server_seq_no > acked && !acked_seq_no_.compare_exchange_weak(acked, seq.server_seq_no)) {
+  }
+  if (is_head() && seq.server_seq_no > acked) {
+    remove_pending(seq);
+    pending_cv_.notify_all();
+  }
   if (!is_head()) {
     if (prev_ == nullptr) {
       LOG(log_level::error) << "Invalid state: Previous is null";
@@ -79,47 +97,183 @@ void chain_module::request(sequence_id seq, const arg_list &args) {
     return;
   }
 
+  auto cmd_id = command_id(args.front());
   std::vector<std::string> result;
+  if (is_tail()) {
+    run_command(result, args);
+    if (!defer_response(seq, args, result))
+      clients().respond_client(seq, result);
+    notify(args); // TODO: Fix
+    return;
+  }
+  if (is_accessor(cmd_id)) {
+    LOG(log_level::error) << "Invalid state: Accessor request on non-tail node";
+    return;
+  }
+  writes_in_progress_++;
+  write_version_++;
   run_command(result, args);
+  forward(seq, args);
+  writes_in_progress_--;
+}
 
-  auto cmd_name = args.front();
-  if (is_tail()) {
-    clients().respond_client(seq, result);
-    subscriptions().notify(cmd_name, args[1]); // TODO: Fix
+void chain_module::forward(sequence_id &seq, const arg_list &args) {
+  // Without a replicator the request is sent here; the send lock is taken first so that requests go
+  // out in sequence number order, and the pending lock is released before sending so acks can proceed
+  std::unique_lock<std::mutex> send_lock(send_mtx_, std::defer_lock);
+  if (!replicator_.joinable()) {
+    send_lock.lock();
+  }
+  std::unique_lock<std::mutex> lock(pending_mtx_);
+  seq.server_seq_no = ++chain_seq_no_;
+  applied_seq_no_ = seq.server_seq_no;
+  // Only requests forwarded down the chain can be re-sent, so the tail
+  // does not need to keep its own copy of the arguments
+  pending_.push_back(chain_op{seq, args});
+  if (!send_lock.owns_lock()) {
+    lock.unlock();
+    pending_cv_.notify_one();
   } else {
-    if (is_accessor(cmd_name)) {
-      LOG(log_level::error) << "Invalid state: Accessor request on non-tail node";
+    next_to_send_ = seq.server_seq_no + 1;
+    lock.unlock();
+    next_->request(seq, args);
+  }
+}
+
+void chain_module::replicate() {
+  std::unique_lock<std::mutex> lock(pending_mtx_);
+  auto has_room = [this] {
+    return !pending_.empty() && next_to_send_ <= pending_.back().seq.server_seq_no
+        && next_to_send_ - acked_seq_no_.load() <= static_cast<int64_t>(MAX_CHAIN_IN_FLIGHT);
+  };
+  while (true) {
+    pending_cv_.wait(lock, [this, &has_room] { return stop_replication_ || has_room(); });
+    if (stop_replication_) {
+      break;
+    }
+    // Everything queued while the previous batch was being sent goes out together
+    next_to_send_ = std::max(next_to_send_, pending_.front().seq.server_seq_no);
+    auto begin = pending_.begin() + (next_to_send_ - pending_.front().seq.server_seq_no);
+    auto room = static_cast<int64_t>(MAX_CHAIN_IN_FLIGHT) - (next_to_send_ - acked_seq_no_.load()) + 1;
+    auto end = begin + std::min({static_cast<std::ptrdiff_t>(MAX_CHAIN_BATCH),
+                                 static_cast<std::ptrdiff_t>(room),
+                                 pending_.end() - begin});
+    auto seq = (end - 1)->seq;
+    auto args = encode_batch(begin, end);
+    next_to_send_ = seq.server_seq_no + 1;
+    lock.unlock();
+    try {
+      std::unique_lock<std::mutex> send_lock(send_mtx_);
+      next_->request(seq, args);
+    } catch (std::exception &e) {
+      // The requests stay pending until the chain is repaired and they are re-sent
+      LOG(log_level::warn) << "Could not forward requests up to " << seq.server_seq_no << " down the chain: "
+                           << e.what();
+    }
+    lock.lock();
+  }
+}
+
+void chain_module::stop_replication() {
+  {
+    std::unique_lock<std::mutex> lock(pending_mtx_);
+    stop_replication_ = true;
+  }
+  pending_cv_.notify_all();
+  if (replicator_.joinable())
+    replicator_.join();
+  std::unique_lock<std::mutex> lock(pending_mtx_);
+  stop_replication_ = false;
+  next_to_send_ = chain_seq_no_ + 1;
+}
+
+void chain_module::run_command_direct(response &result, const arg_list &args) {
+  if (is_tail() || !is_accessor(command_id(args.front()))) {
+    run_command(result, args);
+    return;
+  }
+  // The version is read first, so that a write either shows up as in progress or unacknowledged,
+  // or bumps the version before the read completes
+  auto version = write_version_.load();
+  if (writes_in_progress_.load() == 0 && acked_seq_no_.load() >= applied_seq_no_.load()) {
+    run_command(result, args);
+    if (write_version_.load() == version) {
       return;
     }
-    seq.server_seq_no = ++chain_seq_no_;
-    next_->request(seq, args);
+    result.clear();
   }
-  add_pending(seq, args);
+  result.emplace_back("!dirty");
 }
 
 void chain_module::chain_request(const sequence_id &seq, const arg_list &args) {
-  auto cmd_name = args.front();
   if (is_head()) {
-    LOG(log_level::error) << "Invalid state: Chain request " << cmd_name << " on head node";
-    return;
-  }
-  if (is_accessor(cmd_name)) {
-    LOG(log_level::error) << "Invalid state: Accessor " << cmd_name << " as chain request";
+    LOG(log_level::error) << "Invalid state: Chain request " << args.front() << " on head node";
     return;
   }
 
-  std::vector<std::string> result;
-  run_command(result, args);
+  auto ops = is_batch(args) ? decode_batch(args) : std::vector<chain_op>{chain_op{seq, args}};
+  for (const auto &op: ops) {
+    auto cmd_id = command_id(op.args.front());
+    if (is_accessor(cmd_id)) {
+      LOG(log_level::error) << "Invalid state: Accessor " << command_name(cmd_id) << " as chain request";
+      continue;
+    }
+    std::vector<std::string> result;
+    if (is_tail()) {
+      run_command(result, op.args);
+      if (!defer_response(op.seq, op.args, result))
+        clients().respond_client(op.seq, result);
+      notify(op.args); // TODO: Fix
+    } else {
+      writes_in_progress_++;
+      write_version_++;
+      run_command(result, op.args);
+      applied_seq_no_ = op.seq.server_seq_no;
+      // Keeps the numbering going should this module take over as head
+      chain_seq_no_ = op.seq.server_seq_no;
+      writes_in_progress_--;
+    }
+  }
 
   if (is_tail()) {
-    clients().respond_client(seq, result);
-    subscriptions().notify(cmd_name, args[1]); // TODO: Fix
-    ack(seq);
+    // A single acknowledgement covers every request in the batch
+    ack(ops.back().seq);
   } else {
     // Do not need a lock since this is the only thread handling chain requests
     next_->request(seq, args);
   }
 }
 
+bool chain_module::is_batch(const arg_list &args) {
+  return !args.empty() && args.front() == "!batch";
+}
+
+arg_list chain_module::encode_batch(const std::vector<chain_op> &ops) {
+  return encode_batch(ops.begin(), ops.end());
+}
+
+std::vector<chain_op> chain_module::decode_batch(const arg_list &args) {
+  std::vector<chain_op> ops;
+  std::size_t i = 1;
+  while (i + 4 <= args.size()) {
+    chain_op op;
+    op.seq.client_id = std::stoll(args[i]);
+    op.seq.client_seq_no = std::stoll(args[i + 1]);
+    op.seq.server_seq_no = std::stoll(args[i + 2]);
+    auto num_args = std::stoul(args[i + 3]);
+    i += 4;
+    if (i + num_args > args.size()) {
+      throw std::invalid_argument("Malformed chain request batch");
+    }
+    op.args.assign(args.begin() + i, args.begin() + i + num_args);
+    i += num_args;
+    ops.push_back(std::move(op));
+  }
+  if (ops.empty() || i != args.size()) {
+    throw std::invalid_argument("Malformed chain request batch");
+  }
+  return ops;
+}
+
+}
 }
-}
\ No newline at end of file
@@ -2,7 +2,10 @@
 #define JIFFY_CHAIN_MODULE_H
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <utility>
@@ -46,6 +49,12 @@ struct chain_op {
   std::vector<std::string> args;
 };
 
+/* Maximum number of requests coalesced into one chain request */
+constexpr std::size_t MAX_CHAIN_BATCH = 64;
+
+/* Maximum number of requests forwarded down the chain and not yet acknowledged */
+constexpr std::size_t MAX_CHAIN_IN_FLIGHT = 1024;
+
 /* Connection to next chain module */
 class next_chain_module_cxn {
  public:
@@ -277,6 +286,16 @@ class chain_module : public partition {
     return role() == chain_role::tail || role() == chain_role::singleton;
   }
 
+  /**
+   * @brief Run a command sent directly to this chain module rather than as a chain request
+   * Accessors may be sent to any replica of the chain. A replica other than the tail responds
+   * with !dirty while some write it applied has not been acknowledged by the tail, so that it
+   * never serves state the tail has not committed; the client then reads from the tail instead
+   * @param result Command result
+   * @param args Command arguments
+   */
+  void run_command_direct(response &result, const arg_list &args);
+
   /**
    * @brief Check if previous chain module is set
    * @return Bool value, true if set
@@ -304,20 +323,25 @@ class chain_module : public partition {
 
   /**
    * @brief Add request to pending
+   * Requests must be added in server sequence number order
    * @param seq Request sequence identifier
    * @param args Command arguments
    */
 
   void add_pending(const sequence_id &seq, const arg_list &args) {
-    pending_.insert(seq.server_seq_no, chain_op{seq, args});
+    std::unique_lock<std::mutex> lock(pending_mtx_);
+    pending_.push_back(chain_op{seq, args});
   }
 
   /**
-   * @brief Remove a pending request
+   * @brief Remove pending requests up to and including a sequence identifier
    * @param seq Sequence identifier
    */
   void remove_pending(const sequence_id &seq) {
-    pending_.erase(seq.server_seq_no);
+    std::unique_lock<std::mutex> lock(pending_mtx_);
+    while (!pending_.empty() && pending_.front().seq.server_seq_no <= seq.server_seq_no) {
+      pending_.pop_front();
+    }
   }
 
   /**
@@ -330,6 +354,18 @@ class chain_module : public partition {
    */
   virtual void forward_all() = 0;
 
+  /**
+   * @brief Decide whether the tail should hold back the response to a request
+   * A partition that defers a response becomes responsible for answering the client later
+   * @param seq Sequence identifier
+   * @param args Command arguments
+   * @param result Command result
+   * @return Bool value, true if the response is deferred
+   */
+  virtual bool defer_response(const sequence_id &/*seq*/, const arg_list &/*args*/, const response &/*result*/) {
+    return false;
+  }
+
   /**
    * @brief Request for the first time
    * @param seq Sequence identifier
@@ -346,11 +382,77 @@ class chain_module : public partition {
 
   /**
    * @brief Acknowledge the previous block
+   * Acknowledgements are cumulative, covering every request up to the server sequence number
    * @param seq Sequence identifier
    */
   void ack(const sequence_id &seq);
 
+  /**
+   * @brief Check if chain request arguments carry a batch of requests
+   * @param args Chain request arguments
+   * @return Bool value, true if the arguments are a batch
+   */
+  static bool is_batch(const arg_list &args);
+
+  /**
+   * @brief Pack requests, along with their sequence identifiers, into the arguments of one chain request
+   * @param ops Requests
+   * @return Chain request arguments
+   */
+  static arg_list encode_batch(const std::vector<chain_op> &ops);
+
+  /**
+   * @brief Pack a range of requests into the arguments of one chain request
+   * @tparam iterator Chain operation iterator type
+   * @param begin Beginning of the range
+   * @param end End of the range
+   * @return Chain request arguments
+   */
+  template<typename iterator>
+  static arg_list encode_batch(iterator begin, iterator end) {
+    std::size_t size = 1;
+    for (auto it = begin; it != end; ++it) {
+      size += 4 + it->args.size();
+    }
+    arg_list args;
+    args.reserve(size);
+    args.emplace_back("!batch");
+    for (auto it = begin; it != end; ++it) {
+      args.push_back(std::to_string(it->seq.client_id));
+      args.push_back(std::to_string(it->seq.client_seq_no));
+      args.push_back(std::to_string(it->seq.server_seq_no));
+      args.push_back(std::to_string(it->args.size()));
+      args.insert(args.end(), it->args.begin(), it->args.end());
+    }
+    return args;
+  }
+
+  /**
+   * @brief Unpack the requests of a batch
+   * @param args Chain request arguments
+   * @return Requests
+   */
+  static std::vector<chain_op> decode_batch(const arg_list &args);
+
  protected:
+  /**
+   * @brief Number a request applied at the head, and add it to pending to be forwarded down the chain
+   * @param seq Sequence identifier, its server sequence number is set here
+   * @param args Command arguments
+   */
+  void forward(sequence_id &seq, const arg_list &args);
+
+  /**
+   * @brief Forward queued requests down the chain in batches, keeping a bounded number in flight
+   */
+  void replicate();
+
+  /**
+   * @brief Stop forwarding queued requests and drop the queue
+   */
+  void stop_replication();
+
+
   /* Role of chain module */
   chain_role role_{singleton};
   /* Chain sequence number */
@@ -363,8 +465,28 @@ class chain_module : public partition {
   std::vector<std::string> chain_;
   /* Response processor thread */
   std::thread response_processor_;
-  /* Pending operations */
-  cuckoohash_map<int64_t, chain_op> pending_;
+  /* Pending operations, in server sequence number order; acknowledged ones are removed from the front */
+  std::deque<chain_op> pending_;
+  /* Pending operations mutex */
+  std::mutex pending_mtx_;
+  /* Condition variable for pending operations and acknowledgements */
+  std::condition_variable pending_cv_;
+  /* Server sequence number of the next pending operation to forward down the chain */
+  int64_t next_to_send_{0};
+  /* Bool value, true if forwarding should stop */
+  bool stop_replication_{false};
+  /* Forwarding thread, only runs at the head */
+  std::thread replicator_;
+  /* Mutex for requests to the next chain module; taken before the pending mutex, which is never held while sending */
+  std::mutex send_mtx_;
+  /* Highest server sequence number applied at this chain module */
+  std::atomic<int64_t> applied_seq_no_{0};
+  /* Highest server sequence number acknowledged by the tail */
+  std::atomic<int64_t> acked_seq_no_{0};
+  /* Number of writes being applied at this chain module */
+  std::atomic<int64_t> writes_in_progress_{0};
+  /* Number of writes applied at this chain module, to detect writes that race with a read */
+  std::atomic<uint64_t> write_version_{0};
 };
 
 }
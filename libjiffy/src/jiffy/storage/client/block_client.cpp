@@ -22,10 +22,10 @@ int64_t block_client::get_client_id() {
 
 void block_client::connect(const std::string &host, int port, int block_id, int timeout_ms) {
   block_id_ = block_id;
-  auto sock = std::make_shared<TSocket>(host, port);
+  socket_ = std::make_shared<TSocket>(host, port);
   if (timeout_ms > 0)
-    sock->setRecvTimeout(timeout_ms);
-  transport_ = std::shared_ptr<TTransport>(new TFramedTransport(sock));
+    socket_->setRecvTimeout(timeout_ms);
+  transport_ = std::shared_ptr<TTransport>(new TFramedTransport(socket_));
   protocol_ = std::shared_ptr<TProtocol>(new TBinaryProtocol(transport_));
   client_ = std::make_shared<thrift_client>(protocol_);
   transport_->open();
@@ -48,6 +48,11 @@ bool block_client::is_connected() const {
   return transport_->isOpen();
 }
 
+int block_client::socket_fd() const {
+  if (!is_connected()) return -1;
+  return static_cast<int>(socket_->getSocketFD());
+}
+
 void block_client::command_request(const sequence_id &seq, const std::vector<std::string> &args) {
   client_->command_request(seq, block_id_, args);
 }
@@ -56,6 +61,57 @@ void block_client::send_run_command(const int32_t block_id, const std::vector<st
   client_->send_run_command(block_id, arguments);
 }
 
+void block_client::command_request(const sequence_id &seq,
+                                   const std::string &op,
+                                   const std::vector<std::string> &args) {
+  using namespace ::apache::thrift::protocol;
+  auto oprot = protocol_.get();
+  oprot->writeMessageBegin("command_request", T_ONEWAY, 0);
+  oprot->writeStructBegin("block_request_service_command_request_pargs");
+  oprot->writeFieldBegin("seq", T_STRUCT, 1);
+  seq.write(oprot);
+  oprot->writeFieldEnd();
+  oprot->writeFieldBegin("block_id", T_I32, 2);
+  oprot->writeI32(block_id_);
+  oprot->writeFieldEnd();
+  write_arguments(3, op, args);
+  oprot->writeFieldStop();
+  oprot->writeStructEnd();
+  oprot->writeMessageEnd();
+  oprot->getTransport()->writeEnd();
+  oprot->getTransport()->flush();
+}
+
+void block_client::send_run_command(const int32_t block_id,
+                                    const std::string &op,
+                                    const std::vector<std::string> &arguments) {
+  using namespace ::apache::thrift::protocol;
+  auto oprot = protocol_.get();
+  oprot->writeMessageBegin("run_command", T_CALL, 0);
+  oprot->writeStructBegin("block_request_service_run_command_pargs");
+  oprot->writeFieldBegin("block_id", T_I32, 1);
+  oprot->writeI32(block_id);
+  oprot->writeFieldEnd();
+  write_arguments(2, op, arguments);
+  oprot->writeFieldStop();
+  oprot->writeStructEnd();
+  oprot->writeMessageEnd();
+  oprot->getTransport()->writeEnd();
+  oprot->getTransport()->flush();
+}
+
+void block_client::write_arguments(int16_t field_id, const std::string &op, const std::vector<std::string> &args) {
+  using namespace ::apache::thrift::protocol;
+  auto oprot = protocol_.get();
+  oprot->writeFieldBegin("arguments", T_LIST, field_id);
+  oprot->writeListBegin(T_STRING, static_cast<uint32_t>(args.size()));
+  for (std::size_t i = 0; i < args.size(); ++i) {
+    oprot->writeBinary(i == 0 ? op : args[i]);
+  }
+  oprot->writeListEnd();
+  oprot->writeFieldEnd();
+}
+
 void block_client::recv_run_command(std::vector<std::string> &_return) {
   client_->recv_run_command(_return);
 }
@@ -79,6 +79,13 @@ class block_client {
 
   bool is_connected() const;
 
+  /**
+   * @brief Fetch socket file descriptor of the connection
+   * @return Socket file descriptor, -1 if not connected
+   */
+
+  int socket_fd() const;
+
   /**
    * @brief Register client identifier with block identifier and return command response reader
    * @param client_id Client identifier
@@ -102,6 +109,24 @@ class block_client {
    */
   void send_run_command(const int32_t block_id, const std::vector<std::string> &arguments);
 
+  /**
+   * @brief Request command, sending opcode in place of the command name
+   * The arguments are serialized in place, so no copy of the arguments is made
+   * @param seq Sequence identifier
+   * @param op Command opcode
+   * @param args Command arguments
+   */
+  void command_request(const sequence_id &seq, const std::string &op, const std::vector<std::string> &args);
+
+  /**
+   * @brief Send run command, sending opcode in place of the command name
+   * The arguments are serialized in place, so no copy of the arguments is made
+   * @param block_id Block identifier
+   * @param op Command opcode
+   * @param arguments Command arguments
+   */
+  void send_run_command(const int32_t block_id, const std::string &op, const std::vector<std::string> &arguments);
+
   /**
    * @brief Receive response from run command
    * @param _return Response
@@ -109,6 +134,16 @@ class block_client {
   void recv_run_command(std::vector<std::string> &_return);
 
  private:
+  /**
+   * @brief Write command arguments field, replacing the command name with opcode
+   * @param field_id Thrift field identifier
+   * @param op Command opcode
+   * @param args Command arguments
+   */
+  void write_arguments(int16_t field_id, const std::string &op, const std::vector<std::string> &args);
+
+  /* Socket */
+  std::shared_ptr<apache::thrift::transport::TSocket> socket_{};
   /* Transport */
   std::shared_ptr<apache::thrift::transport::TTransport> transport_{};
   /* Protocol */
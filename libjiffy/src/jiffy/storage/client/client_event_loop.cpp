@@ -0,0 +1,99 @@
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstring>
+#include <vector>
+#include "client_event_loop.h"
+#include "replica_chain_client.h"
+#include "jiffy/utils/logger.h"
+
+namespace jiffy {
+namespace storage {
+
+using namespace utils;
+
+client_event_loop::client_event_loop(int poll_timeout_ms)
+    : poll_timeout_ms_(poll_timeout_ms), stop_(false) {
+  if (pipe(wakeup_fd_) != 0) {
+    throw std::runtime_error(std::string("Could not create event loop pipe: ") + std::strerror(errno));
+  }
+  fcntl(wakeup_fd_[0], F_SETFL, O_NONBLOCK);
+  fcntl(wakeup_fd_[1], F_SETFL, O_NONBLOCK);
+}
+
+client_event_loop::~client_event_loop() {
+  stop();
+  if (worker_.joinable())
+    worker_.join();
+  close(wakeup_fd_[0]);
+  close(wakeup_fd_[1]);
+}
+
+void client_event_loop::start() {
+  worker_ = std::thread([&] {
+    std::vector<pollfd> fds;
+    std::vector<std::weak_ptr<replica_chain_client>> clients;
+    while (!stop_.load()) {
+      fds.clear();
+      clients.clear();
+      fds.push_back(pollfd{wakeup_fd_[0], POLLIN, 0});
+      {
+        std::unique_lock<std::mutex> lock(mtx_);
+        for (const auto &entry: clients_) {
+          fds.push_back(pollfd{entry.first, POLLIN, 0});
+          clients.push_back(entry.second);
+        }
+      }
+      int n = poll(fds.data(), fds.size(), poll_timeout_ms_);
+      if (n < 0) {
+        if (errno != EINTR) {
+          LOG(log_level::error) << "Event loop poll failed: " << std::strerror(errno);
+        }
+        continue;
+      }
+      if (fds[0].revents != 0) {
+        char buf[64];
+        while (read(wakeup_fd_[0], buf, sizeof(buf)) > 0);
+      }
+      // Handlers run without the lock, they may add or remove sockets
+      for (std::size_t i = 1; i < fds.size(); ++i) {
+        if (fds[i].revents == 0)
+          continue;
+        if (auto client = clients[i - 1].lock()) {
+          client->process_async_response(fds[i].fd);
+        }
+      }
+    }
+  });
+}
+
+void client_event_loop::stop() {
+  stop_.store(true);
+  wakeup();
+}
+
+void client_event_loop::add(int fd, const std::weak_ptr<replica_chain_client> &client) {
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    clients_[fd] = client;
+  }
+  wakeup();
+}
+
+void client_event_loop::remove(int fd) {
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    clients_.erase(fd);
+  }
+  wakeup();
+}
+
+void client_event_loop::wakeup() {
+  char c = 0;
+  if (write(wakeup_fd_[1], &c, 1) < 0 && errno != EAGAIN) {
+    LOG(log_level::warn) << "Could not wake up event loop: " << std::strerror(errno);
+  }
+}
+
+}
+}
@@ -0,0 +1,85 @@
+#ifndef JIFFY_CLIENT_EVENT_LOOP_H
+#define JIFFY_CLIENT_EVENT_LOOP_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace jiffy {
+namespace storage {
+
+class replica_chain_client;
+
+/* Client event loop class
+ * A single thread that owns the response sockets of asynchronous requests,
+ * reading responses as they arrive and completing the futures waiting on them,
+ * so that any number of requests can be in flight without a thread per request */
+class client_event_loop {
+ public:
+  /**
+   * @brief Constructor
+   * @param poll_timeout_ms Poll timeout, bounds how long stopping the loop takes
+   */
+
+  explicit client_event_loop(int poll_timeout_ms = 100);
+
+  /**
+   * @brief Destructor
+   */
+
+  ~client_event_loop();
+
+  /**
+   * @brief Start event loop thread
+   */
+
+  void start();
+
+  /**
+   * @brief Stop event loop thread
+   */
+
+  void stop();
+
+  /**
+   * @brief Watch socket for responses of a replica chain client
+   * @param fd Socket file descriptor
+   * @param client Replica chain client reading the responses
+   */
+
+  void add(int fd, const std::weak_ptr<replica_chain_client> &client);
+
+  /**
+   * @brief Stop watching socket
+   * @param fd Socket file descriptor
+   */
+
+  void remove(int fd);
+
+ private:
+  /**
+   * @brief Wake up event loop thread blocked in poll
+   */
+
+  void wakeup();
+
+  /* Watched sockets mutex */
+  std::mutex mtx_;
+  /* Watched sockets and the replica chain clients reading them */
+  std::map<int, std::weak_ptr<replica_chain_client>> clients_;
+  /* Pipe used to wake up the event loop thread */
+  int wakeup_fd_[2];
+  /* Poll timeout */
+  int poll_timeout_ms_;
+  /* Stop bool */
+  std::atomic_bool stop_;
+  /* Worker thread */
+  std::thread worker_;
+};
+
+}
+}
+
+#endif //JIFFY_CLIENT_EVENT_LOOP_H
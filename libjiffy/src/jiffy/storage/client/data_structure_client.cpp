@@ -1,4 +1,5 @@
 #include "data_structure_client.h"
+#include "jiffy/directory/directory_ops.h"
 
 namespace jiffy {
 namespace storage {
@@ -8,11 +9,45 @@ data_structure_client::data_structure_client(std::shared_ptr<directory::director
                                              const directory::data_status &status,
                                              int timeout_ms)
     : fs_(std::move(fs)), path_(path), status_(status), timeout_ms_(timeout_ms) {
+  try {
+    replica_reads_ = (status.get_tag("chain.replica_reads") == "true");
+  } catch (directory::directory_ops_exception &e) {
+    replica_reads_ = false;
+  }
 }
 
 directory::data_status &data_structure_client::status() {
   return status_;
 }
 
+void data_structure_client::event_loop(std::shared_ptr<client_event_loop> event_loop) {
+  event_loop_ = std::move(event_loop);
+}
+
+std::shared_ptr<replica_chain_client> data_structure_client::connect_chain(const directory::replica_chain &chain,
+                                                                         const command_map &ops,
+                                                                         int timeout_ms) {
+  auto block = std::make_shared<replica_chain_client>(fs_, path_, chain, ops, timeout_ms);
+  if (replica_reads_) {
+    block->read_from_replicas(true);
+  }
+  return block;
+}
+
+std::future<std::vector<std::string>> data_structure_client::async_command(const std::shared_ptr<replica_chain_client> &block,
+                                                                           const std::vector<std::string> &args) {
+  attach(block);
+  return block->run_command_async(args);
+}
+
+void data_structure_client::attach(const std::shared_ptr<replica_chain_client> &block) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
+  if (event_loop_ == nullptr) {
+    event_loop_ = std::make_shared<client_event_loop>();
+    event_loop_->start();
+  }
+  block->attach(event_loop_);
+}
+
 }
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #ifndef JIFFY_DATA_STRUCTURE_CLIENT_H
 #define JIFFY_DATA_STRUCTURE_CLIENT_H
 
+#include <atomic>
+#include <future>
+#include <mutex>
 #include "jiffy/directory/client/directory_client.h"
 #include "jiffy/storage/client/replica_chain_client.h"
 #include "jiffy/utils/client_cache.h"
@@ -17,6 +20,36 @@ class redo_error : public std::exception {
   redo_error() = default;
 };
 
+namespace detail {
+
+/* Completes a promise with the result of a continuation, or with the exception it throws */
+template<typename T>
+struct promise_completion {
+  template<typename F, typename Arg>
+  static void complete(std::promise<T> &promise, F &f, Arg &arg) {
+    try {
+      promise.set_value(f(arg));
+    } catch (...) {
+      promise.set_exception(std::current_exception());
+    }
+  }
+};
+
+template<>
+struct promise_completion<void> {
+  template<typename F, typename Arg>
+  static void complete(std::promise<void> &promise, F &f, Arg &arg) {
+    try {
+      f(arg);
+      promise.set_value();
+    } catch (...) {
+      promise.set_exception(std::current_exception());
+    }
+  }
+};
+
+}
+
 /* Data structure client */
 class data_structure_client {
  public:
@@ -46,8 +79,119 @@ class data_structure_client {
 
   directory::data_status &status();
 
+  /**
+   * @brief Complete asynchronous requests on an event loop
+   * Without an event loop, the client starts one of its own on the first asynchronous request
+   * @param event_loop Event loop
+   */
+
+  void event_loop(std::shared_ptr<client_event_loop> event_loop);
+
  protected:
 
+  /**
+   * @brief Run command on a replica chain without waiting for its response
+   * @param block Replica chain client
+   * @param args Command arguments
+   * @return Future for the response of the command
+   */
+
+  std::future<std::vector<std::string>> async_command(const std::shared_ptr<replica_chain_client> &block,
+                                                      const std::vector<std::string> &args);
+
+  /**
+   * @brief Run command on a replica chain without waiting for its response
+   * The continuation runs on the event loop thread once the response arrives, so the
+   * future becomes ready on its own; continuations that touch the client's state take
+   * the client mutex, and must not wait on asynchronous requests
+   * @param block Replica chain client
+   * @param args Command arguments
+   * @param continuation Continuation taking the response and returning the result
+   * @return Future for the result of the continuation
+   */
+
+  template<typename T, typename F>
+  std::future<T> async_command(const std::shared_ptr<replica_chain_client> &block,
+                               const std::vector<std::string> &args,
+                               F continuation) {
+    auto promise = std::make_shared<std::promise<T>>();
+    auto future = promise->get_future();
+    attach(block);
+    block->run_command_async(args, [promise, continuation](std::vector<std::string> _return) mutable {
+      detail::promise_completion<T>::complete(*promise, continuation, _return);
+    });
+    return future;
+  }
+
+  /**
+   * @brief Run commands on replica chains without waiting for their responses
+   * The continuation runs on the event loop thread once all responses arrive
+   * @param requests Replica chain client and command arguments of each command
+   * @param continuation Continuation taking the responses, in the order of the commands,
+   * and returning the result
+   * @return Future for the result of the continuation
+   */
+
+  template<typename T, typename F>
+  std::future<T> async_commands(const std::vector<std::pair<std::shared_ptr<replica_chain_client>,
+                                                            std::vector<std::string>>> &requests,
+                                F continuation) {
+    typedef std::vector<std::vector<std::string>> response_list;
+    auto promise = std::make_shared<std::promise<T>>();
+    auto future = promise->get_future();
+    auto f = std::make_shared<F>(std::move(continuation));
+    auto responses = std::make_shared<response_list>(requests.size());
+    auto remaining = std::make_shared<std::atomic<std::size_t>>(requests.size());
+    if (requests.empty()) {
+      detail::promise_completion<T>::complete(*promise, *f, *responses);
+      return future;
+    }
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+      attach(requests[i].first);
+      requests[i].first->run_command_async(requests[i].second,
+                                           [promise, f, responses, remaining, i](std::vector<std::string> _return) {
+        (*responses)[i] = std::move(_return);
+        if (remaining->fetch_sub(1) == 1) {
+          detail::promise_completion<T>::complete(*promise, *f, *responses);
+        }
+      });
+    }
+    return future;
+  }
+
+  /**
+   * @brief Make a future that is ready with a value
+   * @param value Value
+   * @return Future for the value
+   */
+
+  template<typename T>
+  static std::future<T> ready_future(T value) {
+    std::promise<T> promise;
+    promise.set_value(std::move(value));
+    return promise.get_future();
+  }
+
+  /**
+   * @brief Attach a replica chain client to the event loop, starting one if there is none
+   * @param block Replica chain client
+   */
+
+  void attach(const std::shared_ptr<replica_chain_client> &block);
+
+  /**
+   * @brief Connect to a replica chain of the data structure
+   * Accessors are spread over all replicas of the chain if the data structure was created
+   * with the "chain.replica_reads" tag set to "true"
+   * @param chain Replica chain
+   * @param ops Operations for the data structure
+   * @param timeout_ms Timeout
+   * @return Replica chain client
+   */
+  std::shared_ptr<replica_chain_client> connect_chain(const directory::replica_chain &chain,
+                                                      const command_map &ops,
+                                                      int timeout_ms = 1000);
+
   /**
    * @brief Handle command in redirect case
    * @param args Command arguments
@@ -65,6 +209,12 @@ class data_structure_client {
 
   /* Time out*/
   int timeout_ms_;
+  /* Bool value, true if accessors are spread over all replicas of each chain */
+  bool replica_reads_;
+  /* Event loop completing asynchronous requests, started on the first one if not set */
+  std::shared_ptr<client_event_loop> event_loop_;
+  /* Serializes the client's state between callers and continuations of asynchronous requests */
+  std::recursive_mutex mtx_;
 };
 
 }
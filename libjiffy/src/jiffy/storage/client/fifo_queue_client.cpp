@@ -1,6 +1,7 @@
 #include "fifo_queue_client.h"
 #include "jiffy/utils/string_utils.h"
 #include "jiffy/utils/logger.h"
+#include "jiffy/utils/time_utils.h"
 #include <algorithm>
 #include <thread>
 #include <utility>
@@ -31,6 +32,7 @@ fifo_queue_client::fifo_queue_client(std::shared_ptr<directory::directory_interf
 }
 
 void fifo_queue_client::refresh() {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   bool redo;
   do {
     status_ = fs_->dstatus(path_);
@@ -72,6 +74,105 @@ std::string fifo_queue_client::read_next() {
   return _return[1];
 }
 
+void fifo_queue_client::enqueue_batch(const std::vector<std::string> &items) {
+  std::size_t size = 0;
+  for (const auto &item: items) {
+    size += string_array::METADATA_LEN + item.size();
+  }
+  std::vector<std::string> args{"enqueue_batch", std::string()};
+  args[1].reserve(size);
+  for (const auto &item: items) {
+    string_array::frame(args[1], item);
+  }
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
+  bool redirected = false;
+  while (true) {
+    auto _return = redirected ? blocks_[block_id(args)]->run_command_redirected(args)
+                              : blocks_[block_id(args)]->run_command(args);
+    if (_return[0] == "!ok") {
+      return;
+    }
+    if (_return[0] == "!redo") {
+      // Drop the items the partition took before it filled up
+      if (_return.size() > 1) {
+        args[1].erase(0, std::stoul(_return[1]));
+      }
+      continue;
+    }
+    if (_return[0] == "!block_moved") {
+      refresh();
+      args.resize(2);
+      redirected = false;
+      continue;
+    }
+    if (_return[0] != "!redirected_enqueue") {
+      THROW_IF_NOT_OK(_return);
+    }
+    // Carry the items that did not fit, along with the enqueue statistics, over to the next partition
+    args[1].erase(0, std::stoul(_return.back()));
+    add_blocks(_return, args);
+    handle_partition_id(args);
+    args.resize(2);
+    args.insert(args.end(), _return.end() - 4, _return.end() - 1);
+    redirected = true;
+  }
+}
+
+std::vector<std::string> fifo_queue_client::dequeue_batch(std::size_t max_items) {
+  std::vector<std::string> _return;
+  std::vector<std::string> args{"dequeue_batch", std::to_string(max_items)};
+  run_redirected(_return, args);
+  if (_return[0] == "!msg_not_found") {
+    return {};
+  }
+  THROW_IF_NOT_OK(_return);
+  return string_array::unframe(_return[1]);
+}
+
+std::string fifo_queue_client::dequeue_wait(int timeout_ms) {
+  auto deadline = time_utils::now_ms() + timeout_ms;
+  std::vector<std::string> _return;
+  std::vector<std::string> args{"dequeue"};
+  while (true) {
+    run_redirected(_return, args);
+    if (_return[0] != "!msg_not_found" || time_utils::now_ms() >= deadline) {
+      break;
+    }
+    // The wait only signals that an item is there; other consumers may still get to it first
+    wait_for_item("dequeue_wait", deadline);
+  }
+  THROW_IF_NOT_OK(_return);
+  return _return[1];
+}
+
+std::string fifo_queue_client::read_next_wait(int timeout_ms) {
+  auto deadline = time_utils::now_ms() + timeout_ms;
+  std::vector<std::string> _return;
+  do {
+    _return = wait_for_item("read_next_wait", deadline);
+    if (_return[0] != "!ok" && _return[0] != "!msg_not_found") {
+      // Let read next follow the queue into the next partition
+      return read_next();
+    }
+  } while (_return[0] == "!msg_not_found" && time_utils::now_ms() < deadline);
+  THROW_IF_NOT_OK(_return);
+  return _return[1];
+}
+
+std::future<void> fifo_queue_client::enqueue_async(const std::string &item) {
+  return run_async<void>({"enqueue", item}, [](std::vector<std::string> &) {});
+}
+
+std::future<void> fifo_queue_client::dequeue_async() {
+  return run_async<void>({"dequeue"}, [](std::vector<std::string> &) {});
+}
+
+std::future<std::string> fifo_queue_client::read_next_async() {
+  return run_async<std::string>({"read_next"}, [](std::vector<std::string> &_return) {
+    return std::move(_return[1]);
+  });
+}
+
 std::size_t fifo_queue_client::length() {
   std::vector<std::string> _head, _tail;
   std::vector<std::string> tail_args{"length", std::to_string(fifo_queue_size_type::tail_size)};
@@ -116,7 +217,7 @@ void fifo_queue_client::handle_redirect(std::vector<std::string> &_return, const
         auto args_copy = args;
         if (args[0] == "enqueue")
           args_copy.insert(args_copy.end(), _return.end() - 3, _return.end());
-        else if (args[0] == "dequeue")
+        else if (args[0] == "dequeue" || args[0] == "dequeue_batch")
           args_copy.insert(args_copy.end(), _return.end() - 2, _return.end());
         _return = blocks_[block_id(args_copy)]->run_command_redirected(args_copy);
       } while (_return[0] == "!redo");
@@ -130,9 +231,13 @@ void fifo_queue_client::handle_redirect(std::vector<std::string> &_return, const
 
 std::size_t fifo_queue_client::block_id(const std::vector<std::string> &args) {
   switch (FQ_CMDS[args[0]].id) {
-    case fifo_queue_cmd_id::fq_enqueue:return enqueue_partition_;
-    case fifo_queue_cmd_id::fq_dequeue:return dequeue_partition_;
-    case fifo_queue_cmd_id::fq_readnext:return read_partition_ - start_;
+    case fifo_queue_cmd_id::fq_enqueue:
+    case fifo_queue_cmd_id::fq_enqueue_batch:return enqueue_partition_;
+    case fifo_queue_cmd_id::fq_dequeue:
+    case fifo_queue_cmd_id::fq_dequeue_batch:
+    case fifo_queue_cmd_id::fq_dequeue_wait:return dequeue_partition_;
+    case fifo_queue_cmd_id::fq_readnext:
+    case fifo_queue_cmd_id::fq_readnext_wait:return read_partition_ - start_;
     case fifo_queue_cmd_id::fq_length:
       if (std::stoi(args[1]) == fifo_queue_size_type::head_size)
         return enqueue_partition_;
@@ -149,11 +254,11 @@ std::size_t fifo_queue_client::block_id(const std::vector<std::string> &args) {
 
 void fifo_queue_client::handle_partition_id(const std::vector<std::string> &args) {
   auto cmd = FQ_CMDS[args[0]].id;
-  if (cmd == fifo_queue_cmd_id::fq_enqueue
+  if (cmd == fifo_queue_cmd_id::fq_enqueue || cmd == fifo_queue_cmd_id::fq_enqueue_batch
       || (cmd == fifo_queue_cmd_id::fq_length && std::stoi(args[1]) == fifo_queue_size_type::head_size)
       || (cmd == fifo_queue_cmd_id::fq_in_rate)) {
     enqueue_partition_++;
-  } else if (cmd == fifo_queue_cmd_id::fq_dequeue
+  } else if (cmd == fifo_queue_cmd_id::fq_dequeue || cmd == fifo_queue_cmd_id::fq_dequeue_batch
       || (cmd == fifo_queue_cmd_id::fq_length && std::stoi(args[1]) == fifo_queue_size_type::tail_size)
       || (cmd == fifo_queue_cmd_id::fq_out_rate) || cmd == fifo_queue_cmd_id::fq_front) {
     dequeue_partition_++;
@@ -174,6 +279,12 @@ void fifo_queue_client::handle_partition_id(const std::vector<std::string> &args
 }
 
 void fifo_queue_client::run_repeated(std::vector<std::string> &_return, const std::vector<std::string> &args) {
+  run_redirected(_return, args);
+  THROW_IF_NOT_OK(_return);
+}
+
+void fifo_queue_client::run_redirected(std::vector<std::string> &_return, const std::vector<std::string> &args) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   bool redo;
   do {
     try {
@@ -184,7 +295,45 @@ void fifo_queue_client::run_repeated(std::vector<std::string> &_return, const st
       redo = true;
     }
   } while (redo);
-  THROW_IF_NOT_OK(_return);
+}
+
+std::vector<std::string> fifo_queue_client::wait_for_item(const std::string &op, std::uint64_t deadline) {
+  auto now = time_utils::now_ms();
+  auto wait_ms = deadline > now ? deadline - now : 0;
+  if (timeout_ms_ > 0) {
+    wait_ms = std::min<std::uint64_t>(wait_ms, std::max(timeout_ms_ / 2, 1));
+  }
+  std::vector<std::string> args{op, std::to_string(wait_ms)};
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
+  return blocks_[block_id(args)]->run_command(args);
+}
+
+template<typename T, typename F>
+std::future<T> fifo_queue_client::run_async(const std::vector<std::string> &args, F result) {
+  std::size_t id;
+  std::shared_ptr<replica_chain_client> block;
+  {
+    std::unique_lock<std::recursive_mutex> lock(mtx_);
+    id = block_id(args);
+    block = blocks_[id];
+  }
+  return async_command<T>(block, args, [this, args, id, result](std::vector<std::string> &_return) mutable {
+    if (_return[0] != "!ok") {
+      std::unique_lock<std::recursive_mutex> lock(mtx_);
+      if (id != block_id(args)) {
+        // An earlier request already moved past this partition; start over from the new one
+        run_repeated(_return, args);
+        return result(_return);
+      }
+      try {
+        handle_redirect(_return, args);
+      } catch (redo_error &e) {
+        run_repeated(_return, args);
+      }
+    }
+    THROW_IF_NOT_OK(_return);
+    return result(_return);
+  });
 }
 
 void fifo_queue_client::add_blocks(const std::vector<std::string> &_return, const std::vector<std::string> &args) {
@@ -11,7 +11,7 @@
 namespace jiffy {
 namespace storage {
 
-class fifo_queue_client : data_structure_client {
+class fifo_queue_client : public data_structure_client {
  public:
   /**
    * @brief Constructor
@@ -52,6 +52,61 @@ class fifo_queue_client : data_structure_client {
    */
   std::string read_next();
 
+  /**
+   * @brief Enqueue a batch of messages
+   * The batch is sent as a single framed string, and messages that do not fit in a partition
+   * are carried over to the next one
+   * @param items New items
+   */
+  void enqueue_batch(const std::vector<std::string> &items);
+
+  /**
+   * @brief Dequeue up to a number of items
+   * Items are only taken from the partition at the head of the queue
+   * @param max_items Maximum number of items
+   * @return Dequeued items, empty if the queue is empty
+   */
+  std::vector<std::string> dequeue_batch(std::size_t max_items);
+
+  /**
+   * @brief Dequeue item, waiting for one to be enqueued if the queue is empty
+   * The wait is held at the tail of the partition, so that the item is picked up as soon as it
+   * is enqueued rather than by polling
+   * @param timeout_ms Maximum time to wait in milliseconds
+   * @return Dequeued item
+   */
+  std::string dequeue_wait(int timeout_ms);
+
+  /**
+   * @brief Read next item without dequeue, waiting for one to be enqueued if there is none
+   * @param timeout_ms Maximum time to wait in milliseconds
+   * @return Read next result
+   */
+  std::string read_next_wait(int timeout_ms);
+
+  /**
+   * @brief Enqueue message without waiting for the response
+   * Requests are pipelined on the replica chain and complete in order on the
+   * response thread; the client must outlive them
+   * @param item New item
+   * @return Future for the completion of the enqueue
+   */
+  std::future<void> enqueue_async(const std::string &item);
+
+  /**
+   * @brief Dequeue item without waiting for the response
+   * Requests complete in order on the response thread; the client must outlive them
+   * @return Future for the completion of the dequeue
+   */
+  std::future<void> dequeue_async();
+
+  /**
+   * @brief Read next item without dequeue, without waiting for the response
+   * Requests complete in order on the response thread; the client must outlive them
+   * @return Future for the read next result
+   */
+  std::future<std::string> read_next_async();
+
   /**
    * @brief Fetch Queue size
    * @return Queue size
@@ -96,6 +151,32 @@ class fifo_queue_client : data_structure_client {
    */
   void run_repeated(std::vector<std::string> &_return, const std::vector<std::string> &args);
 
+  /**
+   * @brief Run command repeatedly until it is no longer redirected, without checking the final response
+   * @param _return Response
+   * @param args Arguments
+   */
+  void run_redirected(std::vector<std::string> &_return, const std::vector<std::string> &args);
+
+  /**
+   * @brief Wait on the current partition for an item to be enqueued
+   * Each wait is kept within the receive timeout of the connection
+   * @param op Wait operation
+   * @param deadline Deadline in milliseconds
+   * @return Response
+   */
+  std::vector<std::string> wait_for_item(const std::string &op, std::uint64_t deadline);
+
+  /**
+   * @brief Run command on the current partition without waiting for the response
+   * Redirects are handled on the response thread before the result is computed
+   * @param args Arguments
+   * @param result Computes the future's value from the response
+   * @return Future for the result
+   */
+  template<typename T, typename F>
+  std::future<T> run_async(const std::vector<std::string> &args, F result);
+
   /**
    * @brief Fetch block identifier for specific command
    * @param args Arguments
@@ -21,7 +21,7 @@ file_client::file_client(std::shared_ptr<directory::directory_interface> fs,
       last_partition_(0),
       last_offset_(0) {
   for (const auto &block: status.data_blocks()) {
-    blocks_.push_back(std::make_shared<replica_chain_client>(fs_, path_, block, FILE_OPS, timeout_ms_));
+    blocks_.push_back(connect_chain(block, FILE_OPS, timeout_ms_));
   }
   last_partition_ = status.data_blocks().size() - 1;
   std::vector<std::string> get_storage_capacity_args{"get_storage_capacity"};
@@ -36,22 +36,34 @@ file_client::file_client(std::shared_ptr<directory::directory_interface> fs,
 }
 
 int file_client::read(std::string &buf, size_t size) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   std::size_t file_size = last_partition_ * block_size_ + last_offset_;
   if (file_size <= cur_partition_ * block_size_ + cur_offset_)
     return -1;
-  std::size_t remain_size = file_size - cur_partition_ * block_size_ - cur_offset_;
+  auto response = read_async(size);
+  lock.unlock();
+  auto data = response.get();
+  buf += data;
+  return static_cast<int>(data.size());
+}
+
+int file_client::write(const std::string &data) {
+  return write_async(data).get();
+}
+
+std::future<std::string> file_client::read_async(size_t size) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
+  std::size_t file_size = last_partition_ * block_size_ + last_offset_;
+  std::size_t remain_size = file_size > cur_partition_ * block_size_ + cur_offset_ ?
+                            file_size - cur_partition_ * block_size_ - cur_offset_ : 0;
   std::size_t remaining_data = std::min(remain_size, size);
-  if (remaining_data == 0)
-    return 0;
   // Parallel read here
-  std::size_t start_partition = block_id();
-  std::size_t count = 0;
+  std::vector<std::pair<std::shared_ptr<replica_chain_client>, std::vector<std::string>>> requests;
   while (remaining_data > 0) {
-    count++;
     std::size_t data_to_read = std::min(remaining_data, block_size_ - cur_offset_);
     std::vector<std::string>
         args{"read", std::to_string(cur_offset_), std::to_string(data_to_read)};
-    blocks_[block_id()]->send_command(args);
+    requests.emplace_back(blocks_[block_id()], std::move(args));
     remaining_data -= data_to_read;
     cur_offset_ += data_to_read;
     if (cur_offset_ == block_size_ && cur_partition_ != last_partition_) {
@@ -59,15 +71,18 @@ int file_client::read(std::string &buf, size_t size) {
       cur_partition_++;
     }
   }
-  auto previous_size = buf.size();
-  for (std::size_t k = 0; k < count; k++) {
-    buf += blocks_[start_partition + k]->recv_response().back();
-  }
-  auto after_size = buf.size();
-  return static_cast<int>(after_size - previous_size);
+  lock.unlock();
+  return async_commands<std::string>(requests, [](std::vector<std::vector<std::string>> &responses) {
+    std::string buf;
+    for (auto &resp: responses) {
+      buf += resp.back();
+    }
+    return buf;
+  });
 }
 
-int file_client::write(const std::string &data) {
+std::future<int> file_client::write_async(const std::string &data) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   std::size_t file_size = (last_partition_ + 1) * block_size_;
   std::vector<std::string> _return;
 
@@ -87,7 +102,7 @@ int file_client::write(const std::string &data) {
   }
 
   if (num_chain_needed && !auto_scaling_) {
-    return -1;
+    return ready_future(-1);
   }
 
   // First allocate new blocks if needed
@@ -103,10 +118,10 @@ int file_client::write(const std::string &data) {
       try {
         for (auto x = _return.begin() + 1; x < _return.end(); x++) {
           auto chain = string_utils::split(*x, '!');
-          blocks_.push_back(std::make_shared<replica_chain_client>(fs_, path_, chain, FILE_OPS));
+          blocks_.push_back(connect_chain(chain, FILE_OPS));
         }
       } catch (std::exception &e) {
-        return -1;
+        return ready_future(-1);
       }
     }
   }
@@ -116,16 +131,14 @@ int file_client::write(const std::string &data) {
   }
   // Parallel write
   std::size_t remaining_data = data.size();
-  std::size_t start_partition = block_id();
-  std::size_t count = 0;
+  std::vector<std::pair<std::shared_ptr<replica_chain_client>, std::vector<std::string>>> requests;
 
   while (remaining_data > 0) {
-    count++;
     std::string
         data_to_write = data.substr(data.size() - remaining_data, std::min(remaining_data, block_size_ - cur_offset_));
     std::vector<std::string>
         args{"write", data_to_write, std::to_string(cur_offset_)};
-    blocks_[block_id()]->send_command(args);
+    requests.emplace_back(blocks_[block_id()], std::move(args));
     remaining_data -= data_to_write.size();
     cur_offset_ += data_to_write.size();
     update_last_offset();
@@ -136,21 +149,57 @@ int file_client::write(const std::string &data) {
     }
   }
 
-  for (std::size_t i = 0; i < count; i++) {
-    blocks_[start_partition + i]->recv_response();
-  }
-  return data.size();
+  lock.unlock();
 
+  auto size = static_cast<int>(data.size());
+  return async_commands<int>(requests, [size](std::vector<std::vector<std::string>> &) {
+    return size;
+  });
+}
+
+int64_t file_client::bulk_load(const std::function<bool(std::string &)> &next, std::size_t batch_bytes) {
+  int64_t written = 0;
+  std::future<int> in_flight;
+  auto ship = [this, &written, &in_flight](const std::string &data) {
+    if (in_flight.valid()) {
+      auto ret = in_flight.get();
+      if (ret < 0) {
+        return false;
+      }
+      written += ret;
+    }
+    if (!data.empty()) {
+      in_flight = write_async(data);
+    }
+    return true;
+  };
+
+  std::string buf, chunk;
+  while (next(chunk)) {
+    buf += chunk;
+    chunk.clear();
+    if (buf.size() >= batch_bytes) {
+      if (!ship(buf)) {
+        return -1;
+      }
+      buf.clear();
+    }
+  }
+  if (!ship(buf) || !ship("")) {
+    return -1;
+  }
+  return written;
 }
 
 void file_client::refresh() {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   bool redo;
   do {
     status_ = fs_->dstatus(path_);
     blocks_.clear();
     try {
       for (const auto &block: status_.data_blocks()) {
-        blocks_.push_back(std::make_shared<replica_chain_client>(fs_, path_, block, FILE_OPS, timeout_ms_));
+        blocks_.push_back(connect_chain(block, FILE_OPS, timeout_ms_));
       }
       redo = false;
     } catch (std::exception &e) {
@@ -160,6 +209,7 @@ void file_client::refresh() {
 }
 
 bool file_client::seek(const std::size_t offset) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   cur_partition_ = offset / block_size_;
   cur_offset_ = offset % block_size_;
   return true;
@@ -6,6 +6,7 @@
 #include "jiffy/utils/client_cache.h"
 #include "jiffy/storage/file/file_ops.h"
 #include "jiffy/storage/client/data_structure_client.h"
+#include <functional>
 
 namespace jiffy {
 namespace storage {
@@ -51,6 +52,34 @@ class file_client : public data_structure_client {
    */
   int write(const std::string &data);
 
+  /**
+   * @brief Read data from file without waiting for the response
+   * The file offset is advanced immediately and the future completes on the
+   * response thread; the client must outlive it
+   * @param size Size
+   * @return Future for the data read, empty if reach EOF
+   */
+  std::future<std::string> read_async(size_t size);
+
+  /**
+   * @brief Write data to file without waiting for the response
+   * The file offset is advanced immediately and the future completes on the
+   * response thread; the client must outlive it
+   * @param data Data
+   * @return Future for the number of bytes written, or -1 if blocks are insufficient
+   */
+  std::future<int> write_async(const std::string &data);
+
+  /**
+   * @brief Write a stream of data to file
+   * Chunks are coalesced into large writes, and the next write is shipped while the previous one
+   * is still in flight
+   * @param next Function producing the next chunk, returns false at the end of the stream
+   * @param batch_bytes Size of a write in bytes
+   * @return Number of bytes written, or -1 if blocks are insufficient
+   */
+  int64_t bulk_load(const std::function<bool(std::string &)> &next, std::size_t batch_bytes = 4194304);
+
   /**
    * @brief Seek to a location of the file
    * @param offset File offset to seek
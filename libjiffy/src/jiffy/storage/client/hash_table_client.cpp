@@ -4,12 +4,16 @@
 #include "jiffy/utils/logger.h"
 #include <thread>
 #include <cmath>
+#include <numeric>
 
 namespace jiffy {
 namespace storage {
 
 using namespace jiffy::utils;
 
+/* Rounds a batch retries keys that keep responding !redo before giving up */
+static const std::size_t MAX_BATCH_REDO_TIMES = 100;
+
 hash_table_client::hash_table_client(std::shared_ptr<directory::directory_interface> fs,
                                      const std::string &path,
                                      const directory::data_status &status,
@@ -18,11 +22,12 @@ hash_table_client::hash_table_client(std::shared_ptr<directory::directory_interf
   blocks_.clear();
   for (auto &block: status.data_blocks()) {
     blocks_.emplace(std::make_pair(static_cast<int32_t>(std::stoi(utils::string_utils::split(block.name, '_')[0])),
-                                   std::make_shared<replica_chain_client>(fs_, path_, block, HT_OPS, timeout_ms_)));
+                                   connect_chain(block, HT_OPS, timeout_ms_)));
   }
 }
 
 void hash_table_client::refresh() {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   status_ = fs_->dstatus(path_);
   blocks_.clear();
   bool redo;
@@ -32,11 +37,7 @@ void hash_table_client::refresh() {
         if (block.metadata != "split_importing" && block.metadata != "importing") {
           blocks_.emplace(std::make_pair(static_cast<int32_t>(std::stoi(utils::string_utils::split(block.name,
                                                                                                    '_')[0])),
-                                         std::make_shared<replica_chain_client>(fs_,
-                                                                                path_,
-                                                                                block,
-                                                                                HT_OPS,
-                                                                                timeout_ms_)));
+                                         connect_chain(block, HT_OPS, timeout_ms_)));
         }
       }
       redo = false;
@@ -48,12 +49,14 @@ void hash_table_client::refresh() {
 }
 
 void hash_table_client::put(const std::string &key, const std::string &value) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   std::vector<std::string> _return;
-  std::vector<std::string> args{"put", key, value};
+  auto slot = hash_slot::get(key);
+  std::vector<std::string> args{command_opcode::encode(hash_table_cmd_id::ht_put, slot), key, value};
   bool redo;
   do {
     try {
-      _return = blocks_[block_id(key)]->run_command(args);
+      _return = blocks_[block_id(slot)]->run_command(args);
       handle_redirect(_return, args);
       redo = false;
       redo_times_ = 0;
@@ -65,12 +68,14 @@ void hash_table_client::put(const std::string &key, const std::string &value) {
 }
 
 std::string hash_table_client::get(const std::string &key) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   std::vector<std::string> _return;
-  std::vector<std::string> args{"get", key};
+  auto slot = hash_slot::get(key);
+  std::vector<std::string> args{command_opcode::encode(hash_table_cmd_id::ht_get, slot), key};
   bool redo;
   do {
     try {
-      _return = blocks_[block_id(key)]->run_command(args);
+      _return = blocks_[block_id(slot)]->run_command(args);
       handle_redirect(_return, args);
       redo = false;
       redo_times_ = 0;
@@ -79,16 +84,18 @@ std::string hash_table_client::get(const std::string &key) {
     }
   } while (redo);
   THROW_IF_NOT_OK(_return);
-  return _return[1];
+  return std::move(_return[1]);
 }
 
 std::string hash_table_client::update(const std::string &key, const std::string &value) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   std::vector<std::string> _return;
-  std::vector<std::string> args{"update", key, value};
+  auto slot = hash_slot::get(key);
+  std::vector<std::string> args{command_opcode::encode(hash_table_cmd_id::ht_update, slot), key, value};
   bool redo;
   do {
     try {
-      _return = blocks_[block_id(key)]->run_command(args);
+      _return = blocks_[block_id(slot)]->run_command(args);
       handle_redirect(_return, args);
       redo = false;
       redo_times_ = 0;
@@ -101,12 +108,14 @@ std::string hash_table_client::update(const std::string &key, const std::string
 }
 
 std::string hash_table_client::upsert(const std::string &key, const std::string &value) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   std::vector<std::string> _return;
-  std::vector<std::string> args{"upsert", key, value};
+  auto slot = hash_slot::get(key);
+  std::vector<std::string> args{command_opcode::encode(hash_table_cmd_id::ht_upsert, slot), key, value};
   bool redo;
   do {
     try {
-      _return = blocks_[block_id(key)]->run_command(args);
+      _return = blocks_[block_id(slot)]->run_command(args);
       handle_redirect(_return, args);
       redo = false;
       redo_times_ = 0;
@@ -115,16 +124,19 @@ std::string hash_table_client::upsert(const std::string &key, const std::string
     }
   } while (redo);
   THROW_IF_NOT_OK(_return);
-  return _return[1];
+  // Upserting a new key returns no previous value
+  return _return.size() > 1 ? std::move(_return[1]) : std::string();
 }
 
 std::string hash_table_client::remove(const std::string &key) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   std::vector<std::string> _return;
-  std::vector<std::string> args{"remove", key};
+  auto slot = hash_slot::get(key);
+  std::vector<std::string> args{command_opcode::encode(hash_table_cmd_id::ht_remove, slot), key};
   bool redo;
   do {
     try {
-      _return = blocks_[block_id(key)]->run_command(args);
+      _return = blocks_[block_id(slot)]->run_command(args);
       handle_redirect(_return, args);
       redo = false;
       redo_times_ = 0;
@@ -137,12 +149,14 @@ std::string hash_table_client::remove(const std::string &key) {
 }
 
 bool hash_table_client::exists(const std::string &key) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   std::vector<std::string> _return;
-  std::vector<std::string> args{"exists", key};
+  auto slot = hash_slot::get(key);
+  std::vector<std::string> args{command_opcode::encode(hash_table_cmd_id::ht_exists, slot), key};
   bool redo;
   do {
     try {
-      _return = blocks_[block_id(key)]->run_command(args);
+      _return = blocks_[block_id(slot)]->run_command(args);
       handle_redirect(_return, args);
       redo = false;
       redo_times_ = 0;
@@ -153,21 +167,339 @@ bool hash_table_client::exists(const std::string &key) {
   return _return[0] == "!ok";
 }
 
-std::size_t hash_table_client::block_id(const std::string &key) {
-  return static_cast<size_t>((*std::prev(blocks_.upper_bound(hash_slot::get(key)))).first);
+std::future<void> hash_table_client::put_async(const std::string &key, const std::string &value) {
+  return run_command_async<void>({command_opcode::encode(hash_table_cmd_id::ht_put, hash_slot::get(key)), key, value},
+                                 [](std::vector<std::string> &_return) {
+                                   THROW_IF_NOT_OK(_return);
+                                 });
+}
+
+std::future<std::string> hash_table_client::get_async(const std::string &key) {
+  return run_command_async<std::string>({command_opcode::encode(hash_table_cmd_id::ht_get, hash_slot::get(key)), key},
+                                        [](std::vector<std::string> &_return) {
+                                          THROW_IF_NOT_OK(_return);
+                                          return std::move(_return[1]);
+                                        });
+}
+
+std::future<std::string> hash_table_client::update_async(const std::string &key, const std::string &value) {
+  return run_command_async<std::string>({command_opcode::encode(hash_table_cmd_id::ht_update, hash_slot::get(key)),
+                                         key, value},
+                                        [](std::vector<std::string> &_return) {
+                                          THROW_IF_NOT_OK(_return);
+                                          return std::move(_return[0]);
+                                        });
+}
+
+std::future<std::string> hash_table_client::upsert_async(const std::string &key, const std::string &value) {
+  return run_command_async<std::string>({command_opcode::encode(hash_table_cmd_id::ht_upsert, hash_slot::get(key)),
+                                         key, value},
+                                        [](std::vector<std::string> &_return) {
+                                          THROW_IF_NOT_OK(_return);
+                                          return _return.size() > 1 ? std::move(_return[1]) : std::string();
+                                        });
+}
+
+std::future<std::string> hash_table_client::remove_async(const std::string &key) {
+  return run_command_async<std::string>({command_opcode::encode(hash_table_cmd_id::ht_remove, hash_slot::get(key)),
+                                         key},
+                                        [](std::vector<std::string> &_return) {
+                                          THROW_IF_NOT_OK(_return);
+                                          return std::move(_return[0]);
+                                        });
+}
+
+std::future<bool> hash_table_client::exists_async(const std::string &key) {
+  return run_command_async<bool>({command_opcode::encode(hash_table_cmd_id::ht_exists, hash_slot::get(key)), key},
+                                 [](std::vector<std::string> &_return) {
+                                   return _return[0] == "!ok";
+                                 });
+}
+
+template<typename T, typename F>
+std::future<T> hash_table_client::run_command_async(const std::vector<std::string> &args, F result) {
+  std::shared_ptr<replica_chain_client> block;
+  {
+    std::unique_lock<std::recursive_mutex> lock(mtx_);
+    block = blocks_[block_id(hash_slot::get(args[0], args[1]))];
+  }
+  return async_command<T>(block, args, [this, args, result](std::vector<std::string> &_return) mutable {
+    if (needs_redirect(_return)) {
+      std::unique_lock<std::recursive_mutex> lock(mtx_);
+      try {
+        handle_redirect(_return, args);
+        redo_times_ = 0;
+      } catch (redo_error &e) {
+        run_repeated(_return, args);
+      }
+    }
+    return result(_return);
+  });
+}
+
+bool hash_table_client::needs_redirect(const std::vector<std::string> &_return) {
+  return _return[0] == "!exporting" || _return[0] == "!block_moved" || _return[0] == "!full" || _return[0] == "!redo";
+}
+
+void hash_table_client::run_repeated(std::vector<std::string> &_return, const std::vector<std::string> &args) {
+  bool redo;
+  do {
+    try {
+      _return = blocks_[block_id(hash_slot::get(args[0], args[1]))]->run_command(args);
+      handle_redirect(_return, args);
+      redo = false;
+      redo_times_ = 0;
+    } catch (redo_error &e) {
+      redo = true;
+    }
+  } while (redo);
+}
+
+std::vector<std::string> hash_table_client::multi_get(const std::vector<std::string> &keys) {
+  auto responses = run_batch("get", keys, {});
+  std::vector<std::string> values;
+  values.reserve(responses.size());
+  for (auto &_return: responses) {
+    THROW_IF_NOT_OK(_return);
+    values.push_back(std::move(_return[1]));
+  }
+  return values;
+}
+
+void hash_table_client::multi_put(const std::vector<std::string> &keys, const std::vector<std::string> &values) {
+  for (auto &_return: run_batch("put", keys, values)) {
+    THROW_IF_NOT_OK(_return);
+  }
+}
+
+std::vector<std::string> hash_table_client::multi_upsert(const std::vector<std::string> &keys,
+                                                         const std::vector<std::string> &values) {
+  auto responses = run_batch("upsert", keys, values);
+  std::vector<std::string> old_values;
+  old_values.reserve(responses.size());
+  for (auto &_return: responses) {
+    THROW_IF_NOT_OK(_return);
+    old_values.push_back(_return.size() > 1 ? std::move(_return[1]) : std::string());
+  }
+  return old_values;
+}
+
+void hash_table_client::multi_remove(const std::vector<std::string> &keys) {
+  for (auto &_return: run_batch("remove", keys, {})) {
+    THROW_IF_NOT_OK(_return);
+  }
+}
+
+std::size_t hash_table_client::bulk_load(const std::function<bool(std::string &, std::string &)> &next,
+                                         std::size_t batch_bytes) {
+  // Pairs that are not shipped yet and their size in bytes, by replica chain
+  std::map<std::size_t, std::pair<std::vector<std::string>, std::size_t>> pending;
+  // Shipped batches waiting for a response, by replica chain
+  std::map<std::size_t, std::pair<std::vector<std::string>, std::future<std::vector<std::string>>>> in_flight;
+
+  // The client mutex is not held while waiting on responses, which continuations may need it for
+  auto add = [this, &pending](std::string key, std::string value) {
+    std::unique_lock<std::recursive_mutex> lock(mtx_);
+    auto id = block_id(hash_slot::get(key));
+    auto &batch = pending[id];
+    if (batch.first.empty()) {
+      batch.first.emplace_back("bulk_load");
+    }
+    batch.second += key.size() + value.size();
+    batch.first.push_back(std::move(key));
+    batch.first.push_back(std::move(value));
+    return id;
+  };
+
+  auto drain = [this, &pending, &in_flight, &add]() {
+    std::vector<std::string> keys, values;
+    for (auto &batch: in_flight) {
+      auto _return = batch.second.second.get();
+      if (_return[0] != "!ok") {
+        auto &args = batch.second.first;
+        for (std::size_t i = 1; i < args.size(); i += 2) {
+          keys.push_back(std::move(args[i]));
+          values.push_back(std::move(args[i + 1]));
+        }
+      }
+    }
+    in_flight.clear();
+    if (keys.empty()) {
+      return;
+    }
+    // Moved, exporting or full partitions reject the whole batch; retry it key by key
+    for (auto &_return: run_batch("upsert", keys, values)) {
+      THROW_IF_NOT_OK(_return);
+    }
+    // The retry may have refreshed the blocks, so regroup the pairs that are not shipped yet
+    auto stale = std::move(pending);
+    pending.clear();
+    for (auto &batch: stale) {
+      auto &args = batch.second.first;
+      for (std::size_t i = 1; i < args.size(); i += 2) {
+        add(std::move(args[i]), std::move(args[i + 1]));
+      }
+    }
+  };
+
+  auto ship = [this, &pending, &in_flight, &drain](std::size_t id) {
+    if (in_flight.find(id) != in_flight.end()) {
+      drain();
+    }
+    auto it = pending.find(id);
+    if (it == pending.end()) {
+      return;
+    }
+    auto args = std::move(it->second.first);
+    pending.erase(it);
+    std::shared_ptr<replica_chain_client> block;
+    {
+      std::unique_lock<std::recursive_mutex> lock(mtx_);
+      block = blocks_.at(id);
+    }
+    auto response = async_command(block, args);
+    in_flight.emplace(id, std::make_pair(std::move(args), std::move(response)));
+  };
+
+  std::size_t count = 0;
+  std::string key, value;
+  while (next(key, value)) {
+    auto id = add(std::move(key), std::move(value));
+    ++count;
+    if (pending[id].second >= batch_bytes) {
+      ship(id);
+    }
+  }
+  while (!pending.empty()) {
+    ship(pending.begin()->first);
+  }
+  drain();
+  return count;
+}
+
+void hash_table_client::bulk_load(const std::vector<std::string> &keys,
+                                  const std::vector<std::string> &values,
+                                  std::size_t batch_bytes) {
+  if (values.size() != keys.size()) {
+    throw std::invalid_argument("Number of keys and values do not match");
+  }
+  std::size_t i = 0;
+  bulk_load([&](std::string &key, std::string &value) {
+    if (i == keys.size()) {
+      return false;
+    }
+    key = keys[i];
+    value = values[i];
+    ++i;
+    return true;
+  }, batch_bytes);
+}
+
+std::vector<std::vector<std::string>> hash_table_client::run_batch(const std::string &op,
+                                                                   const std::vector<std::string> &keys,
+                                                                   const std::vector<std::string> &values) {
+  if (!values.empty() && values.size() != keys.size()) {
+    throw std::invalid_argument("Number of keys and values do not match");
+  }
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
+  std::vector<std::vector<std::string>> results(keys.size());
+  std::vector<std::size_t> pending(keys.size());
+  std::iota(pending.begin(), pending.end(), 0);
+  while (!pending.empty()) {
+    // Group keys by the replica chain that owns them
+    std::map<std::size_t, std::vector<std::size_t>> batches;
+    for (auto i: pending) {
+      batches[block_id(hash_slot::get(keys[i]))].push_back(i);
+    }
+    pending.clear();
+    bool moved = false;
+    bool full = false;
+    bool redo = false;
+    for (const auto &batch: batches) {
+      std::vector<std::string> args;
+      args.reserve(1 + batch.second.size() * (values.empty() ? 1 : 2));
+      args.emplace_back("multi_" + op);
+      for (auto i: batch.second) {
+        args.push_back(keys[i]);
+        if (!values.empty())
+          args.push_back(values[i]);
+      }
+      auto _return = blocks_[batch.first]->run_command(args);
+      if (_return[0] == "!block_moved") {
+        moved = true;
+        pending.insert(pending.end(), batch.second.begin(), batch.second.end());
+        continue;
+      }
+      THROW_IF_NOT_OK(_return);
+      // Each key's response is prefixed by its length
+      std::size_t pos = 1;
+      for (auto i: batch.second) {
+        auto n = std::stoul(_return[pos++]);
+        std::vector<std::string> key_return(std::make_move_iterator(_return.begin() + pos),
+                                            std::make_move_iterator(_return.begin() + pos + n));
+        pos += n;
+        if (key_return[0] == "!block_moved") {
+          moved = true;
+          pending.push_back(i);
+          continue;
+        }
+        if (key_return[0] == "!full") {
+          full = true;
+          pending.push_back(i);
+          continue;
+        }
+        if (key_return[0] == "!redo") {
+          redo = true;
+          pending.push_back(i);
+          continue;
+        }
+        if (key_return[0] == "!exporting") {
+          std::vector<std::string> key_args{op, keys[i]};
+          if (!values.empty())
+            key_args.push_back(values[i]);
+          try {
+            handle_redirect(key_return, key_args);
+          } catch (redo_error &e) {
+            pending.push_back(i);
+            continue;
+          }
+        }
+        results[i] = std::move(key_return);
+      }
+    }
+    if (moved) {
+      refresh();
+    }
+    if (redo && redo_times_ >= MAX_BATCH_REDO_TIMES) {
+      redo_times_ = 0;
+      throw std::logic_error("!redo");
+    }
+    if (full || redo) {
+      // Back off as the single key paths do on !full, but never spin without sleeping
+      std::this_thread::sleep_for(std::chrono::milliseconds(std::max<std::size_t>(1, redo_times_)));
+      redo_times_++;
+    }
+  }
+  redo_times_ = 0;
+  return results;
+}
+
+std::size_t hash_table_client::block_id(int32_t slot) {
+  return static_cast<size_t>((*std::prev(blocks_.upper_bound(slot))).first);
 }
 
 void hash_table_client::handle_redirect(std::vector<std::string> &_return, const std::vector<std::string> &args) {
   while (_return[0] == "!exporting") {
     auto args_copy = args;
-    if (args[0] == "update" || args[0] == "upsert") {
+    auto cmd_id = command_opcode::is_opcode(args[0]) ? command_opcode::decode(args[0]) : HT_OPS.at(args[0]).id;
+    if (cmd_id == hash_table_cmd_id::ht_update || cmd_id == hash_table_cmd_id::ht_upsert) {
       args_copy.emplace_back(_return[2]);
       args_copy.emplace_back(_return[3]);
     }
     auto it = redirect_blocks_.find(_return[0] + _return[1]);
     if (it == redirect_blocks_.end()) {
       auto chain = directory::replica_chain(string_utils::split(_return[1], '!'));
-      auto client = std::make_shared<replica_chain_client>(fs_, path_, chain, HT_OPS, 0);
+      auto client = connect_chain(chain, HT_OPS, 0);
       redirect_blocks_.emplace(std::make_pair(_return[0] + _return[1], client));
       do {
         _return = client->run_command_redirected(args_copy);
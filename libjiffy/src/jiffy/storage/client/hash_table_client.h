@@ -6,6 +6,7 @@
 #include "jiffy/utils/client_cache.h"
 #include "jiffy/storage/client/data_structure_client.h"
 #include "jiffy/storage/hashtable/hash_table_ops.h"
+#include <functional>
 
 namespace jiffy {
 namespace storage {
@@ -81,15 +82,157 @@ class hash_table_client : public data_structure_client {
    */
   bool exists(const std::string &key);
 
+  /**
+   * @brief Put key value pair without waiting for the response
+   * Requests are pipelined on the replica chain; the client must outlive the request
+   * @param key Key
+   * @param value Value
+   * @return Future for the completion of the command
+   */
+  std::future<void> put_async(const std::string &key, const std::string &value);
 
- private:
   /**
-   * @brief Fetch block identifier for particular key
+   * @brief Get value for specified key without waiting for the response
+   * Requests are pipelined on the replica chain; the client must outlive the request
    * @param key Key
+   * @return Future for the value
+   */
+  std::future<std::string> get_async(const std::string &key);
+
+  /**
+   * @brief Update key value pair without waiting for the response
+   * Requests are pipelined on the replica chain; the client must outlive the request
+   * @param key Key
+   * @param value Value
+   * @return Future for the response of the command
+   */
+  std::future<std::string> update_async(const std::string &key, const std::string &value);
+
+  /**
+   * @brief Put key value pair, update if key exists, without waiting for the response
+   * Requests are pipelined on the replica chain; the client must outlive the request
+   * @param key Key
+   * @param value Value
+   * @return Future for the previous value, empty if the key did not exist
+   */
+  std::future<std::string> upsert_async(const std::string &key, const std::string &value);
+
+  /**
+   * @brief Remove key value pair without waiting for the response
+   * Requests are pipelined on the replica chain; the client must outlive the request
+   * @param key Key
+   * @return Future for the response of the command
+   */
+  std::future<std::string> remove_async(const std::string &key);
+
+  /**
+   * @brief Check if key exists without waiting for the response
+   * Requests are pipelined on the replica chain; the client must outlive the request
+   * @param key Key
+   * @return Future for whether the key exists
+   */
+  std::future<bool> exists_async(const std::string &key);
+
+  /**
+   * @brief Get values for a batch of keys
+   * Keys are grouped by replica chain and sent as one command per chain
+   * @param keys Keys
+   * @return Values, in the same order as the keys
+   */
+  std::vector<std::string> multi_get(const std::vector<std::string> &keys);
+
+  /**
+   * @brief Put a batch of key value pairs
+   * Keys are grouped by replica chain and sent as one command per chain
+   * @param keys Keys
+   * @param values Values, in the same order as the keys
+   */
+  void multi_put(const std::vector<std::string> &keys, const std::vector<std::string> &values);
+
+  /**
+   * @brief Put a batch of key value pairs, updating keys that exist
+   * Keys are grouped by replica chain and sent as one command per chain
+   * @param keys Keys
+   * @param values Values, in the same order as the keys
+   * @return Previous values, empty for keys that did not exist
+   */
+  std::vector<std::string> multi_upsert(const std::vector<std::string> &keys, const std::vector<std::string> &values);
+
+  /**
+   * @brief Remove a batch of keys
+   * Keys are grouped by replica chain and sent as one command per chain
+   * @param keys Keys
+   */
+  void multi_remove(const std::vector<std::string> &keys);
+
+  /**
+   * @brief Load a stream of key value pairs, updating keys that exist
+   * Pairs are grouped by replica chain and shipped in large batches that partitions apply without
+   * per key responses, with one batch in flight per chain; rejected batches are retried key by key
+   * @param next Function producing the next pair, returns false at the end of the stream
+   * @param batch_bytes Size of a batch in bytes
+   * @return Number of pairs loaded
+   */
+  std::size_t bulk_load(const std::function<bool(std::string &, std::string &)> &next,
+                        std::size_t batch_bytes = 4194304);
+
+  /**
+   * @brief Load a batch of key value pairs, updating keys that exist
+   * @param keys Keys
+   * @param values Values, in the same order as the keys
+   * @param batch_bytes Size of a batch in bytes
+   */
+  void bulk_load(const std::vector<std::string> &keys,
+                 const std::vector<std::string> &values,
+                 std::size_t batch_bytes = 4194304);
+
+
+ private:
+  /**
+   * @brief Fetch block identifier for particular hash slot
+   * @param slot Hash slot of the key
    * @return Block identifier
    */
 
-  std::size_t block_id(const std::string &key);
+  std::size_t block_id(int32_t slot);
+
+  /**
+   * @brief Run command on the chain owning the key without waiting for the response
+   * Redirects in the response are handled on the event loop thread before the result is taken
+   * @param args Command arguments, key first
+   * @param result Function taking the final response and returning the result
+   * @return Future for the result
+   */
+  template<typename T, typename F>
+  std::future<T> run_command_async(const std::vector<std::string> &args, F result);
+
+  /**
+   * @brief Check if a response has to be redirected or retried
+   * @param _return Response
+   * @return Bool value, true if handle_redirect() acts on the response
+   */
+  static bool needs_redirect(const std::vector<std::string> &_return);
+
+  /**
+   * @brief Run command repeatedly until it is no longer redirected
+   * @param _return Response
+   * @param args Command arguments, key first
+   */
+  void run_repeated(std::vector<std::string> &_return, const std::vector<std::string> &args);
+
+  /**
+   * @brief Run a batched command, sending one command per replica chain
+   * Keys that are redirected or moved are retried individually until each has a final response;
+   * retries of full or busy partitions back off, and keys still busy after a bounded number of
+   * rounds fail the batch with !redo
+   * @param op Single key operation name
+   * @param keys Keys
+   * @param values Values, empty if the operation takes no values
+   * @return Response for each key, in the same order as the keys
+   */
+  std::vector<std::vector<std::string>> run_batch(const std::string &op,
+                                                  const std::vector<std::string> &keys,
+                                                  const std::vector<std::string> &values);
 
   /**
    * @brief Handle command in redirect case
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <thrift/transport/TTransportException.h>
 #include "replica_chain_client.h"
 #include "jiffy/utils/string_utils.h"
@@ -14,24 +15,44 @@ replica_chain_client::replica_chain_client(std::shared_ptr<directory::directory_
                                            const std::string &path,
                                            const directory::replica_chain &chain,
                                            const command_map &OPS,
-                                           int timeout_ms) : fs_(fs), path_(path), in_flight_(false), OPS_(OPS) {
+                                           int timeout_ms,
+                                           std::size_t max_in_flight)
+    : fs_(fs),
+      path_(path),
+      in_flight_(false),
+      OPS_(OPS),
+      replica_reads_(false),
+      next_replica_(0),
+      read_replica_(0),
+      max_in_flight_(std::max<std::size_t>(max_in_flight, 1)),
+      async_fd_(-1) {
   seq_.client_id = -1;
   seq_.client_seq_no = 0;
+  async_seq_.client_id = -1;
+  async_seq_.client_seq_no = 0;
   accessor_ = false;
   send_run_command_exception_ = false;
   connect(chain, timeout_ms);
-  for (auto &op: OPS) {
-    cmd_client_[op.first] = op.second.is_accessor() ? &tail_ : &head_;
-  }
 }
 
 replica_chain_client::~replica_chain_client() {
+  std::vector<response_callback> failed;
+  {
+    std::unique_lock<std::mutex> lock(async_mtx_);
+    failed = fail_async();
+  }
+  fail(failed);
+  async_head_.disconnect();
+  async_tail_.disconnect();
   disconnect();
 }
 
 void replica_chain_client::disconnect() {
   head_.disconnect();
   tail_.disconnect();
+  for (auto &m: mid_) {
+    m->disconnect();
+  }
 }
 
 const directory::replica_chain &replica_chain_client::chain() const {
@@ -52,21 +73,74 @@ void replica_chain_client::connect(const directory::replica_chain &chain, int ti
   }
   response_reader_ = tail_.get_command_response_reader(seq_.client_id);
   in_flight_ = false;
+  if (replica_reads_) {
+    connect_replicas();
+  }
+}
+
+void replica_chain_client::connect_replicas() {
+  mid_.clear();
+  for (std::size_t i = 1; i + 1 < chain_.block_ids.size(); i++) {
+    auto m = block_id_parser::parse(chain_.block_ids[i]);
+    mid_.push_back(std::make_unique<block_client>());
+    mid_.back()->connect(m.host, m.service_port, m.id, timeout_ms_);
+  }
+}
+
+block_client &replica_chain_client::replica(std::size_t i) {
+  if (i == 0) {
+    return head_;
+  }
+  if (i + 1 == chain_.block_ids.size()) {
+    return tail_;
+  }
+  return *mid_[i - 1];
+}
+
+void replica_chain_client::read_from_replicas(bool enabled) {
+  if (enabled && !replica_reads_) {
+    connect_replicas();
+  }
+  replica_reads_ = enabled;
+}
+
+bool replica_chain_client::read_from_replicas() const {
+  return replica_reads_;
 }
 
 void replica_chain_client::send_command(const std::vector<std::string> &args) {
   if (in_flight_) {
     throw std::length_error("Cannot have more than one request in-flight");
   }
-  if (OPS_[args[0]].is_accessor()) {
+  // Accessor responses share the tail connection with pipelined responses
+  while (!outstanding_.empty()) {
+    recv_pipelined();
+  }
+  auto cmd_id = OPS_.id(args.front());
+  auto info = OPS_.info(cmd_id);
+  if (info == nullptr) {
+    throw std::invalid_argument("Unsupported command: " + args.front());
+  }
+  auto op = command_opcode::is_opcode(args.front()) ? args.front() : command_opcode::encode(cmd_id);
+  if (info->is_accessor()) {
     try {
       accessor_ = true;
-      cmd_client_.at(args.front())->send_run_command(std::stoi(string_utils::split(chain_.tail(), ':').back()), args);
+      read_replica_ = chain_.block_ids.size() - 1;
+      if (replica_reads_) {
+        read_replica_ = next_replica_++ % chain_.block_ids.size();
+        if (read_replica_ != chain_.block_ids.size() - 1) {
+          read_op_ = op;
+          read_args_ = args;
+        }
+      }
+      replica(read_replica_).send_run_command(std::stoi(string_utils::split(chain_.block_ids[read_replica_], ':').back()),
+                                              op,
+                                              args);
     } catch (std::exception &e) {
       send_run_command_exception_ = true;
     }
   } else {
-    cmd_client_.at(args.front())->command_request(seq_, args);
+    head_.command_request(seq_, op, args);
   }
   in_flight_ = true;
 }
@@ -79,7 +153,14 @@ std::vector<std::string> replica_chain_client::recv_response() {
       ret.emplace_back("!block_moved");
     } else {
       try {
-        tail_.recv_run_command(ret);
+        replica(read_replica_).recv_run_command(ret);
+        if (!ret.empty() && ret[0] == "!dirty") {
+          // The replica has writes in flight down the chain; only the tail knows which are committed
+          ret.clear();
+          read_replica_ = chain_.block_ids.size() - 1;
+          tail_.send_run_command(std::stoi(string_utils::split(chain_.tail(), ':').back()), read_op_, read_args_);
+          tail_.recv_run_command(ret);
+        }
       } catch (std::exception &e) {
         if (!send_run_command_exception_) {
           ret.emplace_back("!block_moved");
@@ -134,6 +215,252 @@ std::vector<std::string> replica_chain_client::run_command_redirected(const std:
   return recv_response();
 }
 
+int64_t replica_chain_client::send_command_pipelined(const std::vector<std::string> &args) {
+  if (in_flight_) {
+    throw std::length_error("Cannot pipeline requests while a request is in-flight");
+  }
+  auto cmd_id = OPS_.id(args.front());
+  auto info = OPS_.info(cmd_id);
+  if (info == nullptr) {
+    throw std::invalid_argument("Unsupported command: " + args.front());
+  }
+  while (outstanding_.size() >= max_in_flight_) {
+    recv_pipelined();
+  }
+  auto client_seq_no = seq_.client_seq_no++;
+  outstanding_.insert(client_seq_no);
+  auto op = command_opcode::is_opcode(args.front()) ? args.front() : command_opcode::encode(cmd_id);
+  sequence_id seq = seq_;
+  seq.client_seq_no = client_seq_no;
+  try {
+    // The tail responds to accessors sent as requests the same way it responds to mutators
+    (info->is_accessor() ? tail_ : head_).command_request(seq, op, args);
+  } catch (apache::thrift::transport::TTransportException &e) {
+    LOG(log_level::info) << "Error in connection to chain: " << e.what();
+    fail_pipelined();
+  }
+  return client_seq_no;
+}
+
+std::vector<std::string> replica_chain_client::recv_response(int64_t client_seq_no) {
+  while (true) {
+    auto it = completed_.find(client_seq_no);
+    if (it != completed_.end()) {
+      auto ret = std::move(it->second);
+      completed_.erase(it);
+      return ret;
+    }
+    if (outstanding_.find(client_seq_no) == outstanding_.end()) {
+      throw std::invalid_argument("No request in-flight with sequence number " + std::to_string(client_seq_no));
+    }
+    recv_pipelined();
+  }
+}
+
+std::future<std::vector<std::string>> replica_chain_client::run_command_async(const std::vector<std::string> &args) {
+  if (!event_loop_.expired()) {
+    auto promise = std::make_shared<std::promise<std::vector<std::string>>>();
+    auto future = promise->get_future();
+    send_async(args, [promise](std::vector<std::string> _return) {
+      promise->set_value(std::move(_return));
+    });
+    return future;
+  }
+  auto client_seq_no = send_command_pipelined(args);
+  auto self = shared_from_this();
+  return std::async(std::launch::deferred, [self, client_seq_no] {
+    return self->recv_response(client_seq_no);
+  });
+}
+
+std::size_t replica_chain_client::max_in_flight() const {
+  return max_in_flight_;
+}
+
+void replica_chain_client::max_in_flight(std::size_t max_in_flight) {
+  max_in_flight_ = std::max<std::size_t>(max_in_flight, 1);
+}
+
+std::size_t replica_chain_client::in_flight() const {
+  return outstanding_.size();
+}
+
+void replica_chain_client::recv_pipelined() {
+  std::vector<std::string> ret;
+  try {
+    auto rseq = response_reader_.recv_response(ret);
+    if (outstanding_.erase(rseq) == 0) {
+      LOG(log_level::warn) << "Dropping response for unknown sequence number " << rseq;
+      return;
+    }
+    completed_.emplace(rseq, std::move(ret));
+  } catch (apache::thrift::TException &e) {
+    LOG(log_level::info) << "Error in connection to chain: " << e.what();
+    fail_pipelined();
+  }
+}
+
+void replica_chain_client::fail_pipelined() {
+  // Requests in flight may or may not have been applied; let the data structure
+  // client refresh and retry them the same way it handles moved blocks
+  for (auto client_seq_no: outstanding_) {
+    completed_[client_seq_no] = {"!block_moved"};
+  }
+  outstanding_.clear();
+  try {
+    connect(fs_->resolve_failures(path_, chain_), timeout_ms_);
+  } catch (std::exception &e) {
+    LOG(log_level::warn) << "Could not reconnect to chain " << chain_.name << ": " << e.what();
+  }
+}
+
+void replica_chain_client::run_command_async(const std::vector<std::string> &args, response_callback callback) {
+  if (!event_loop_.expired()) {
+    send_async(args, std::move(callback));
+    return;
+  }
+  auto client_seq_no = send_command_pipelined(args);
+  callback(recv_response(client_seq_no));
+}
+
+void replica_chain_client::attach(std::shared_ptr<client_event_loop> event_loop) {
+  std::unique_lock<std::mutex> send_lock(send_mtx_);
+  if (event_loop_.lock() == event_loop) {
+    return;
+  }
+  std::vector<response_callback> failed;
+  {
+    std::unique_lock<std::mutex> lock(async_mtx_);
+    failed = fail_async();
+  }
+  event_loop_ = event_loop;
+  send_lock.unlock();
+  fail(failed);
+}
+
+void replica_chain_client::send_async(const std::vector<std::string> &args, response_callback callback) {
+  auto cmd_id = OPS_.id(args.front());
+  auto info = OPS_.info(cmd_id);
+  if (info == nullptr) {
+    throw std::invalid_argument("Unsupported command: " + args.front());
+  }
+  auto op = command_opcode::is_opcode(args.front()) ? args.front() : command_opcode::encode(cmd_id);
+  std::unique_lock<std::mutex> send_lock(send_mtx_);
+  std::unique_lock<std::mutex> lock(async_mtx_);
+  async_cv_.wait(lock, [&] { return async_pending_.size() < max_in_flight_ || async_fd_ < 0; });
+  if (async_fd_ < 0) {
+    lock.unlock();
+    try {
+      connect_async();
+    } catch (std::exception &e) {
+      LOG(log_level::info) << "Error in connection to chain: " << e.what();
+      send_lock.unlock();
+      callback({"!block_moved"});
+      return;
+    }
+    lock.lock();
+  }
+  auto client_seq_no = async_seq_.client_seq_no++;
+  async_pending_[client_seq_no] = std::move(callback);
+  sequence_id seq = async_seq_;
+  seq.client_seq_no = client_seq_no;
+  lock.unlock();
+  try {
+    (info->is_accessor() ? async_tail_ : async_head_).command_request(seq, op, args);
+  } catch (apache::thrift::transport::TTransportException &e) {
+    LOG(log_level::info) << "Error in connection to chain: " << e.what();
+    lock.lock();
+    auto failed = fail_async();
+    lock.unlock();
+    send_lock.unlock();
+    fail(failed);
+  }
+}
+
+void replica_chain_client::connect_async() {
+  auto event_loop = event_loop_.lock();
+  if (event_loop == nullptr) {
+    throw std::logic_error("Event loop is no longer running");
+  }
+  std::unique_lock<std::mutex> recv_lock(recv_mtx_);
+  async_head_.disconnect();
+  async_tail_.disconnect();
+  auto h = block_id_parser::parse(chain_.block_ids.front());
+  async_head_.connect(h.host, h.service_port, h.id, timeout_ms_);
+  async_seq_.client_id = async_head_.get_client_id();
+  async_seq_.client_seq_no = 0;
+  if (chain_.block_ids.size() == 1) {
+    async_tail_ = async_head_;
+  } else {
+    auto t = block_id_parser::parse(chain_.block_ids.back());
+    async_tail_.connect(t.host, t.service_port, t.id, timeout_ms_);
+  }
+  async_reader_ = async_tail_.get_command_response_reader(async_seq_.client_id);
+  std::unique_lock<std::mutex> lock(async_mtx_);
+  async_fd_ = async_tail_.socket_fd();
+  event_loop->add(async_fd_, shared_from_this());
+}
+
+void replica_chain_client::process_async_response(int fd) {
+  std::unique_lock<std::mutex> recv_lock(recv_mtx_);
+  {
+    std::unique_lock<std::mutex> lock(async_mtx_);
+    if (fd != async_fd_) {
+      return;
+    }
+  }
+  std::vector<std::string> ret;
+  int64_t rseq;
+  try {
+    rseq = async_reader_.recv_response(ret);
+  } catch (apache::thrift::TException &e) {
+    LOG(log_level::info) << "Error in connection to chain: " << e.what();
+    std::vector<response_callback> failed;
+    {
+      std::unique_lock<std::mutex> lock(async_mtx_);
+      failed = fail_async();
+    }
+    recv_lock.unlock();
+    fail(failed);
+    return;
+  }
+  std::unique_lock<std::mutex> lock(async_mtx_);
+  auto it = async_pending_.find(rseq);
+  if (it == async_pending_.end()) {
+    LOG(log_level::warn) << "Dropping response for unknown sequence number " << rseq;
+    return;
+  }
+  auto callback = std::move(it->second);
+  async_pending_.erase(it);
+  async_cv_.notify_all();
+  lock.unlock();
+  recv_lock.unlock();
+  callback(std::move(ret));
+}
+
+std::vector<replica_chain_client::response_callback> replica_chain_client::fail_async() {
+  std::vector<response_callback> failed;
+  for (auto &entry: async_pending_) {
+    failed.push_back(std::move(entry.second));
+  }
+  async_pending_.clear();
+  if (async_fd_ >= 0) {
+    if (auto event_loop = event_loop_.lock()) {
+      event_loop->remove(async_fd_);
+    }
+    async_fd_ = -1;
+  }
+  async_cv_.notify_all();
+  return failed;
+}
+
+void replica_chain_client::fail(const std::vector<response_callback> &callbacks) {
+  // As with pipelined requests, the data structure client refreshes and retries
+  for (const auto &callback: callbacks) {
+    callback({"!block_moved"});
+  }
+}
+
 void replica_chain_client::set_chain_name_metadata(std::string &name, std::string &metadata) {
   chain_.name = name;
   chain_.metadata = metadata;
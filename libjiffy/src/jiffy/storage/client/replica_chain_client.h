@@ -2,30 +2,44 @@
 #define JIFFY_REPLICA_CHAIN_CLIENT_H
 
 #include <map>
+#include <set>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
 #include "block_client.h"
+#include "client_event_loop.h"
 #include "jiffy/directory/client/directory_client.h"
 #include "jiffy/storage/command.h"
 
 namespace jiffy {
 namespace storage {
 
+/* Default maximum number of pipelined requests in flight */
+constexpr std::size_t DEFAULT_MAX_IN_FLIGHT = 64;
+
 /* Replica chain client class */
-class replica_chain_client {
+class replica_chain_client : public std::enable_shared_from_this<replica_chain_client> {
  public:
   typedef block_client *client_ref;
+  /* Callback taking the response of an asynchronous request */
+  typedef std::function<void(std::vector<std::string>)> response_callback;
   /**
    * @brief Constructor
    * @param fs Directory interface
    * @param path File path
    * @param chain Directory replica chain
+   * @param OPS Operations for the data structure
    * @param timeout_ms Timeout
+   * @param max_in_flight Maximum number of pipelined requests in flight
    */
 
   explicit replica_chain_client(std::shared_ptr<directory::directory_interface> fs,
                                 const std::string &path,
                                 const directory::replica_chain &chain,
                                 const command_map &OPS,
-                                int timeout_ms = 1000);
+                                int timeout_ms = 1000,
+                                std::size_t max_in_flight = DEFAULT_MAX_IN_FLIGHT);
 
   /**
    * @brief Destructor
@@ -81,6 +95,102 @@ class replica_chain_client {
 
   std::vector<std::string> run_command_redirected(const std::vector<std::string> &args);
 
+  /**
+   * @brief Send command without waiting for its response
+   * Both accessors and mutators are sent as sequence numbered requests, so that
+   * their responses can be matched out of order. If the window of in-flight
+   * requests is full, responses are read until a slot frees up.
+   * @param args Command arguments
+   * @return Client sequence number of the request
+   */
+
+  int64_t send_command_pipelined(const std::vector<std::string> &args);
+
+  /**
+   * @brief Receive response of a pipelined command
+   * Responses of other requests read meanwhile are kept until they are asked for
+   * @param client_seq_no Client sequence number of the request
+   * @return Response of the command
+   */
+
+  std::vector<std::string> recv_response(int64_t client_seq_no);
+
+  /**
+   * @brief Run command without waiting for its response
+   * If the client is attached to an event loop, the request is sent on a separate
+   * connection whose responses are read by the event loop, and the future becomes
+   * ready on its own. Otherwise the response is read when the future is waited on,
+   * or while later requests wait for a slot in the window.
+   * @param args Command arguments
+   * @return Future for the response of the command
+   */
+
+  std::future<std::vector<std::string>> run_command_async(const std::vector<std::string> &args);
+
+  /**
+   * @brief Run command and pass its response to a callback
+   * If the client is attached to an event loop, the callback runs on the event loop
+   * thread once the response arrives, so it must not wait on asynchronous requests.
+   * Otherwise the response is read before returning and the callback runs in the
+   * calling thread.
+   * @param args Command arguments
+   * @param callback Callback taking the response of the command
+   */
+
+  void run_command_async(const std::vector<std::string> &args, response_callback callback);
+
+  /**
+   * @brief Attach client to an event loop for asynchronous requests
+   * The connection for asynchronous requests is opened on the first request
+   * @param event_loop Event loop
+   */
+
+  void attach(std::shared_ptr<client_event_loop> event_loop);
+
+  /**
+   * @brief Read one asynchronous response and run its callback
+   * Called by the event loop when the socket is readable
+   * @param fd Socket file descriptor the event loop found readable
+   */
+
+  void process_async_response(int fd);
+
+  /**
+   * @brief Fetch maximum number of pipelined requests in flight
+   * @return Maximum number of pipelined requests in flight
+   */
+
+  std::size_t max_in_flight() const;
+
+  /**
+   * @brief Set maximum number of pipelined requests in flight
+   * @param max_in_flight Maximum number of pipelined requests in flight
+   */
+
+  void max_in_flight(std::size_t max_in_flight);
+
+  /**
+   * @brief Fetch number of pipelined requests in flight
+   * @return Number of pipelined requests in flight
+   */
+
+  std::size_t in_flight() const;
+
+  /**
+   * @brief Spread accessors over all replicas of the chain instead of sending them to the tail
+   * A replica that may hold writes the tail has not committed responds with !dirty, and the
+   * accessor is then retried at the tail. Pipelined and asynchronous accessors are always sent
+   * to the tail
+   * @param enabled Bool value, true to read from all replicas
+   */
+  void read_from_replicas(bool enabled);
+
+  /**
+   * @brief Check if accessors are spread over all replicas of the chain
+   * @return Bool value, true if accessors are read from all replicas
+   */
+  bool read_from_replicas() const;
+
   /**
    * @brief Set replica chain name and metadata
    * @param name Replica chain name
@@ -102,6 +212,61 @@ class replica_chain_client {
    */
 
   void disconnect();
+
+  /**
+   * @brief Connect to the replicas between head and tail of the chain
+   */
+  void connect_replicas();
+
+  /**
+   * @brief Fetch the block client of a replica
+   * @param i Position of the replica in the chain
+   * @return Block client
+   */
+  block_client &replica(std::size_t i);
+
+  /**
+   * @brief Read one pipelined response and keep it until it is asked for
+   */
+
+  void recv_pipelined();
+
+  /**
+   * @brief Fail all pipelined requests in flight and reconnect to the chain
+   */
+
+  void fail_pipelined();
+
+  /**
+   * @brief Send command on the event loop connection
+   * @param args Command arguments
+   * @param callback Callback taking the response of the command
+   */
+
+  void send_async(const std::vector<std::string> &args, response_callback callback);
+
+  /**
+   * @brief Open the event loop connection to the chain and start watching it
+   */
+
+  void connect_async();
+
+  /**
+   * @brief Fail all asynchronous requests in flight and stop watching the connection
+   * Caller must hold the asynchronous request mutex, and pass the callbacks of the
+   * failed requests to fail() once it is released
+   * @return Callbacks of the failed requests
+   */
+
+  std::vector<response_callback> fail_async();
+
+  /**
+   * @brief Run the callbacks of failed asynchronous requests
+   * @param callbacks Callbacks of the failed requests
+   */
+
+  static void fail(const std::vector<response_callback> &callbacks);
+
   /* Directory client */
   std::shared_ptr<directory::directory_interface> fs_;
   /* File path */
@@ -117,18 +282,61 @@ class replica_chain_client {
   block_client tail_;
   /* Command response reader */
   block_client::command_response_reader response_reader_;
-  /* Clients for each commands */
-  std::unordered_map<std::string, client_ref> cmd_client_;
   /* Bool value, true if request is in flight */
   bool in_flight_;
   /* Time out */
   int timeout_ms_;
   /* Operations for the data structure */
-  command_map OPS_;
+  command_index OPS_;
   /* Bool indicating if the command is accessor type */
   bool accessor_;
   /* Bool indicating if send run command throws an exception */
   bool send_run_command_exception_;
+
+  /* Bool value, true if accessors are spread over all replicas of the chain */
+  bool replica_reads_;
+
+  /* Block clients for the replicas between head and tail, only connected for replica reads */
+  std::vector<std::unique_ptr<block_client>> mid_;
+
+  /* Position in the chain of the replica the next accessor is sent to */
+  std::size_t next_replica_;
+
+  /* Position in the chain of the replica the accessor in flight was sent to */
+  std::size_t read_replica_;
+
+  /* Operation and arguments of the accessor in flight, to retry it at the tail */
+  std::string read_op_;
+  std::vector<std::string> read_args_;
+  /* Maximum number of pipelined requests in flight */
+  std::size_t max_in_flight_;
+  /* Client sequence numbers of pipelined requests in flight */
+  std::set<int64_t> outstanding_;
+  /* Responses of pipelined requests that have not been asked for yet */
+  std::map<int64_t, std::vector<std::string>> completed_;
+  /* Event loop reading responses of asynchronous requests
+   * Not owned, the event loop may hold the last reference to this client */
+  std::weak_ptr<client_event_loop> event_loop_;
+  /* Block client for asynchronous requests, head of the chain */
+  block_client async_head_;
+  /* Block client for asynchronous requests, tail of the chain */
+  block_client async_tail_;
+  /* Command response reader for asynchronous requests */
+  block_client::command_response_reader async_reader_;
+  /* Sequence identifier for asynchronous requests */
+  sequence_id async_seq_;
+  /* Socket watched by the event loop, -1 if none */
+  int async_fd_;
+  /* Serializes sending asynchronous requests */
+  std::mutex send_mtx_;
+  /* Serializes reading asynchronous responses with reconnecting */
+  std::mutex recv_mtx_;
+  /* Protects asynchronous requests in flight */
+  std::mutex async_mtx_;
+  /* Signalled when an asynchronous request completes */
+  std::condition_variable async_cv_;
+  /* Callbacks of asynchronous requests in flight */
+  std::map<int64_t, response_callback> async_pending_;
 };
 
 }
@@ -21,7 +21,7 @@ shared_log_client::shared_log_client(std::shared_ptr<directory::directory_interf
       last_partition_(0),
       last_offset_(0) {
   for (const auto &block: status.data_blocks()) {
-    blocks_.push_back(std::make_shared<replica_chain_client>(fs_, path_, block, SHARED_LOG_OPS, timeout_ms_));
+    blocks_.push_back(connect_chain(block, SHARED_LOG_OPS, timeout_ms_));
   }
   last_partition_ = status.data_blocks().size() - 1;
   std::vector<std::string> get_storage_capacity_args{"get_storage_capacity"};
@@ -36,30 +36,50 @@ shared_log_client::shared_log_client(std::shared_ptr<directory::directory_interf
 }
 
 int shared_log_client::scan(std::vector<std::string> &buf, const std::string &start_pos, const std::string &end_pos, const std::vector<std::string> &logical_streams) {
+  auto entries = scan_async(start_pos, end_pos, logical_streams).get();
+  buf.insert(buf.end(), std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+  return static_cast<int>(entries.size());
+}
+
+int shared_log_client::write(const std::string &position, const std::string &data_, const std::vector<std::string> &logical_streams) {
+  return write_async(position, data_, logical_streams).get();
+}
+
+bool shared_log_client::trim(const std::string &start_pos, const std::string &end_pos) {
+  return trim_async(start_pos, end_pos).get();
+}
+
+std::future<std::vector<std::string>> shared_log_client::scan_async(const std::string &start_pos,
+                                                                    const std::string &end_pos,
+                                                                    const std::vector<std::string> &logical_streams) {
   // Parallel scan here
-  std::size_t start_partition = 0;
-  std::size_t count = 0;
-  while (start_partition + count < blocks_.size()) {
-    std::vector<std::string>
-        args{"scan", start_pos, end_pos};
-    for (std::size_t i = 0; i < logical_streams.size(); i++) {
-      args.push_back(logical_streams[i]);
+  std::vector<std::pair<std::shared_ptr<replica_chain_client>, std::vector<std::string>>> requests;
+  {
+    std::unique_lock<std::recursive_mutex> lock(mtx_);
+    for (const auto &block: blocks_) {
+      std::vector<std::string>
+          args{"scan", start_pos, end_pos};
+      for (std::size_t i = 0; i < logical_streams.size(); i++) {
+        args.push_back(logical_streams[i]);
+      }
+      requests.emplace_back(block, std::move(args));
     }
-    blocks_[start_partition+count]->send_command(args);
-    count++;
   }
-  auto previous_size = buf.size();
-  for (std::size_t k = 0; k < count; k++) {
-    std::vector<std::string> resp = blocks_[start_partition + k]->recv_response();
-    for (std::size_t i = 1; i < resp.size(); i++) {
-      buf.push_back(resp[i]);
+  return async_commands<std::vector<std::string>>(requests, [](std::vector<std::vector<std::string>> &responses) {
+    std::vector<std::string> buf;
+    for (auto &resp: responses) {
+      for (std::size_t i = 1; i < resp.size(); i++) {
+        buf.push_back(std::move(resp[i]));
+      }
     }
-  }
-  auto after_size = buf.size();
-  return static_cast<int>(after_size - previous_size);
+    return buf;
+  });
 }
 
-int shared_log_client::write(const std::string &position, const std::string &data_, const std::vector<std::string> &logical_streams) {
+std::future<int> shared_log_client::write_async(const std::string &position,
+                                                const std::string &data_,
+                                                const std::vector<std::string> &logical_streams) {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   std::size_t file_size = (last_partition_ + 1) * block_size_;
   std::vector<std::string> _return;
 
@@ -71,25 +91,27 @@ int shared_log_client::write(const std::string &position, const std::string &dat
     data += logical_streams[i];
   }
   data += data_;
+  // Space an entry takes up in a partition, including its index record
+  auto entry_size = shared_log_block::entry_size(data_.size(), logical_streams.size());
 
-  if (data.size() > block_size_) {
-    return -1;
+  if (entry_size > block_size_) {
+    return ready_future(-1);
   }
 
   if (cur_partition_ * block_size_ + cur_offset_ > file_size) {
     num_chain_needed = cur_partition_ - last_partition_;
     file_size = (cur_partition_ + 1) * block_size_;
     remain_size = file_size - cur_partition_ * block_size_ - cur_offset_;
-    num_chain_needed += (data.size() - remain_size) / block_size_ + ((data.size() - remain_size) % block_size_ != 0);
+    num_chain_needed += (entry_size - remain_size) / block_size_ + ((entry_size - remain_size) % block_size_ != 0);
   } else {
     remain_size = file_size - cur_partition_ * block_size_ - cur_offset_;
-    if (remain_size < data.size()) {
-      num_chain_needed = (data.size() - remain_size) / block_size_ + ((data.size() - remain_size) % block_size_ != 0);
+    if (remain_size < entry_size) {
+      num_chain_needed = (entry_size - remain_size) / block_size_ + ((entry_size - remain_size) % block_size_ != 0);
     }
   }
 
   if (num_chain_needed && !auto_scaling_) {
-    return -1;
+    return ready_future(-1);
   }
 
   // First allocate new blocks if needed
@@ -105,10 +127,10 @@ int shared_log_client::write(const std::string &position, const std::string &dat
       try {
         for (auto x = _return.begin() + 1; x < _return.end(); x++) {
           auto chain = string_utils::split(*x, '!');
-          blocks_.push_back(std::make_shared<replica_chain_client>(fs_, path_, chain, SHARED_LOG_OPS));
+          blocks_.push_back(connect_chain(chain, SHARED_LOG_OPS));
         }
       } catch (std::exception &e) {
-        return -1;
+        return ready_future(-1);
       }
     }
   }
@@ -117,13 +139,11 @@ int shared_log_client::write(const std::string &position, const std::string &dat
     cur_offset_ = 0;
   }
   // Parallel write
-  std::size_t remaining_data = data.size();
-  std::size_t start_partition = block_id();
-  std::size_t count = 0;
+  std::size_t remaining_data = entry_size;
+  std::vector<std::pair<std::shared_ptr<replica_chain_client>, std::vector<std::string>>> requests;
 
   while (remaining_data > 0) {
-    count++;
-    if (data.size() > block_size_ - cur_offset_) {
+    if (entry_size > block_size_ - cur_offset_) {
       cur_offset_ = 0;
       cur_partition_++;
       update_last_partition();
@@ -133,43 +153,56 @@ int shared_log_client::write(const std::string &position, const std::string &dat
     for (std::size_t i = 0; i < logical_streams.size(); i++) {
       args.push_back(logical_streams[i]);
     }
-    blocks_[block_id()]->send_command(args);
-    remaining_data -= data.size();
-    cur_offset_ += data.size();
+    requests.emplace_back(blocks_[block_id()], std::move(args));
+    remaining_data -= entry_size;
+    cur_offset_ += entry_size;
     update_last_offset();
   }
 
-  for (std::size_t i = 0; i < count; i++) {
-    blocks_[start_partition + i]->recv_response();
-  }
-  return data.size();
+  lock.unlock();
 
+  auto size = static_cast<int>(data.size());
+  return async_commands<int>(requests, [size](std::vector<std::vector<std::string>> &responses) {
+    for (const auto &resp: responses) {
+      THROW_IF_NOT_OK(resp);
+    }
+    return size;
+  });
 }
 
-bool shared_log_client::trim(const std::string &start_pos, const std::string &end_pos) {
+std::future<bool> shared_log_client::trim_async(const std::string &start_pos, const std::string &end_pos) {
   // Parallel trim here
-  std::size_t start_partition = 0;
-  std::size_t count = 0;
-  while (start_partition + count < blocks_.size()) {
-    std::vector<std::string>
-        args{"trim", start_pos, end_pos};
-    blocks_[start_partition+count]->send_command(args);
-    count++;
-  }
-  for (std::size_t k = 0; k < count; k++) {
-    std::vector<std::string> resp = blocks_[start_partition + k]->recv_response();
+  std::vector<std::pair<std::shared_ptr<replica_chain_client>, std::vector<std::string>>> requests;
+  {
+    std::unique_lock<std::recursive_mutex> lock(mtx_);
+    for (const auto &block: blocks_) {
+      std::vector<std::string>
+          args{"trim", start_pos, end_pos};
+      requests.emplace_back(block, std::move(args));
+    }
   }
-  return true;
+  return async_commands<bool>(requests, [this](std::vector<std::vector<std::string>> &responses) {
+    std::unique_lock<std::recursive_mutex> lock(mtx_);
+    for (std::size_t i = 0; i < responses.size(); i++) {
+      const auto &resp = responses[i];
+      // Request i went to partition i, the space it freed is reused by later writes there
+      if (resp.size() > 2 && resp[0] == "!ok") {
+        reclaim(i, std::stoul(resp[2]));
+      }
+    }
+    return true;
+  });
 }
 
 void shared_log_client::refresh() {
+  std::unique_lock<std::recursive_mutex> lock(mtx_);
   bool redo;
   do {
     status_ = fs_->dstatus(path_);
     blocks_.clear();
     try {
       for (const auto &block: status_.data_blocks()) {
-        blocks_.push_back(std::make_shared<replica_chain_client>(fs_, path_, block, SHARED_LOG_OPS, timeout_ms_));
+        blocks_.push_back(connect_chain(block, SHARED_LOG_OPS, timeout_ms_));
       }
       redo = false;
     } catch (std::exception &e) {
@@ -5,7 +5,9 @@
 #include "jiffy/storage/client/replica_chain_client.h"
 #include "jiffy/utils/client_cache.h"
 #include "jiffy/storage/shared_log/shared_log_ops.h"
+#include "jiffy/storage/shared_log/shared_log_block.h"
 #include "jiffy/storage/client/data_structure_client.h"
+#include <algorithm>
 
 namespace jiffy {
 namespace storage {
@@ -57,6 +59,38 @@ class shared_log_client : public data_structure_client {
    */
   bool trim(const std::string &start_pos, const std::string &end_pos);
 
+  /**
+   * @brief Scan shared_log without waiting for the response
+   * @param start_pos Start position
+   * @param end_pos End position
+   * @param logical_streams Logical streams
+   * @return Future for the entries scanned
+   */
+  std::future<std::vector<std::string>> scan_async(const std::string &start_pos,
+                                                   const std::string &end_pos,
+                                                   const std::vector<std::string> &logical_streams);
+
+  /**
+   * @brief Write data to shared_log without waiting for the response
+   * @param position Position
+   * @param data_ Data
+   * @param logical_streams Logical streams
+   * @return Future for the number of bytes written, or -1 if blocks are insufficient
+   */
+  std::future<int> write_async(const std::string &position,
+                               const std::string &data_,
+                               const std::vector<std::string> &logical_streams);
+
+  /**
+   * @brief Trim shared_log without waiting for the response
+   * Space the trim frees up in a partition is handed back to the write offset of that
+   * partition once all partitions respond, so the client must outlive the request
+   * @param start_pos Start position
+   * @param end_pos End position
+   * @return Future for the trim status
+   */
+  std::future<bool> trim_async(const std::string &start_pos, const std::string &end_pos);
+
   /**
    * @brief Handle command in redirect case
    * @param _return Response to be collected
@@ -99,6 +133,18 @@ class shared_log_client : public data_structure_client {
       last_offset_ = cur_offset_;
   }
 
+  /**
+   * @brief Hand space freed by a trim back to the write offsets of its partition
+   * @param partition Partition the space was freed in
+   * @param bytes Bytes freed
+   */
+  void reclaim(std::size_t partition, std::size_t bytes) {
+    if (partition == cur_partition_)
+      cur_offset_ -= std::min(cur_offset_, bytes);
+    if (partition == last_partition_)
+      last_offset_ -= std::min(last_offset_, bytes);
+  }
+
   /* Current partition number */
   std::size_t cur_partition_;
   /* Current offset in a partition */
@@ -11,5 +11,73 @@ bool command_info::is_mutator() const {
   return type == command_type::mutator;
 }
 
+std::string command_opcode::encode(uint32_t id) {
+  return std::string(1, static_cast<char>(id));
+}
+
+std::string command_opcode::encode(uint32_t id, int32_t slot) {
+  std::string op(3, '\0');
+  op[0] = static_cast<char>(id | 0x80);
+  op[1] = static_cast<char>((slot >> 8) & 0xFF);
+  op[2] = static_cast<char>(slot & 0xFF);
+  return op;
+}
+
+bool command_opcode::is_opcode(const std::string &cmd) {
+  return cmd.size() == 1 || has_slot(cmd);
+}
+
+bool command_opcode::has_slot(const std::string &cmd) {
+  return cmd.size() == 3 && (static_cast<uint8_t>(cmd[0]) & 0x80);
+}
+
+uint32_t command_opcode::decode(const std::string &cmd) {
+  auto op = static_cast<uint8_t>(cmd[0]);
+  return has_slot(cmd) ? op & 0x7F : op;
+}
+
+int32_t command_opcode::slot(const std::string &cmd) {
+  return (static_cast<uint8_t>(cmd[1]) << 8) | static_cast<uint8_t>(cmd[2]);
+}
+
+command_index::command_index(const command_map &commands) : by_name_(commands) {
+  for (const auto &op: commands) {
+    if (op.second.id >= by_id_.size()) {
+      by_id_.resize(op.second.id + 1, {"", {command_type::accessor, UINT32_MAX}});
+    }
+    by_id_[op.second.id] = op;
+  }
+}
+
+uint32_t command_index::id(const std::string &cmd) const {
+  if (command_opcode::is_opcode(cmd)) {
+    auto id = command_opcode::decode(cmd);
+    if (id < by_id_.size() && by_id_[id].second.id == id)
+      return id;
+    return UINT32_MAX;
+  }
+  auto it = by_name_.find(cmd);
+  if (it == by_name_.end())
+    return UINT32_MAX;
+  return it->second.id;
+}
+
+const command_info *command_index::info(uint32_t id) const {
+  if (id >= by_id_.size() || by_id_[id].second.id != id)
+    return nullptr;
+  return &by_id_[id].second;
+}
+
+const std::string &command_index::name(uint32_t id) const {
+  static const std::string unknown;
+  if (id >= by_id_.size() || by_id_[id].second.id != id)
+    return unknown;
+  return by_id_[id].first;
+}
+
+bool command_index::empty() const {
+  return by_name_.empty();
+}
+
 }
 }
\ No newline at end of file
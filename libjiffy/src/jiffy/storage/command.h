@@ -5,6 +5,7 @@
 #include <cstring>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace jiffy {
 namespace storage {
@@ -41,6 +42,109 @@ struct command_info {
 
 typedef std::unordered_map<std::string, command_info> command_map;
 
+/**
+ * Command opcode
+ * A command can be named on the wire either by its full name or by a
+ * single byte opcode holding its identifier. Command names are always
+ * longer than one byte, so the two forms never collide.
+ * Key based commands may also carry the hash slot of the key computed by
+ * the client, as a three byte opcode: the identifier with its high bit set
+ * followed by the slot in big endian. Command names are plain ASCII, so
+ * this form never collides with them either.
+ */
+class command_opcode {
+ public:
+  /**
+   * @brief Encode command identifier as opcode
+   * @param id Command identifier
+   * @return Opcode string
+   */
+  static std::string encode(uint32_t id);
+
+  /**
+   * @brief Encode command identifier and key hash slot as opcode
+   * @param id Command identifier
+   * @param slot Hash slot of the command key
+   * @return Opcode string
+   */
+  static std::string encode(uint32_t id, int32_t slot);
+
+  /**
+   * @brief Check if command string is an opcode carrying a hash slot
+   * @param cmd Command string
+   * @return True if command string is an opcode carrying a hash slot, false otherwise
+   */
+  static bool has_slot(const std::string &cmd);
+
+  /**
+   * @brief Decode hash slot carried by opcode
+   * @param cmd Opcode string carrying a hash slot
+   * @return Hash slot
+   */
+  static int32_t slot(const std::string &cmd);
+
+  /**
+   * @brief Check if command string is an opcode
+   * @param cmd Command string
+   * @return True if command string is an opcode, false otherwise
+   */
+  static bool is_opcode(const std::string &cmd);
+
+  /**
+   * @brief Decode opcode into command identifier
+   * @param cmd Opcode string
+   * @return Command identifier
+   */
+  static uint32_t decode(const std::string &cmd);
+};
+
+/**
+ * Command index
+ * Resolves command names and opcodes to command information,
+ * with opcodes resolved by array indexing instead of hashing the name.
+ */
+class command_index {
+ public:
+  /**
+   * @brief Constructor
+   * @param commands Supported commands
+   */
+  explicit command_index(const command_map &commands);
+
+  /**
+   * @brief Fetch command identifier
+   * @param cmd Command name or opcode
+   * @return Command identifier, UINT32_MAX if command is not supported
+   */
+  uint32_t id(const std::string &cmd) const;
+
+  /**
+   * @brief Fetch command information
+   * @param id Command identifier
+   * @return Command information, nullptr if command is not supported
+   */
+  const command_info *info(uint32_t id) const;
+
+  /**
+   * @brief Fetch command name
+   * @param id Command identifier
+   * @return Command name, empty if command is not supported
+   */
+  const std::string &name(uint32_t id) const;
+
+  /**
+   * @brief Check if there are no supported commands
+   * @return True if there are no supported commands, false otherwise
+   */
+  bool empty() const;
+
+ private:
+  /* Commands indexed by name */
+  command_map by_name_;
+  /* Command names and information indexed by identifier */
+  std::vector<std::pair<std::string, command_info>> by_id_;
+};
+
 }
 
 }
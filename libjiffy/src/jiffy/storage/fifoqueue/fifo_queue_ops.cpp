@@ -14,6 +14,11 @@ command_map FQ_CMDS = {{"enqueue", {command_type::mutator, 0}},
                        {"length", {command_type::accessor, 8}},
                        {"in_rate", {command_type::accessor, 9}},
                        {"out_rate", {command_type::accessor, 10}},
-                       {"front", {command_type::accessor, 11}}};
+                       {"front", {command_type::accessor, 11}},
+                       {"enqueue_batch", {command_type::mutator, 12}},
+                       {"dequeue_batch", {command_type::mutator, 13}},
+                       // Waits are sent down the chain so that the tail can hold on to their responses
+                       {"dequeue_wait", {command_type::mutator, 14}},
+                       {"read_next_wait", {command_type::mutator, 15}}};
 }
 }
@@ -26,7 +26,11 @@ enum fifo_queue_cmd_id : uint32_t {
   fq_length = 8,
   fq_in_rate = 9,
   fq_out_rate = 10,
-  fq_front = 11
+  fq_front = 11,
+  fq_enqueue_batch = 12,
+  fq_dequeue_batch = 13,
+  fq_dequeue_wait = 14,
+  fq_readnext_wait = 15
 };
 
 }
@@ -4,6 +4,8 @@
 #include "jiffy/storage/fifoqueue/fifo_queue_ops.h"
 #include "jiffy/auto_scaling/auto_scaling_client.h"
 #include <jiffy/utils/directory_utils.h>
+#include <limits>
+#include <chrono>
 
 namespace jiffy {
 namespace storage {
@@ -37,7 +39,8 @@ fifo_queue_partition::fifo_queue_partition(block_memory_manager *manager,
       enqueue_start_data_size_(0),
       dequeue_start_data_size_(0),
       in_rate_set_(false),
-      out_rate_set_(false) {
+      out_rate_set_(false),
+      stop_waiters_(false) {
   ser_name_ = conf.get("fifoqueue.serializer", "csv");
   if (ser_name_ == "binary") {
     ser_ = std::make_shared<binary_serde>(binary_allocator_);
@@ -52,19 +55,27 @@ fifo_queue_partition::fifo_queue_partition(block_memory_manager *manager,
   dequeue_start_time_ = time_utils::now_us();
 }
 
+fifo_queue_partition::~fifo_queue_partition() {
+  {
+    std::unique_lock<std::mutex> lock(waiters_mtx_);
+    stop_waiters_ = true;
+  }
+  waiters_cv_.notify_all();
+  if (waiter_timer_.joinable()) {
+    waiter_timer_.join();
+  }
+}
+
 void fifo_queue_partition::enqueue(response &_return, const arg_list &args) {
   if (!(args.size() == 2 || (args.size() == 6 && args[5] == "!redirected"))) {
     RETURN_ERR("!args_error");
   }
-  if (prev_data_size_ == 0 && args.size() == 6 && args[5] == "!redirected") {
-    in_rate_ = false;
-    prev_data_size_ = std::stoul(args[2]);
-    enqueue_data_size_ += std::stoul(args[2]);
-    enqueue_time_count_ += std::stoul(args[3]);
-    enqueue_start_data_size_ = std::stoul(args[4]);
-    enqueue_start_time_ = time_utils::now_us();
+  if (args.size() == 6) {
+    redirected_enqueue_stats(args);
   }
-  auto ret = partition_.push_back(args[1]);
+  // Once an enqueue has been redirected the partition is sealed, so that
+  // pipelined enqueues arriving after it cannot overtake it
+  auto ret = enqueue_redirected_ ? std::make_pair(false, std::string()) : partition_.push_back(args[1]);
   if (!ret.first) {
     if (!auto_scale_) {
       enqueue_redirected_ = true;
@@ -91,12 +102,8 @@ void fifo_queue_partition::dequeue(response &_return, const arg_list &args) {
   if (!(args.size() == 1 || (args.size() == 4 && args[3] == "!redirected"))) {
     RETURN_ERR("!args_error");
   }
-  if (args.size() == 4 && args[3] == "!redirected" && dequeue_data_size_ == 0) {
-    out_rate_ = false;
-    dequeue_start_data_size_ = std::stoul(args[2]);
-    dequeue_time_count_ = std::stoul(args[1]);
-    dequeue_start_time_ = time_utils::now_us();
-    dequeue_data_size_ += prev_data_size_;
+  if (args.size() == 4) {
+    redirected_dequeue_stats(args);
   }
   auto ret = partition_.at(head_);
   if (ret.first) {
@@ -126,6 +133,74 @@ void fifo_queue_partition::dequeue(response &_return, const arg_list &args) {
   RETURN_ERR("!redo");
 }
 
+void fifo_queue_partition::enqueue_batch(response &_return, const arg_list &args) {
+  if (!(args.size() == 2 || (args.size() == 6 && args[5] == "!redirected")) || !string_array::is_framed(args[1])) {
+    RETURN_ERR("!args_error");
+  }
+  if (args.size() == 6) {
+    redirected_enqueue_stats(args);
+  }
+  auto ret = enqueue_redirected_ ? std::make_pair(std::size_t(0), std::size_t(0))
+                                 : partition_.push_back_framed(args[1]);
+  enqueue_data_size_ += ret.first - ret.second * string_array::METADATA_LEN;
+  if (ret.first < args[1].size()) {
+    if (!auto_scale_) {
+      enqueue_redirected_ = true;
+      RETURN_ERR("!redirected_enqueue",
+                 std::to_string(enqueue_data_size_),
+                 std::to_string(enqueue_time_count_),
+                 std::to_string(enqueue_start_data_size_),
+                 std::to_string(ret.first));
+    } else if (!next_target_str_.empty()) {
+      enqueue_redirected_ = true;
+      RETURN_ERR("!redirected_enqueue",
+                 next_target_str_,
+                 std::to_string(enqueue_data_size_),
+                 std::to_string(enqueue_time_count_),
+                 std::to_string(enqueue_start_data_size_),
+                 std::to_string(ret.first));
+    } else {
+      RETURN_ERR("!redo", std::to_string(ret.first));
+    }
+  }
+  RETURN_OK();
+}
+
+void fifo_queue_partition::dequeue_batch(response &_return, const arg_list &args) {
+  if (!(args.size() == 2 || (args.size() == 5 && args[4] == "!redirected"))) {
+    RETURN_ERR("!args_error");
+  }
+  if (args.size() == 5) {
+    redirected_dequeue_stats({args[0], args[2], args[3], args[4]});
+  }
+  auto ret = partition_.slice(head_, std::stoul(args[1]));
+  if (ret.first > 0) {
+    head_ += ret.second.size();
+    head_index_ += ret.first;
+    update_read_head();
+    update_read_head_index();
+    dequeue_data_size_ += ret.second.size() - ret.first * string_array::METADATA_LEN;
+    RETURN_OK(ret.second);
+  }
+  if (!partition_.full()) {
+    RETURN_ERR("!msg_not_found");
+  }
+  if (!auto_scale_) {
+    dequeue_redirected_ = true;
+    RETURN_ERR("!redirected_dequeue",
+               std::to_string(dequeue_time_count_),
+               std::to_string(dequeue_start_data_size_));
+  }
+  if (!next_target_str_.empty()) {
+    dequeue_redirected_ = true;
+    RETURN_ERR("!redirected_dequeue",
+               next_target_str_,
+               std::to_string(dequeue_time_count_),
+               std::to_string(dequeue_start_data_size_));
+  }
+  RETURN_ERR("!redo");
+}
+
 /* enqueue_ls() works on the index of queue elements on local storage, while enqueue() works on memory address. */
 void fifo_queue_partition::enqueue_ls(response &_return, const arg_list &args) {
   if (args.size() != 2) {
@@ -256,6 +331,29 @@ void fifo_queue_partition::read_next(response &_return, const arg_list &args) {
   RETURN_ERR("!redo");
 }
 
+void fifo_queue_partition::dequeue_wait(response &_return, const arg_list &args) {
+  if (args.size() != 2 || args[1].empty() || args[1].find_first_not_of("0123456789") != std::string::npos) {
+    RETURN_ERR("!args_error");
+  }
+  // Only the tail holds on to waits; the dequeue that follows the wake up goes down the chain as usual,
+  // and a partition that is full hands it over to the next partition
+  auto ret = partition_.at(head_);
+  if (!is_tail() || ret.first || ret.second != "!not_available") {
+    RETURN_OK();
+  }
+  RETURN_ERR("!msg_not_found");
+}
+
+void fifo_queue_partition::read_next_wait(response &_return, const arg_list &args) {
+  if (args.size() != 2 || args[1].empty() || args[1].find_first_not_of("0123456789") != std::string::npos) {
+    RETURN_ERR("!args_error");
+  }
+  if (!is_tail()) {
+    RETURN_OK();
+  }
+  read_next(_return, {"read_next"});
+}
+
 void fifo_queue_partition::read_next_ls(response &_return, const arg_list &args) {
   if (args.size() != 1) {
     RETURN_ERR("!args_error");
@@ -315,6 +413,11 @@ void fifo_queue_partition::clear(response &_return, const arg_list &args) {
 }
 
 void fifo_queue_partition::update_partition(response &_return, const arg_list &args) {
+  if (args.size() == 1) {
+    // Scaling failed before a partition was added, so the next overload asks again
+    scaling_up_ = false;
+    RETURN_OK();
+  }
   next_target(args[1]);
   RETURN_OK();
 }
@@ -387,10 +490,88 @@ void fifo_queue_partition::front(response &_return, const arg_list &args) {
   RETURN_ERR("!redo");
 }
 
+bool fifo_queue_partition::defer_response(const sequence_id &seq, const arg_list &args, const response &result) {
+  auto cmd_id = command_id(args[0]);
+  if ((cmd_id != fifo_queue_cmd_id::fq_dequeue_wait && cmd_id != fifo_queue_cmd_id::fq_readnext_wait)
+      || result.empty() || result[0] != "!msg_not_found") {
+    return false;
+  }
+  auto deadline = time_utils::now_us() + std::stoull(args[1]) * 1000;
+  std::unique_lock<std::mutex> lock(waiters_mtx_);
+  if (stop_waiters_) {
+    return false;
+  }
+  waiters_.push_back(waiter{seq, args, deadline});
+  if (!waiter_timer_.joinable()) {
+    waiter_timer_ = std::thread(&fifo_queue_partition::expire_waiters, this);
+  }
+  waiters_cv_.notify_all();
+  return true;
+}
+
+void fifo_queue_partition::wake_waiters() {
+  std::list<waiter> waiting;
+  {
+    std::unique_lock<std::mutex> lock(waiters_mtx_);
+    if (waiters_.empty()) {
+      return;
+    }
+    waiting.swap(waiters_);
+  }
+  for (auto it = waiting.begin(); it != waiting.end();) {
+    response result;
+    if (command_id(it->args[0]) == fifo_queue_cmd_id::fq_dequeue_wait) {
+      dequeue_wait(result, it->args);
+    } else {
+      read_next_wait(result, it->args);
+    }
+    if (result[0] == "!msg_not_found") {
+      ++it;
+      continue;
+    }
+    clients().respond_client(it->seq, result);
+    it = waiting.erase(it);
+  }
+  // Requests that arrived in the meantime queue up behind the ones still waiting
+  std::unique_lock<std::mutex> lock(waiters_mtx_);
+  waiters_.splice(waiters_.begin(), waiting);
+}
+
+void fifo_queue_partition::expire_waiters() {
+  std::unique_lock<std::mutex> lock(waiters_mtx_);
+  while (!stop_waiters_) {
+    if (waiters_.empty()) {
+      waiters_cv_.wait(lock);
+      continue;
+    }
+    auto now = time_utils::now_us();
+    auto next_deadline = std::numeric_limits<std::uint64_t>::max();
+    std::vector<sequence_id> expired;
+    for (auto it = waiters_.begin(); it != waiters_.end();) {
+      if (it->deadline <= now) {
+        expired.push_back(it->seq);
+        it = waiters_.erase(it);
+      } else {
+        next_deadline = std::min(next_deadline, it->deadline);
+        ++it;
+      }
+    }
+    if (expired.empty()) {
+      waiters_cv_.wait_for(lock, std::chrono::microseconds(next_deadline - now));
+      continue;
+    }
+    lock.unlock();
+    for (const auto &seq: expired) {
+      clients().respond_client(seq, {"!msg_not_found"});
+    }
+    lock.lock();
+  }
+}
+
 void fifo_queue_partition::run_command(response &_return, const arg_list &args) {
-  auto cmd_name = args[0];
+  auto cmd_id = command_id(args[0]);
   update_rate();
-  switch (command_id(cmd_name)) {
+  switch (cmd_id) {
     case fifo_queue_cmd_id::fq_enqueue:enqueue(_return, args);
       break;
     case fifo_queue_cmd_id::fq_dequeue:dequeue(_return, args);
@@ -415,15 +596,27 @@ void fifo_queue_partition::run_command(response &_return, const arg_list &args)
       break;
     case fifo_queue_cmd_id::fq_front:front(_return, args);
       break;
+    case fifo_queue_cmd_id::fq_enqueue_batch:enqueue_batch(_return, args);
+      break;
+    case fifo_queue_cmd_id::fq_dequeue_batch:dequeue_batch(_return, args);
+      break;
+    case fifo_queue_cmd_id::fq_dequeue_wait:dequeue_wait(_return, args);
+      break;
+    case fifo_queue_cmd_id::fq_readnext_wait:read_next_wait(_return, args);
+      break;
     default: {
       _return.emplace_back("!no_such_command");
       return;
     }
   }
-  if (is_mutator(cmd_name)) {
+  if (is_mutator(cmd_id) && cmd_id != fifo_queue_cmd_id::fq_dequeue_wait
+      && cmd_id != fifo_queue_cmd_id::fq_readnext_wait) {
     dirty_ = true;
   }
-  if (auto_scale_ && is_mutator(cmd_name) && overload() && is_tail() && !scaling_up_ && !scaling_down_) {
+  if ((cmd_id == fifo_queue_cmd_id::fq_enqueue || cmd_id == fifo_queue_cmd_id::fq_enqueue_batch) && is_tail()) {
+    wake_waiters();
+  }
+  if (auto_scale_ && is_mutator(cmd_id) && overload() && is_tail() && !scaling_up_ && !scaling_down_) {
     LOG(log_level::info) << "Overloaded partition: " << name() << " storage = " << storage_size() << " capacity = "
                          << storage_capacity() << " partition size = " << size() << "partition capacity "
                          << partition_.capacity();
@@ -440,7 +633,8 @@ void fifo_queue_partition::run_command(response &_return, const arg_list &args)
       LOG(log_level::warn) << "Adding new message queue partition failed: " << e.what();
     }
   }
-  if (auto_scale_ && cmd_name == "dequeue" && underload() && is_tail() && !scaling_down_
+  if (auto_scale_ && (cmd_id == fifo_queue_cmd_id::fq_dequeue || cmd_id == fifo_queue_cmd_id::fq_dequeue_batch)
+      && underload() && is_tail() && !scaling_down_
       && dequeue_redirected_ && !next_target_str_.empty()) {
     try {
       LOG(log_level::info) << "Underloaded partition: " << name() << " storage = " << storage_size() << " capacity = "
@@ -507,10 +701,8 @@ bool fifo_queue_partition::dump(const std::string &path) {
 }
 
 void fifo_queue_partition::forward_all() {
-  for (auto it = partition_.begin(); it != partition_.end(); it++) {
-    std::vector<std::string> ignore;
-    run_command_on_next(ignore, {"enqueue", *it}); // TODO: Could be more efficient
-  }
+  std::vector<std::string> ignore;
+  run_command_on_next(ignore, {"enqueue_batch", partition_.slice(0, std::numeric_limits<std::size_t>::max()).second});
 }
 
 bool fifo_queue_partition::overload() {
@@ -543,6 +735,27 @@ void fifo_queue_partition::update_rate() {
   }
 }
 
+void fifo_queue_partition::redirected_enqueue_stats(const arg_list &args) {
+  if (prev_data_size_ == 0 && args[5] == "!redirected") {
+    in_rate_ = false;
+    prev_data_size_ = std::stoul(args[2]);
+    enqueue_data_size_ += std::stoul(args[2]);
+    enqueue_time_count_ += std::stoul(args[3]);
+    enqueue_start_data_size_ = std::stoul(args[4]);
+    enqueue_start_time_ = time_utils::now_us();
+  }
+}
+
+void fifo_queue_partition::redirected_dequeue_stats(const arg_list &args) {
+  if (args[3] == "!redirected" && dequeue_data_size_ == 0) {
+    out_rate_ = false;
+    dequeue_start_data_size_ = std::stoul(args[2]);
+    dequeue_time_count_ = std::stoul(args[1]);
+    dequeue_start_time_ = time_utils::now_us();
+    dequeue_data_size_ += prev_data_size_;
+  }
+}
+
 void fifo_queue_partition::clear_partition() {
   partition_.clear();
   head_ = 0;
@@ -2,6 +2,10 @@
 #define JIFFY_FIFO_QUEUE_SERVICE_SHARD_H
 
 #include <string>
+#include <list>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <jiffy/utils/property_map.h>
 #include "../serde/serde_all.h"
 #include "jiffy/storage/partition.h"
@@ -41,7 +45,7 @@ class fifo_queue_partition : public chain_module {
   /**
    * @brief Virtual destructor
    */
-  ~fifo_queue_partition() override = default;
+  ~fifo_queue_partition() override;
 
   /**
    * @brief Fetch block size
@@ -69,6 +73,23 @@ class fifo_queue_partition : public chain_module {
    */
   void dequeue(response &_return, const arg_list &args);
 
+  /**
+   * @brief Enqueue a batch of items, framed in "length | string" format, to the fifo queue
+   * Items that do not fit are redirected to the next partition, along with the number of
+   * bytes of the batch that were enqueued
+   * @param _return Response
+   * @param args Arguments
+   */
+  void enqueue_batch(response &_return, const arg_list &args);
+
+  /**
+   * @brief Dequeue up to a number of items from the fifo queue
+   * The items are returned in "length | string" format as a single string
+   * @param _return Response
+   * @param args Arguments
+   */
+  void dequeue_batch(response &_return, const arg_list &args);
+
   /**
    * @brief Enqueue a new item to the fifo queue
    * @param item New message
@@ -97,6 +118,22 @@ class fifo_queue_partition : public chain_module {
    */
   void read_next_ls(response &_return, const arg_list &args);
 
+  /**
+   * @brief Check whether a dequeue would find an item
+   * Responds with !msg_not_found if the partition is empty, in which case the tail
+   * holds the request until an item is enqueued or the timeout expires
+   * @param _return Response
+   * @param args Arguments
+   */
+  void dequeue_wait(response &_return, const arg_list &args);
+
+  /**
+   * @brief Fetch an item without dequeue, waiting for one to be enqueued if there is none
+   * @param _return Response
+   * @param args Arguments
+   */
+  void read_next_wait(response &_return, const arg_list &args);
+
   /**
    * @brief Clear the fifo queue
    * @param _return Response
@@ -177,6 +214,15 @@ class fifo_queue_partition : public chain_module {
    */
   void forward_all() override;
 
+  /**
+   * @brief Hold back the response to a wait request that found no item
+   * @param seq Sequence identifier
+   * @param args Command arguments
+   * @param result Command result
+   * @return Bool value, true if the response is deferred
+   */
+  bool defer_response(const sequence_id &seq, const arg_list &args, const response &result) override;
+
   /**
    * @brief Set next target string
    * @param target_str Next target string
@@ -228,11 +274,43 @@ class fifo_queue_partition : public chain_module {
    */
   void update_rate();
 
+  /**
+   * @brief Pick up the enqueue statistics carried by the first enqueue redirected to this partition
+   * @param args Arguments, statistics ahead of the trailing "!redirected"
+   */
+  void redirected_enqueue_stats(const arg_list &args);
+
+  /**
+   * @brief Pick up the dequeue statistics carried by the first dequeue redirected to this partition
+   * @param args Arguments, statistics ahead of the trailing "!redirected"
+   */
+  void redirected_dequeue_stats(const arg_list &args);
+
   /**
    * @brief Clear the partition
    */
   void clear_partition();
 
+  /**
+   * @brief Retry the waiting requests after an enqueue, responding to those that found an item
+   */
+  void wake_waiters();
+
+  /**
+   * @brief Respond to waiting requests whose timeout has expired
+   */
+  void expire_waiters();
+
+  /* Request waiting for an item to be enqueued */
+  struct waiter {
+    /* Sequence identifier */
+    sequence_id seq;
+    /* Command arguments */
+    arg_list args;
+    /* Deadline in microseconds */
+    std::uint64_t deadline;
+  };
+
   /* Fifo queue partition */
   fifo_queue_type partition_;
 
@@ -326,6 +404,21 @@ class fifo_queue_partition : public chain_module {
   /* Periodicity for rate calculation in microseconds */
   std::size_t periodicity_us_;
 
+  /* Requests waiting for an item to be enqueued */
+  std::list<waiter> waiters_;
+
+  /* Waiting requests mutex */
+  std::mutex waiters_mtx_;
+
+  /* Condition variable for the earliest waiting request deadline */
+  std::condition_variable waiters_cv_;
+
+  /* Bool value, true if the waiting request timer should stop */
+  bool stop_waiters_;
+
+  /* Waiting request timer thread */
+  std::thread waiter_timer_;
+
 };
 
 }
@@ -59,6 +59,29 @@ std::pair<bool, std::string> string_array::push_back(const std::string &item) {
   }
 }
 
+std::pair<std::size_t, std::size_t> string_array::push_back_framed(const std::string &items) {
+  std::size_t pos = 0;
+  std::size_t count = 0;
+  std::size_t last = 0;
+  while (pos < items.size()) {
+    std::size_t len;
+    std::memcpy(&len, items.data() + pos, METADATA_LEN);
+    if (split_string_ || len + tail_ + pos + METADATA_LEN > max_) {
+      split_string_ = true;
+      break;
+    }
+    last = pos;
+    pos += METADATA_LEN + len;
+    count++;
+  }
+  if (count > 0) {
+    std::memcpy(data_ + tail_, items.data(), pos);
+    last_element_offset_ = tail_ + last;
+    tail_ += pos;
+  }
+  return std::make_pair(pos, count);
+}
+
 const std::pair<bool, std::string> string_array::at(std::size_t offset) const {
   if (offset > last_element_offset_ || empty()) {
     if (split_string_)
@@ -69,6 +92,21 @@ const std::pair<bool, std::string> string_array::at(std::size_t offset) const {
   return std::make_pair(true, std::string(data_ + offset + METADATA_LEN, len));
 }
 
+std::pair<std::size_t, std::string> string_array::slice(std::size_t offset, std::size_t max_count) const {
+  if (offset > last_element_offset_ || empty()) {
+    return std::make_pair(0, std::string());
+  }
+  std::size_t end = offset;
+  std::size_t count = 0;
+  while (count < max_count && end <= last_element_offset_) {
+    std::size_t len;
+    std::memcpy(&len, data_ + end, METADATA_LEN);
+    end += METADATA_LEN + len;
+    count++;
+  }
+  return std::make_pair(count, std::string(data_ + offset, end - offset));
+}
+
 std::size_t string_array::find_next(std::size_t offset) const {
   if (offset >= last_element_offset_ || offset >= tail_) return 0;
   return offset + *reinterpret_cast<size_t *>(data_ + offset) + METADATA_LEN;
@@ -119,6 +157,41 @@ bool string_array::full() const {
   return split_string_;
 }
 
+void string_array::frame(std::string &items, const std::string &item) {
+  std::size_t len = item.size();
+  items.append(reinterpret_cast<const char *>(&len), METADATA_LEN);
+  items.append(item);
+}
+
+bool string_array::is_framed(const std::string &items) {
+  std::size_t pos = 0;
+  while (pos < items.size()) {
+    if (items.size() - pos < METADATA_LEN) {
+      return false;
+    }
+    std::size_t len;
+    std::memcpy(&len, items.data() + pos, METADATA_LEN);
+    if (len > items.size() - pos - METADATA_LEN) {
+      return false;
+    }
+    pos += METADATA_LEN + len;
+  }
+  return true;
+}
+
+std::vector<std::string> string_array::unframe(const std::string &items) {
+  std::vector<std::string> out;
+  std::size_t pos = 0;
+  while (pos + METADATA_LEN <= items.size()) {
+    std::size_t len;
+    std::memcpy(&len, items.data() + pos, METADATA_LEN);
+    pos += METADATA_LEN;
+    out.emplace_back(items, pos, len);
+    pos += len;
+  }
+  return out;
+}
+
 string_array_iterator::string_array_iterator(string_array &impl, std::size_t pos)
     : impl_(impl),
       pos_(pos) {}
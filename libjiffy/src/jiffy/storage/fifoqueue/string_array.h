@@ -80,6 +80,15 @@ class string_array {
    */
   std::pair<bool, std::string> push_back(const std::string &item);
 
+  /**
+   * @brief Push a batch of messages, framed in "length | string" format, at the end of the array
+   * The longest prefix of complete messages that fits is copied at once; if any message does
+   * not fit, the array is marked full
+   * @param items Framed messages
+   * @return Pair, the number of bytes and the number of messages written
+   */
+  std::pair<std::size_t, std::size_t> push_back_framed(const std::string &items);
+
   /**
    * @brief Read string at offset
    * @param offset Read offset
@@ -87,6 +96,14 @@ class string_array {
    */
   const std::pair<bool, std::string> at(std::size_t offset) const;
 
+  /**
+   * @brief Read consecutive strings starting at offset, in "length | string" format
+   * @param offset Read offset
+   * @param max_count Maximum number of strings
+   * @return Pair, the number of strings read and the framed strings
+   */
+  std::pair<std::size_t, std::string> slice(std::size_t offset, std::size_t max_count) const;
+
   /**
    * @brief Find next string for the given offset string
    * @param offset Offset of the current string
@@ -165,6 +182,27 @@ class string_array {
    */
   std::size_t num_elements() const;
 
+  /**
+   * @brief Append a message to a batch in "length | string" format
+   * @param items Framed messages
+   * @param item Message
+   */
+  static void frame(std::string &items, const std::string &item);
+
+  /**
+   * @brief Check if a batch consists of complete framed messages
+   * @param items Framed messages
+   * @return Boolean, true if well formed
+   */
+  static bool is_framed(const std::string &items);
+
+  /**
+   * @brief Split a batch in "length | string" format into messages
+   * @param items Framed messages
+   * @return Messages
+   */
+  static std::vector<std::string> unframe(const std::string &items);
+
  private:
   /* Block memory allocator */
   block_memory_allocator<char> alloc_;
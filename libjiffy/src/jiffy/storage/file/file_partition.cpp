@@ -154,6 +154,9 @@ void file_partition::update_partition(response &_return, const arg_list &args) {
   if (args.size() >= 2) {
     block_allocated_ = true;
     allocated_blocks_.insert(allocated_blocks_.end(), args.begin() + 1, args.end());
+  } else {
+    // Scaling failed before any block was added, the next add_blocks asks again
+    scaling_up_ = false;
   }
   RETURN_OK();
 }
@@ -189,8 +192,8 @@ void file_partition::get_storage_capacity(response &_return, const arg_list &arg
 }
 
 void file_partition::run_command(response &_return, const arg_list &args) {
-  auto cmd_name = args[0];
-  switch (command_id(cmd_name)) {
+  auto cmd_id = command_id(args[0]);
+  switch (cmd_id) {
     case file_cmd_id::file_write:write(_return, args);
       break;
     case file_cmd_id::file_read:read(_return, args);
@@ -212,7 +215,7 @@ void file_partition::run_command(response &_return, const arg_list &args) {
       return;
     }
   }
-  if (is_mutator(cmd_name)) {
+  if (is_mutator(cmd_id)) {
     dirty_ = true;
   }
 }
@@ -4,7 +4,7 @@
 namespace jiffy {
 namespace storage {
 
-const uint16_t hash_slot::crc16tab[256] = {
+static const uint16_t crc16tab[256] = {
     0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
     0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
     0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
@@ -39,5 +39,19 @@ const uint16_t hash_slot::crc16tab[256] = {
     0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0
 };
 
+hash_slot::crc16_tables::crc16_tables() {
+  for (int b = 0; b < 256; ++b) {
+    t[0][b] = crc16tab[b];
+  }
+  // Appending a zero byte to the input advances the CRC by one table step
+  for (int k = 1; k < 8; ++k) {
+    for (int b = 0; b < 256; ++b) {
+      t[k][b] = static_cast<uint16_t>((t[k - 1][b] << 8) ^ crc16tab[t[k - 1][b] >> 8]);
+    }
+  }
+}
+
+const hash_slot::crc16_tables hash_slot::crc16tabs;
+
 }
 }
@@ -45,6 +45,8 @@
 #define JIFFY_HASH_SLOT_H
 
 #include <string>
+#include <vector>
+#include "jiffy/storage/command.h"
 #include "jiffy/storage/types/binary.h"
 
 namespace jiffy {
@@ -62,18 +64,46 @@ class hash_slot {
   static int32_t get(const binary &key) {
     return crc16(reinterpret_cast<const char *>(key.data()), key.size());
   }
+
+  /* Return hash number carried by the command opcode, computing it from the key if absent */
+  static int32_t get(const std::string &cmd, const std::string &key) {
+    return command_opcode::has_slot(cmd) ? command_opcode::slot(cmd) : get(key);
+  }
+
+  /* Return names of the partitions that split all hash slots evenly into num_ranges slot ranges */
+  static std::vector<std::string> slot_ranges(int32_t num_ranges) {
+    std::vector<std::string> names;
+    int32_t slot_range = MAX / num_ranges;
+    for (int32_t i = 0; i < num_ranges; ++i) {
+      int32_t begin = i * slot_range;
+      int32_t end = (i == num_ranges - 1) ? MAX : (i + 1) * slot_range;
+      names.push_back(std::to_string(begin) + "_" + std::to_string(end));
+    }
+    return names;
+  }
+
  private:
-  /* Hash function */
+  /* Hash function, slicing-by-8: eight input bytes per step through eight tables */
   static uint16_t crc16(const char *buf, size_t len) {
-    size_t counter;
+    auto p = reinterpret_cast<const uint8_t *>(buf);
+    const auto &t = crc16tabs.t;
     uint16_t crc = 0;
-    for (counter = 0; counter < len; counter++)
-      crc = (crc << 8) ^ crc16tab[((crc >> 8) ^ *buf++) & 0x00FF];
+    for (; len >= 8; len -= 8, p += 8) {
+      crc = t[7][(crc >> 8) ^ p[0]] ^ t[6][(crc & 0x00FF) ^ p[1]] ^ t[5][p[2]] ^ t[4][p[3]]
+          ^ t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+    }
+    for (; len > 0; --len)
+      crc = (crc << 8) ^ t[0][((crc >> 8) ^ *p++) & 0x00FF];
     return crc;
   }
 
-  /* Hash function table */
-  static const uint16_t crc16tab[256];
+  /* Hash function tables, t[k][b] is the CRC of byte b followed by k zero bytes */
+  struct crc16_tables {
+    crc16_tables();
+    uint16_t t[8][256];
+  };
+
+  static const crc16_tables crc16tabs;
 
 };
 
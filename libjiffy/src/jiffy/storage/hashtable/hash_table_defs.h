@@ -2,10 +2,17 @@
 #define JIFFY_KV_HASH_H
 
 #include <functional>
+#include <stdexcept>
 #include "libcuckoo/cuckoohash_map.hh"
 #include "jiffy/storage/block_memory_allocator.h"
 #include "jiffy/storage/types/binary.h"
+#include "jiffy/utils/hash_utils.h"
+#include "jiffy/utils/rate_limiter.h"
+#include "open_hash_table.h"
 #include <unordered_map>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace jiffy {
 namespace storage {
@@ -25,11 +32,7 @@ typedef std::pair<const key_type, value_type> kv_pair_type;
 struct hash_type {
   template<typename KeyType>
   std::size_t operator()(const KeyType &k) const {
-    std::size_t result = 0;
-    for (size_t i = 0; i < k.size(); i++) {
-      result = k[i] + (result * 31);
-    }
-    return result;
+    return static_cast<std::size_t>(utils::hash_utils::hash(k.data(), k.size()));
   }
 };
 
@@ -40,8 +43,345 @@ struct equal_type {
   }
 };
 
-// Hash table definitions
-typedef std::unordered_map<key_type, value_type, hash_type, equal_type> hash_table_type;
+// Hash table index implementations
+enum hash_table_index_type : int {
+  unordered_map_index = 0,
+  open_addressing_index = 1
+};
+
+/* Hash table class
+ * Dispatches to the index implementation selected at construction:
+ * a node based std::unordered_map, or an open addressing table with
+ * inline hash fragments and entries in contiguous chunks */
+class hash_table_type {
+ public:
+  typedef std::unordered_map<key_type, value_type, hash_type, equal_type> chained_table;
+  typedef open_hash_table<key_type, value_type, hash_type, equal_type, block_memory_allocator<uint8_t>> open_table;
+  typedef std::size_t size_type;
+
+  /* Iterator over key value pairs */
+  template<bool Const>
+  class iterator_base {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef kv_pair_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef typename std::conditional<Const, const kv_pair_type, kv_pair_type>::type &reference;
+    typedef typename std::conditional<Const, const kv_pair_type, kv_pair_type>::type *pointer;
+    typedef typename std::conditional<Const,
+                                      chained_table::const_iterator,
+                                      chained_table::iterator>::type chained_iterator;
+    typedef typename std::conditional<Const,
+                                      open_table::const_iterator,
+                                      open_table::iterator>::type open_iterator;
+
+    iterator_base() : open_(false) {}
+
+    explicit iterator_base(chained_iterator it) : open_(false), chained_(it) {}
+
+    explicit iterator_base(open_iterator it) : open_(true), open_it_(it) {}
+
+    template<bool C, typename = typename std::enable_if<Const && !C>::type>
+    iterator_base(const iterator_base<C> &other)
+        : open_(other.open_), chained_(other.chained_), open_it_(other.open_it_) {}
+
+    reference operator*() const {
+      return open_ ? *open_it_ : *chained_;
+    }
+
+    pointer operator->() const {
+      return &(**this);
+    }
+
+    iterator_base &operator++() {
+      if (open_) {
+        ++open_it_;
+      } else {
+        ++chained_;
+      }
+      return *this;
+    }
+
+    iterator_base operator++(int) {
+      auto it = *this;
+      ++(*this);
+      return it;
+    }
+
+    bool operator==(const iterator_base &other) const {
+      return open_ ? open_it_ == other.open_it_ : chained_ == other.chained_;
+    }
+
+    bool operator!=(const iterator_base &other) const {
+      return !(*this == other);
+    }
+
+   private:
+    template<bool C> friend
+    class iterator_base;
+
+    bool open_;
+    chained_iterator chained_;
+    open_iterator open_it_;
+  };
+
+  typedef iterator_base<false> iterator;
+  typedef iterator_base<true> const_iterator;
+
+  /**
+   * @brief Constructor
+   * @param type Index implementation
+   * @param allocator Allocator for the open addressing index, required when it is used
+   */
+  explicit hash_table_type(hash_table_index_type type = unordered_map_index,
+                           const block_memory_allocator<uint8_t> &allocator = block_memory_allocator<uint8_t>())
+      : type_(type), open_(allocator) {}
+
+  /**
+   * @brief Fetch index implementation
+   * @return Index implementation
+   */
+  hash_table_index_type index_type() const {
+    return type_;
+  }
+
+  iterator begin() {
+    return type_ == open_addressing_index ? iterator(open_.begin()) : iterator(chained_.begin());
+  }
+
+  iterator end() {
+    return type_ == open_addressing_index ? iterator(open_.end()) : iterator(chained_.end());
+  }
+
+  const_iterator begin() const {
+    return type_ == open_addressing_index ? const_iterator(open_.begin()) : const_iterator(chained_.begin());
+  }
+
+  const_iterator end() const {
+    return type_ == open_addressing_index ? const_iterator(open_.end()) : const_iterator(chained_.end());
+  }
+
+  iterator find(const key_type &key) {
+    return type_ == open_addressing_index ? iterator(open_.find(key)) : iterator(chained_.find(key));
+  }
+
+  const_iterator find(const key_type &key) const {
+    return type_ == open_addressing_index ? const_iterator(open_.find(key)) : const_iterator(chained_.find(key));
+  }
+
+  /**
+   * @brief Fetch value for key
+   * @param key Key
+   * @return Value
+   * @throws std::out_of_range if the key does not exist
+   */
+  value_type &at(const key_type &key) {
+    auto it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("Key does not exist");
+    }
+    return it->second;
+  }
+
+  const value_type &at(const key_type &key) const {
+    auto it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("Key does not exist");
+    }
+    return it->second;
+  }
+
+  template<typename... Args>
+  std::pair<iterator, bool> emplace(Args &&... args) {
+    if (type_ == open_addressing_index) {
+      auto ret = open_.emplace(std::forward<Args>(args)...);
+      return std::make_pair(iterator(ret.first), ret.second);
+    }
+    auto ret = chained_.emplace(std::forward<Args>(args)...);
+    return std::make_pair(iterator(ret.first), ret.second);
+  }
+
+  size_type erase(const key_type &key) {
+    return type_ == open_addressing_index ? open_.erase(key) : chained_.erase(key);
+  }
+
+  void reserve(size_type n) {
+    if (type_ == open_addressing_index) {
+      open_.reserve(n);
+    } else {
+      chained_.reserve(n);
+    }
+  }
+
+  void clear() {
+    open_.clear();
+    chained_.clear();
+  }
+
+  size_type size() const {
+    return type_ == open_addressing_index ? open_.size() : chained_.size();
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  /**
+   * @brief Fetch number of buckets, the positions a scan walks through
+   * @return Number of buckets
+   */
+  size_type bucket_count() const {
+    return type_ == open_addressing_index ? open_.slot_count() : chained_.bucket_count();
+  }
+
+  /**
+   * @brief Visit entries bucket by bucket, starting at a bucket
+   * A scan can be resumed after the table is modified, but entries that move
+   * behind the resume position meanwhile (when the table grows, or for open
+   * addressing when a nearby entry is erased) are not visited
+   * @param pos First bucket to visit
+   * @param f Visitor called with each entry, returns false to stop the scan once the bucket is visited
+   * @return Bucket to resume the scan at, bucket_count() once all buckets have been visited
+   */
+  template<typename F>
+  size_type scan(size_type pos, F &&f) const {
+    if (type_ == open_addressing_index) {
+      return open_.scan(pos, f);
+    }
+    for (; pos < chained_.bucket_count(); ++pos) {
+      bool more = true;
+      for (auto it = chained_.begin(pos); it != chained_.end(pos); ++it) {
+        more = f(*it) && more;
+      }
+      if (!more) {
+        return pos + 1;
+      }
+    }
+    return chained_.bucket_count();
+  }
+
+  /**
+   * @brief Estimate bytes used by the index, excluding memory owned by keys and values
+   * @return Bytes used
+   */
+  size_type footprint() const {
+    if (type_ == open_addressing_index) {
+      return open_.footprint();
+    }
+    // One node per entry holding the pair, the next pointer and the cached hash
+    return chained_.bucket_count() * sizeof(void *)
+        + chained_.size() * (sizeof(kv_pair_type) + sizeof(void *) + sizeof(std::size_t));
+  }
+
+ private:
+  /* Index implementation */
+  hash_table_index_type type_;
+  /* Node based index */
+  chained_table chained_;
+  /* Open addressing index */
+  open_table open_;
+};
+
+/* Point-in-time copy of a hash table, written to persistent storage while mutators go on
+ * Entries are copied to the block's memory, so that the copy counts towards the block's usage and
+ * the table can keep changing, and iterating over them is paced by a rate limiter, which paces
+ * the writes of the serializer */
+class hash_table_snapshot_type {
+ public:
+  typedef std::pair<key_type, value_type> entry_type;
+  typedef std::vector<entry_type, block_memory_allocator<entry_type>> entry_list;
+
+  /* Iterator over copied key value pairs */
+  class const_iterator {
+   public:
+    const_iterator(entry_list::const_iterator it, utils::rate_limiter *limiter) : it_(it), limiter_(limiter) {}
+
+    const entry_type &operator*() const {
+      return *it_;
+    }
+
+    const entry_type *operator->() const {
+      return &(*it_);
+    }
+
+    const_iterator &operator++() {
+      limiter_->acquire(it_->first.size() + it_->second.size());
+      ++it_;
+      return *this;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return it_ == other.it_;
+    }
+
+    bool operator!=(const const_iterator &other) const {
+      return it_ != other.it_;
+    }
+
+   private:
+    /* Position in the copied entries */
+    entry_list::const_iterator it_;
+    /* Rate limiter */
+    utils::rate_limiter *limiter_;
+  };
+
+  /**
+   * @brief Constructor, copies the table
+   * Throws memory_block_overflow if the copy takes more than max_bytes or does not fit in the block
+   * @param table Hash table
+   * @param allocator Block memory allocator for the copy
+   * @param max_bytes Maximum number of bytes the copy may take
+   * @param bytes_per_sec Number of bytes per second to write, 0 for no limit
+   */
+  hash_table_snapshot_type(const hash_table_type &table,
+                           const block_memory_allocator<uint8_t> &allocator,
+                           std::size_t max_bytes,
+                           std::size_t bytes_per_sec)
+      : entries_(block_memory_allocator<entry_type>(allocator)),
+        limiter_(bytes_per_sec) {
+    std::size_t bytes = table.size() * sizeof(entry_type);
+    for (const auto &e: table) {
+      bytes += e.first.size() + e.second.size();
+    }
+    if (bytes > max_bytes) {
+      throw memory_block_overflow();
+    }
+    entries_.reserve(table.size());
+    for (const auto &e: table) {
+      entries_.emplace_back(key_type(e.first, allocator), value_type(e.second, allocator));
+    }
+  }
+
+  const_iterator begin() const {
+    return const_iterator(entries_.begin(), &limiter_);
+  }
+
+  const_iterator end() const {
+    return const_iterator(entries_.end(), &limiter_);
+  }
+
+  std::size_t size() const {
+    return entries_.size();
+  }
+
+ private:
+  /* Copied key value pairs */
+  entry_list entries_;
+  /* Rate limiter for writing the copy */
+  mutable utils::rate_limiter limiter_;
+};
+
+/* Changes to a hash table since it was last persisted, keyed by the snapshot they apply to */
+struct hash_table_delta_type {
+  /* Epoch of the snapshot the changes apply to */
+  uint64_t epoch = 0;
+  /* Inserted or updated key value pairs */
+  std::vector<std::pair<std::string, std::string>> upserts;
+  /* Removed keys */
+  std::vector<std::string> removes;
+  /* Bool value, true if the delta was found in persistent storage */
+  bool found = false;
+};
 
 }
 }
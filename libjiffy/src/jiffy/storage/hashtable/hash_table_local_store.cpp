@@ -0,0 +1,407 @@
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <unistd.h>
+#include "hash_table_local_store.h"
+#include "jiffy/utils/logger.h"
+
+namespace jiffy {
+namespace storage {
+
+using namespace utils;
+
+/* Log record operations */
+static const char LOG_PUT = 'P';
+static const char LOG_REMOVE = 'R';
+
+/* Log record header size, excluding the key */
+static const uint64_t LOG_HEADER_SIZE = 1 + 2 * sizeof(std::size_t);
+
+hash_table_local_store::hash_table_local_store(const std::string &path,
+                                               const std::string &ser_name,
+                                               std::size_t min_compaction_bytes)
+    : path_(path),
+      ser_name_(ser_name),
+      min_compaction_bytes_(min_compaction_bytes),
+      table_segment_(0),
+      log_segment_(0),
+      next_segment_(0),
+      table_size_(0),
+      log_size_(0),
+      sealed_segment_(0),
+      compacting_(false),
+      compaction_failed_(false) {}
+
+hash_table_local_store::~hash_table_local_store() {
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    compaction_done_.wait(lock, [&] { return !compacting_; });
+  }
+  if (compactor_.joinable()) {
+    compactor_.join();
+  }
+}
+
+bool hash_table_local_store::open() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  if (std::ifstream(data_path(".compact_commit"))) {
+    // A compaction wrote its table files but did not finish installing them
+    if (ser_name_ != "csv" && std::ifstream(data_path(".compact_offset"))) {
+      std::rename(data_path(".compact_offset").c_str(), data_path("_offset").c_str());
+    }
+    if (std::ifstream(data_path(".compact"))) {
+      std::rename(data_path(".compact").c_str(), path_.c_str());
+    }
+    std::remove(data_path("_log.old").c_str());
+    std::remove(data_path(".compact_commit").c_str());
+  }
+  // Leftovers of a compaction that did not commit
+  std::remove(data_path(".compact").c_str());
+  std::remove(data_path(".compact_offset").c_str());
+  table_segment_ = next_segment_++;
+  if (!load_table()) {
+    return false;
+  }
+  auto log_path = data_path("_log");
+  auto sealed_path = data_path("_log.old");
+  if (std::ifstream(sealed_path)) {
+    // The sealed log was not folded in yet; it precedes the active log
+    {
+      std::ofstream out(sealed_path, std::ios::binary | std::ios::app);
+      std::ifstream in(log_path, std::ios::binary);
+      if (in && in.peek() != EOF) {
+        out << in.rdbuf();
+      }
+    }
+    std::rename(sealed_path.c_str(), log_path.c_str());
+  }
+  log_out_.open(log_path, std::ios::binary | std::ios::app);
+  log_segment_ = next_segment_++;
+  log_size_ = load_log(log_path, log_segment_);
+  return true;
+}
+
+const std::string &hash_table_local_store::path() const {
+  return path_;
+}
+
+bool hash_table_local_store::exists(const std::string &key) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  return index_.find(key) != index_.end();
+}
+
+bool hash_table_local_store::get(const std::string &key, std::string &value) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return false;
+  }
+  value = read(it->second);
+  return true;
+}
+
+bool hash_table_local_store::put(const std::string &key, const std::string &value) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  if (index_.find(key) != index_.end()) {
+    return false;
+  }
+  append(key, value, false);
+  maybe_compact();
+  return true;
+}
+
+void hash_table_local_store::upsert(const std::string &key, const std::string &value) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  append(key, value, false);
+  maybe_compact();
+}
+
+bool hash_table_local_store::update(const std::string &key, const std::string &value) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  if (index_.find(key) == index_.end()) {
+    return false;
+  }
+  append(key, value, false);
+  maybe_compact();
+  return true;
+}
+
+bool hash_table_local_store::remove(const std::string &key) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  if (index_.find(key) == index_.end()) {
+    return false;
+  }
+  append(key, "", true);
+  maybe_compact();
+  return true;
+}
+
+void hash_table_local_store::compact() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  compaction_done_.wait(lock, [&] { return !compacting_; });
+  if (!compaction_failed_ && log_size_ == 0) {
+    return;
+  }
+  start_compaction();
+  compaction_done_.wait(lock, [&] { return !compacting_; });
+}
+
+bool hash_table_local_store::has_log(const std::string &path) {
+  std::ifstream log_in(path + "_log", std::ios::binary | std::ios::ate);
+  return (log_in && log_in.tellg() > 0) || static_cast<bool>(std::ifstream(path + "_log.old"))
+      || static_cast<bool>(std::ifstream(path + ".compact_commit"));
+}
+
+void hash_table_local_store::clear(const std::string &path) {
+  std::remove((path + "_log").c_str());
+  std::remove((path + "_log.old").c_str());
+  // A compaction that was not installed must not replace the rewritten table file
+  std::remove((path + ".compact_commit").c_str());
+  std::remove((path + ".compact").c_str());
+  std::remove((path + ".compact_offset").c_str());
+}
+
+bool hash_table_local_store::load_table() {
+  std::ifstream in(path_, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  uint64_t offset = 0;
+  if (ser_name_ == "csv") {
+    std::string line;
+    while (std::getline(in, line)) {
+      auto split_index = line.find(',');
+      if (split_index != std::string::npos) {
+        // Earlier lines win, as they did for the linear scan
+        index_.emplace(line.substr(0, split_index),
+                       location{table_segment_, offset + split_index + 1, line.size() - split_index - 1});
+      }
+      offset += line.size() + 1;
+    }
+  } else {
+    std::ifstream offset_in(data_path("_offset"), std::ios::binary);
+    if (!offset_in) {
+      return false;
+    }
+    std::size_t key_size = 0;
+    std::size_t value_size = 0;
+    std::string key;
+    while (offset_in.peek() != EOF) {
+      offset_in.read(reinterpret_cast<char *>(&key_size), sizeof(key_size));
+      key.resize(key_size);
+      offset_in.read(&key[0], key_size);
+      offset_in.read(reinterpret_cast<char *>(&value_size), sizeof(value_size));
+      if (!offset_in) {
+        break;
+      }
+      index_.emplace(key, location{table_segment_, offset, value_size});
+      offset += value_size;
+    }
+  }
+  table_size_ = offset;
+  in.close();
+  readers_[table_segment_] = std::unique_ptr<std::ifstream>(new std::ifstream(path_, std::ios::binary));
+  return true;
+}
+
+uint64_t hash_table_local_store::load_log(const std::string &log_path, uint32_t segment) {
+  std::ifstream in(log_path, std::ios::binary | std::ios::ate);
+  auto file_size = static_cast<uint64_t>(std::max<std::streamoff>(in.tellg(), 0));
+  in.seekg(0, std::ios::beg);
+  uint64_t offset = 0;
+  std::string key;
+  while (offset + LOG_HEADER_SIZE <= file_size) {
+    char op = 0;
+    std::size_t key_size = 0;
+    std::size_t value_size = 0;
+    in.read(&op, 1);
+    in.read(reinterpret_cast<char *>(&key_size), sizeof(key_size));
+    if (!in || (op != LOG_PUT && op != LOG_REMOVE) || offset + LOG_HEADER_SIZE + key_size > file_size) {
+      break;
+    }
+    key.resize(key_size);
+    in.read(&key[0], key_size);
+    in.read(reinterpret_cast<char *>(&value_size), sizeof(value_size));
+    auto value_offset = offset + LOG_HEADER_SIZE + key_size;
+    if (!in || value_offset + value_size > file_size) {
+      break;
+    }
+    in.seekg(static_cast<std::streamoff>(value_offset + value_size), std::ios::beg);
+    if (op == LOG_PUT) {
+      index_[key] = location{segment, value_offset, value_size};
+    } else {
+      index_.erase(key);
+    }
+    offset = value_offset + value_size;
+  }
+  in.close();
+  if (offset < file_size) {
+    LOG(log_level::warn) << "Truncating partially written record at " << offset << " in " << log_path;
+    if (truncate(log_path.c_str(), static_cast<off_t>(offset)) != 0) {
+      throw std::runtime_error("Could not truncate " + log_path);
+    }
+  }
+  readers_[segment] = std::unique_ptr<std::ifstream>(new std::ifstream(log_path, std::ios::binary));
+  return offset;
+}
+
+void hash_table_local_store::append(const std::string &key, const std::string &value, bool removal) {
+  char op = removal ? LOG_REMOVE : LOG_PUT;
+  std::size_t key_size = key.size();
+  std::size_t value_size = removal ? 0 : value.size();
+  log_out_.write(&op, 1);
+  log_out_.write(reinterpret_cast<const char *>(&key_size), sizeof(key_size));
+  log_out_.write(key.data(), key_size);
+  log_out_.write(reinterpret_cast<const char *>(&value_size), sizeof(value_size));
+  log_out_.write(value.data(), value_size);
+  log_out_.flush();
+  if (!log_out_) {
+    throw std::runtime_error("Could not append to " + data_path("_log"));
+  }
+  auto value_offset = log_size_ + LOG_HEADER_SIZE + key_size;
+  log_size_ = value_offset + value_size;
+  if (removal) {
+    index_.erase(key);
+  } else {
+    index_[key] = location{log_segment_, value_offset, value_size};
+  }
+}
+
+std::string hash_table_local_store::read(const location &loc) {
+  auto &in = *readers_.at(loc.segment);
+  in.clear();
+  in.seekg(static_cast<std::streamoff>(loc.offset), std::ios::beg);
+  std::string value(loc.size, '\0');
+  in.read(&value[0], loc.size);
+  return value;
+}
+
+void hash_table_local_store::maybe_compact() {
+  if (!compacting_ && log_size_ >= std::max<uint64_t>(min_compaction_bytes_, table_size_)) {
+    start_compaction();
+  }
+}
+
+void hash_table_local_store::start_compaction() {
+  if (compactor_.joinable()) {
+    compactor_.join();
+  }
+  if (!compaction_failed_) {
+    auto log_path = data_path("_log");
+    log_out_.close();
+    std::rename(log_path.c_str(), data_path("_log.old").c_str());
+    // The sealed log keeps its reader and segment; new writes go to a fresh log
+    sealed_segment_ = log_segment_;
+    log_segment_ = next_segment_++;
+    log_out_.open(log_path, std::ios::binary | std::ios::trunc);
+    readers_[log_segment_] = std::unique_ptr<std::ifstream>(new std::ifstream(log_path, std::ios::binary));
+    log_size_ = 0;
+  }
+  // A retry folds in the sealed log left by the failed compaction; keys written to the active
+  // log since then stay out of the table file, the active log is replayed on top of it
+  index_type snapshot;
+  for (const auto &entry: index_) {
+    if (entry.second.segment != log_segment_) {
+      snapshot.insert(entry);
+    }
+  }
+  compaction_failed_ = false;
+  compacting_ = true;
+  compactor_ = std::thread(&hash_table_local_store::run_compaction, this, std::move(snapshot), table_segment_,
+                           sealed_segment_, next_segment_++);
+}
+
+void hash_table_local_store::run_compaction(index_type snapshot,
+                                            uint32_t old_table,
+                                            uint32_t sealed_log,
+                                            uint32_t new_table) {
+  std::vector<location> new_locations;
+  new_locations.reserve(snapshot.size());
+  uint64_t offset = 0;
+  bool failed = false;
+  try {
+    std::ifstream table_in(path_, std::ios::binary);
+    std::ifstream log_in(data_path("_log.old"), std::ios::binary);
+    std::ofstream out(data_path(".compact"), std::ios::binary | std::ios::trunc);
+    std::ofstream offset_out;
+    if (ser_name_ != "csv") {
+      offset_out.open(data_path(".compact_offset"), std::ios::binary | std::ios::trunc);
+    }
+    std::string value;
+    for (const auto &entry: snapshot) {
+      auto &in = entry.second.segment == old_table ? table_in : log_in;
+      value.resize(entry.second.size);
+      in.seekg(static_cast<std::streamoff>(entry.second.offset), std::ios::beg);
+      in.read(&value[0], entry.second.size);
+      if (!in) {
+        throw std::runtime_error("Could not read value of " + entry.first);
+      }
+      if (ser_name_ == "csv") {
+        out << entry.first << "," << value << "\n";
+        new_locations.push_back(location{new_table, offset + entry.first.size() + 1, value.size()});
+        offset += entry.first.size() + value.size() + 2;
+      } else {
+        std::size_t key_size = entry.first.size();
+        std::size_t value_size = value.size();
+        offset_out.write(reinterpret_cast<const char *>(&key_size), sizeof(size_t));
+        offset_out.write(entry.first.data(), key_size);
+        offset_out.write(reinterpret_cast<const char *>(&value_size), sizeof(size_t));
+        out.write(value.data(), value_size);
+        new_locations.push_back(location{new_table, offset, value_size});
+        offset += value_size;
+      }
+    }
+    out.close();
+    offset_out.close();
+    if (!out || (ser_name_ != "csv" && !offset_out)) {
+      throw std::runtime_error("Could not write " + data_path(".compact"));
+    }
+    // Creating the commit marker is the single step that commits the new table files;
+    // open() finishes installing them if the renames below are interrupted
+    std::ofstream commit(data_path(".compact_commit"), std::ios::binary | std::ios::trunc);
+    if (!commit) {
+      throw std::runtime_error("Could not write " + data_path(".compact_commit"));
+    }
+  } catch (std::exception &e) {
+    LOG(log_level::error) << "Compaction of " << path_ << " failed: " << e.what();
+    failed = true;
+  }
+
+  std::unique_lock<std::mutex> lock(mtx_);
+  if (failed) {
+    std::remove(data_path(".compact").c_str());
+    std::remove(data_path(".compact_offset").c_str());
+    // The sealed log stays in place, the next trigger retries folding it in
+    compaction_failed_ = true;
+  } else {
+    if (ser_name_ != "csv") {
+      std::rename(data_path(".compact_offset").c_str(), data_path("_offset").c_str());
+    }
+    std::rename(data_path(".compact").c_str(), path_.c_str());
+    std::remove(data_path("_log.old").c_str());
+    std::remove(data_path(".compact_commit").c_str());
+    readers_.erase(old_table);
+    readers_.erase(sealed_log);
+    readers_[new_table] = std::unique_ptr<std::ifstream>(new std::ifstream(path_, std::ios::binary));
+    table_segment_ = new_table;
+    table_size_ = offset;
+    // Keys written since the snapshot already point into the active log
+    std::size_t i = 0;
+    for (const auto &entry: snapshot) {
+      auto it = index_.find(entry.first);
+      if (it != index_.end() && it->second == entry.second) {
+        it->second = new_locations[i];
+      }
+      ++i;
+    }
+  }
+  compacting_ = false;
+  compaction_done_.notify_all();
+}
+
+std::string hash_table_local_store::data_path(const std::string &suffix) const {
+  return path_ + suffix;
+}
+
+}
+}
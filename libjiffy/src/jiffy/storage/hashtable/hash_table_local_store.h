@@ -0,0 +1,254 @@
+#ifndef JIFFY_HASH_TABLE_LOCAL_STORE_H
+#define JIFFY_HASH_TABLE_LOCAL_STORE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace jiffy {
+namespace storage {
+
+/**
+ * @brief Indexed view of a hash table persisted on the local file system.
+ *
+ * The table lives in its serialized file (csv, or binary with an "_offset"
+ * file) as written by the hash table serializer. Writes are appended to a log
+ * next to it, and an in-memory index maps every key to the location of its
+ * value, so each operation costs at most one seek. Once the log grows as
+ * large as the table file, a background thread folds it back into the table
+ * file. The new table files are committed by creating a marker file, so a
+ * crash while installing them is finished on the next open().
+ */
+class hash_table_local_store {
+ public:
+  /**
+   * @brief Constructor
+   * @param path Table file path
+   * @param ser_name Serializer name, csv or binary
+   * @param min_compaction_bytes Minimum log size before compacting
+   */
+
+  hash_table_local_store(const std::string &path,
+                         const std::string &ser_name,
+                         std::size_t min_compaction_bytes = 4194304);
+
+  /**
+   * @brief Destructor, waits for any running compaction
+   */
+
+  ~hash_table_local_store();
+
+  hash_table_local_store(const hash_table_local_store &) = delete;
+  hash_table_local_store &operator=(const hash_table_local_store &) = delete;
+
+  /**
+   * @brief Build the index from the table file and the logs
+   * @return False if the table file does not exist
+   */
+
+  bool open();
+
+  /**
+   * @brief Fetch table file path
+   * @return Table file path
+   */
+
+  const std::string &path() const;
+
+  /**
+   * @brief Check if key exists
+   * @param key Key
+   * @return True if key exists
+   */
+
+  bool exists(const std::string &key);
+
+  /**
+   * @brief Fetch value for key
+   * @param key Key
+   * @param value Value
+   * @return False if key does not exist
+   */
+
+  bool get(const std::string &key, std::string &value);
+
+  /**
+   * @brief Insert key value pair
+   * @param key Key
+   * @param value Value
+   * @return False if key already exists
+   */
+
+  bool put(const std::string &key, const std::string &value);
+
+  /**
+   * @brief Insert or update key value pair
+   * @param key Key
+   * @param value Value
+   */
+
+  void upsert(const std::string &key, const std::string &value);
+
+  /**
+   * @brief Update value for key
+   * @param key Key
+   * @param value Value
+   * @return False if key does not exist
+   */
+
+  bool update(const std::string &key, const std::string &value);
+
+  /**
+   * @brief Remove key
+   * @param key Key
+   * @return False if key does not exist
+   */
+
+  bool remove(const std::string &key);
+
+  /**
+   * @brief Fold the log into the table file and wait for it to finish
+   */
+
+  void compact();
+
+  /**
+   * @brief Check if a table file has a log that is not folded in yet
+   * @param path Table file path
+   * @return True if there is a log
+   */
+
+  static bool has_log(const std::string &path);
+
+  /**
+   * @brief Remove the logs of a table file, e.g. after it was rewritten
+   * @param path Table file path
+   */
+
+  static void clear(const std::string &path);
+
+ private:
+  /* Location of a value */
+  struct location {
+    uint32_t segment;
+    uint64_t offset;
+    uint64_t size;
+
+    bool operator==(const location &other) const {
+      return segment == other.segment && offset == other.offset && size == other.size;
+    }
+  };
+
+  typedef std::unordered_map<std::string, location> index_type;
+
+  /**
+   * @brief Index the table file
+   * @return False if the table file does not exist
+   */
+
+  bool load_table();
+
+  /**
+   * @brief Index a log, truncating a partially written trailing record
+   * @param log_path Log path
+   * @param segment Segment identifier for the log
+   * @return Log size
+   */
+
+  uint64_t load_log(const std::string &log_path, uint32_t segment);
+
+  /**
+   * @brief Append a record to the active log and index it
+   * @param key Key
+   * @param value Value, ignored for removals
+   * @param removal True if the record removes the key
+   */
+
+  void append(const std::string &key, const std::string &value, bool removal);
+
+  /**
+   * @brief Read a value
+   * @param loc Value location
+   * @return Value
+   */
+
+  std::string read(const location &loc);
+
+  /**
+   * @brief Start compacting if the log has grown large enough
+   */
+
+  void maybe_compact();
+
+  /**
+   * @brief Seal the active log and start folding it into the table file, or retry
+   * folding in the sealed log left by a failed compaction
+   */
+
+  void start_compaction();
+
+  /**
+   * @brief Write a new table file from an index snapshot and install it
+   * @param snapshot Index snapshot
+   * @param old_table Segment identifier of the current table file
+   * @param sealed_log Segment identifier of the sealed log
+   * @param new_table Segment identifier of the new table file
+   */
+
+  void run_compaction(index_type snapshot, uint32_t old_table, uint32_t sealed_log, uint32_t new_table);
+
+  /**
+   * @brief Fetch path of a data file
+   * @param suffix Suffix appended to the table file path
+   * @return Path
+   */
+
+  std::string data_path(const std::string &suffix) const;
+
+  /* Table file path */
+  std::string path_;
+  /* Serializer name */
+  std::string ser_name_;
+  /* Minimum log size before compacting */
+  std::size_t min_compaction_bytes_;
+  /* Mutex protecting the index, files and readers */
+  std::mutex mtx_;
+  /* Key to value location */
+  index_type index_;
+  /* Open value files by segment */
+  std::map<uint32_t, std::unique_ptr<std::ifstream>> readers_;
+  /* Active log */
+  std::ofstream log_out_;
+  /* Segment identifier of the table file */
+  uint32_t table_segment_;
+  /* Segment identifier of the active log */
+  uint32_t log_segment_;
+  /* Next segment identifier */
+  uint32_t next_segment_;
+  /* Table file value bytes */
+  uint64_t table_size_;
+  /* Active log bytes */
+  uint64_t log_size_;
+  /* Segment identifier of the sealed log */
+  uint32_t sealed_segment_;
+  /* Bool for a running compaction */
+  bool compacting_;
+  /* Bool for a failed compaction, which leaves the sealed log in place for the next one */
+  bool compaction_failed_;
+  /* Condition variable signalled when a compaction finishes */
+  std::condition_variable compaction_done_;
+  /* Compaction thread */
+  std::thread compactor_;
+};
+
+}
+}
+
+#endif //JIFFY_HASH_TABLE_LOCAL_STORE_H
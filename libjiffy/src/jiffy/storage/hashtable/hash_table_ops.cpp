@@ -21,6 +21,11 @@ command_map HT_OPS = {{"exists", {command_type::accessor, 0}},
                       {"get_metadata", {command_type::accessor, 14}},
                       {"get_range_data", {command_type::accessor, 15}},
                       {"scale_put", {command_type::mutator, 16}},
-                      {"scale_remove", {command_type::mutator, 17}}};
+                      {"scale_remove", {command_type::mutator, 17}},
+                      {"multi_get", {command_type::accessor, 18}},
+                      {"multi_put", {command_type::mutator, 19}},
+                      {"multi_upsert", {command_type::mutator, 20}},
+                      {"multi_remove", {command_type::mutator, 21}},
+                      {"bulk_load", {command_type::mutator, 22}}};
 }
 }
\ No newline at end of file
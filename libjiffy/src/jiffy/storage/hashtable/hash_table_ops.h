@@ -30,7 +30,12 @@ enum hash_table_cmd_id: uint32_t {
   ht_get_metadata = 14,
   ht_get_range_data = 15,
   ht_scale_put = 16,
-  ht_scale_remove = 17
+  ht_scale_remove = 17,
+  ht_multi_get = 18,
+  ht_multi_put = 19,
+  ht_multi_upsert = 20,
+  ht_multi_remove = 21,
+  ht_bulk_load = 22
 };
 
 }
@@ -7,6 +7,7 @@
 #include "jiffy/persistent/persistent_store.h"
 #include "jiffy/storage/partition_manager.h"
 #include "jiffy/auto_scaling/auto_scaling_client.h"
+#include "jiffy/utils/time_utils.h"
 #include <chrono>
 #include <thread>
 
@@ -38,23 +39,54 @@ hash_table_partition::hash_table_partition(block_memory_manager *manager,
   } else {
     throw std::invalid_argument("No such serializer/deserializer " + ser_name_);
   }
+  auto index_type = conf.get("hashtable.index_type", "unordered_map");
+  if (index_type == "open_addressing") {
+    block_ = hash_table_type(open_addressing_index, binary_allocator_);
+  } else if (index_type != "unordered_map") {
+    throw std::invalid_argument("No such hash table index type " + index_type);
+  }
   threshold_hi_ = conf.get_as<double>("hashtable.capacity_threshold_hi", 0.95);
   threshold_lo_ = conf.get_as<double>("hashtable.capacity_threshold_lo", 0.05);
   auto_scale_ = conf.get_as<bool>("hashtable.auto_scale", true);
   auto r = utils::string_utils::split(name_, '_');
   slot_range(std::stoi(r[0]), std::stoi(r[1]));
+  // Pre-size the index for this partition's share of the expected keys
+  auto expected_keys = conf.get_as<std::size_t>("hashtable.expected_keys", 0);
+  if (expected_keys > 0) {
+    block_.reserve(expected_keys * static_cast<std::size_t>(slot_end() - slot_begin()) / hash_slot::MAX);
+  }
   temporary_data_manager_ = new block_memory_manager(HASH_TABLE_MAX_KEY_SIZE);
   temporary_data_allocator_ = allocator<uint8_t>(temporary_data_manager_);
+  incremental_sync_ = conf.get_as<bool>("hashtable.incremental_sync", false);
+  max_deltas_ = conf.get_as<std::size_t>("hashtable.max_deltas", 16);
+  reset_deltas();
+  background_sync_ = conf.get_as<bool>("hashtable.background_sync", false);
+  sync_bytes_per_sec_ = conf.get_as<std::size_t>("hashtable.sync_bytes_per_sec", 0);
+  sync_copy_bytes_ = conf.get_as<std::size_t>("hashtable.sync_copy_bytes", storage_capacity());
+  stop_persister_ = false;
+  if (background_sync_) {
+    persister_ = std::thread(&hash_table_partition::persist_loop, this);
+  }
+}
 
+hash_table_partition::~hash_table_partition() {
+  {
+    std::unique_lock<std::mutex> lock(persist_mtx_);
+    stop_persister_ = true;
+  }
+  persist_cv_.notify_all();
+  if (persister_.joinable()) {
+    persister_.join();
+  }
 }
 
 void hash_table_partition::exists(response &_return, const arg_list &args) {
   if (!(args.size() == 2 || (args.size() == 3 && args[2] == "!redirected"))) {
     RETURN("!args_error");
   }
-  auto hash = hash_slot::get(args[1]);
+  auto hash = hash_slot::get(args[0], args[1]);
   if (in_slot_range(hash) || (in_import_slot_range(hash) && args[2] == "!redirected")) {
-    BEGIN_CATCH_HANDLER;
+    BEGIN_CATCH_HANDLER(args[1]);
       if (it != block_.end()) {
         RETURN_OK();
       } else {
@@ -72,24 +104,31 @@ void hash_table_partition::put(response &_return, const arg_list &args) {
   if (!(args.size() == 3 || (args.size() == 4 && args[3] == "!redirected"))) {
     RETURN_ERR("!args_error");
   }
-  auto hash = hash_slot::get(args[1]);
-  if (in_slot_range(hash) || (in_import_slot_range(hash) && args[3] == "!redirected")) {
-    if (storage_size() + args[1].size() > storage_capacity()) {
+  put_key(_return, hash_slot::get(args[0], args[1]), args[1], args[2], args.size() == 4);
+}
+
+void hash_table_partition::put_key(response &_return,
+                                   int32_t hash,
+                                   const std::string &key,
+                                   const std::string &value,
+                                   bool redirected) {
+  if (in_slot_range(hash) || (in_import_slot_range(hash) && redirected)) {
+    if (storage_size() + key.size() > storage_capacity()) {
       RETURN_ERR("!redo");
     }
-    BEGIN_CATCH_HANDLER;
+    BEGIN_CATCH_HANDLER(key);
       if (it != block_.end()) {
         RETURN_ERR("!duplicate_key");
       }
       if (metadata_ == "exporting" && in_export_slot_range(hash)) {
         RETURN_ERR("!exporting", export_target_str_);
       }
-      if (storage_size() + args[1].size() + args[2].size() > storage_capacity()) {
+      if (storage_size() + key.size() + value.size() > storage_capacity()) {
         RETURN_ERR("!full");
       }
-      if (block_.emplace(make_binary(args[1]), make_binary(args[2])).second) {
-        if (remove_cache_.find(args[1]) != remove_cache_.end())
-          remove_cache_.erase(args[1]);
+      if (block_.emplace(make_binary(key), make_binary(value)).second) {
+        if (remove_cache_.find(key) != remove_cache_.end())
+          remove_cache_.erase(key);
         RETURN_OK();
       }
     END_CATCH_HANDLER;
@@ -101,17 +140,16 @@ void hash_table_partition::upsert(response &_return, const arg_list &args) {
   if (!(args.size() == 3 || (args.size() == 6 && args[5] == "!redirected"))) {
     RETURN_ERR("!args_error");
   }
-  auto hash = hash_slot::get(args[1]);
-  bool found = false;
-  std::string old_val;
+  auto hash = hash_slot::get(args[0], args[1]);
   // Redirected upsert
   if (in_import_slot_range(hash) && args.size() == 6 && args[5] == "!redirected" && metadata() == "importing") {
-    found = static_cast<bool>(std::stoi(args[3]));
-    BEGIN_CATCH_HANDLER;
+    auto found = static_cast<bool>(std::stoi(args[3]));
+    BEGIN_CATCH_HANDLER(args[1]);
       if (it != block_.end()) {
-        old_val = to_string(it->second);
+        auto old_bin = std::move(it->second);
         it->second = make_binary(args[2]);
-        RETURN_OK(old_val);
+        return_value(_return, old_bin);
+        return;
       }
       if (found && block_.emplace(make_binary(args[1]), make_binary(args[2])).second) {
         RETURN_OK(args[4]);
@@ -123,21 +161,28 @@ void hash_table_partition::upsert(response &_return, const arg_list &args) {
     RETURN_OK();
   }
   // Ordinary upsert
+  upsert_key(_return, hash, args[1], args[2]);
+}
+
+void hash_table_partition::upsert_key(response &_return,
+                                      int32_t hash,
+                                      const std::string &key,
+                                      const std::string &value) {
   if (in_slot_range(hash)) {
-    BEGIN_CATCH_HANDLER;
+    BEGIN_CATCH_HANDLER(key);
       if (it != block_.end()) {
-        found = true;
-        old_val = to_string(it->second);
-        it->second = make_binary(args[2]);
+        auto old_bin = std::move(it->second);
+        it->second = make_binary(value);
         if (metadata_ == "exporting" && in_export_slot_range(hash)) {
-          RETURN_ERR("!exporting", export_target_str_, std::to_string(found), old_val);
+          RETURN_ERR("!exporting", export_target_str_, std::to_string(true), to_string(old_bin));
         }
-        RETURN_OK(old_val);
+        return_value(_return, old_bin);
+        return;
       }
       if (metadata_ == "exporting" && in_export_slot_range(hash)) {
-        RETURN_ERR("!exporting", export_target_str_, std::to_string(found), old_val);
+        RETURN_ERR("!exporting", export_target_str_, std::to_string(false), "");
       }
-      block_.emplace(make_binary(args[1]), make_binary(args[2]));
+      block_.emplace(make_binary(key), make_binary(value));
     END_CATCH_HANDLER;
     RETURN_OK();
   }
@@ -148,11 +193,15 @@ void hash_table_partition::get(response &_return, const arg_list &args) {
   if (!(args.size() == 2 || (args.size() == 3 && args[2] == "!redirected"))) {
     RETURN("!args_error");
   }
-  auto hash = hash_slot::get(args[1]);
-  if (in_slot_range(hash) || (in_import_slot_range(hash) && args[2] == "!redirected")) {
-    BEGIN_CATCH_HANDLER;
+  get_key(_return, hash_slot::get(args[0], args[1]), args[1], args.size() == 3);
+}
+
+void hash_table_partition::get_key(response &_return, int32_t hash, const std::string &key, bool redirected) {
+  if (in_slot_range(hash) || (in_import_slot_range(hash) && redirected)) {
+    BEGIN_CATCH_HANDLER(key);
       if (it != block_.end()) {
-        RETURN_OK(to_string(it->second));
+        return_value(_return, it->second);
+        return;
       } else {
         if (metadata_ == "exporting" && in_export_slot_range(hash)) {
           RETURN_ERR("!exporting", export_target_str_);
@@ -168,15 +217,14 @@ void hash_table_partition::update(response &_return, const arg_list &args) {
   if (!(args.size() == 3 || (args.size() == 6 && args[5] == "!redirected"))) {
     RETURN_ERR("!args_error");
   }
-  auto hash = hash_slot::get(args[1]);
+  auto hash = hash_slot::get(args[0], args[1]);
   bool found = false;
   std::string old_val;
   // Redirected update
   if (in_import_slot_range(hash) && args.size() == 6 && args[5] == "!redirected" && metadata() == "importing") {
     found = static_cast<bool>(std::stoi(args[3]));
-    BEGIN_CATCH_HANDLER;
+    BEGIN_CATCH_HANDLER(args[1]);
       if (it != block_.end()) {
-        old_val = to_string(it->second);
         it->second = make_binary(args[2]);
         RETURN_OK();
       }
@@ -190,13 +238,13 @@ void hash_table_partition::update(response &_return, const arg_list &args) {
   }
   // Ordinary update
   if (in_slot_range(hash)) {
-    BEGIN_CATCH_HANDLER;
+    BEGIN_CATCH_HANDLER(args[1]);
       if (it != block_.end()) {
         found = true;
-        old_val = to_string(it->second);
+        auto old_bin = std::move(it->second);
         it->second = make_binary(args[2]);
         if (metadata_ == "exporting" && in_export_slot_range(hash)) {
-          RETURN_ERR("!exporting", export_target_str_, std::to_string(found), old_val);
+          RETURN_ERR("!exporting", export_target_str_, std::to_string(found), to_string(old_bin));
         }
         RETURN_OK();
       }
@@ -214,11 +262,17 @@ void hash_table_partition::remove(response &_return, const arg_list &args) {
       || (args.size() == 3 && args[2] == "!buffered"))) {
     RETURN_ERR("!args_error");
   }
-  auto hash = hash_slot::get(args[1]);
+  remove_key(_return, hash_slot::get(args[0], args[1]), args[1], args.size() == 3 ? args[2] : "");
+}
+
+void hash_table_partition::remove_key(response &_return,
+                                      int32_t hash,
+                                      const std::string &key,
+                                      const std::string &mode) {
   // Ordinary remove or buffered remove
-  if (in_slot_range(hash) || (in_import_slot_range(hash) && args[2] == "!buffered")) {
+  if (in_slot_range(hash) || (in_import_slot_range(hash) && mode == "!buffered")) {
     try {
-      if (block_.erase(make_temporary_binary(args[1]))) {
+      if (block_.erase(make_temporary_binary(key))) {
         if (metadata_ == "exporting" && in_export_slot_range(hash)) {
           RETURN_ERR("!exporting", export_target_str_);
         }
@@ -231,452 +285,209 @@ void hash_table_partition::remove(response &_return, const arg_list &args) {
     END_CATCH_HANDLER;
   }
   // Redirected remove
-  if (in_import_slot_range(hash) && args[2] == "!redirected") {
+  if (in_import_slot_range(hash) && mode == "!redirected") {
     try {
-      if (block_.erase(make_temporary_binary(args[1]))) {
+      if (block_.erase(make_temporary_binary(key))) {
         RETURN_OK();
       }
     END_CATCH_HANDLER;
-    remove_cache_.emplace(std::make_pair(args[1], 1));
+    remove_cache_.emplace(std::make_pair(key, 1));
     RETURN_OK();
   }
   RETURN_ERR("!block_moved");
 }
 
-void hash_table_partition::exists_ls(response &_return, const arg_list &args) {
-  if (args.size() != 2) {
-    RETURN("!args_error");
+void hash_table_partition::multi_get(response &_return, const arg_list &args) {
+  if (args.size() < 2) {
+    RETURN_ERR("!args_error");
   }
-  std::string file_path, line, key, value;
-  file_path = directory_utils::remove_uri(backing_path());
-  directory_utils::push_path_element(file_path,name());
-  if (ser_name_ == "csv") {
-    std::ifstream in(file_path);
-    if (in) {
-      while(getline(in,line)) {
-        int split_index = line.find(",");
-        key = line.substr(0,split_index);
-        if (key == args[1]) {
-          RETURN_OK();
-        }
-      }
-      in.close();
-      RETURN_ERR("!key_not_found");
-    }
-    else {
-      RETURN_ERR("!hash_table_does_not_exist");
+  response key_return;
+  _return.clear();
+  _return.emplace_back("!ok");
+  for (std::size_t i = 1; i < args.size(); ++i) {
+    get_key(key_return, hash_slot::get(args[i]), args[i], false);
+    append_key_response(_return, key_return);
+  }
+}
+
+void hash_table_partition::multi_put(response &_return, const arg_list &args) {
+  if (args.size() < 3 || args.size() % 2 == 0) {
+    RETURN_ERR("!args_error");
+  }
+  response key_return;
+  _return.clear();
+  _return.emplace_back("!ok");
+  for (std::size_t i = 1; i < args.size(); i += 2) {
+    put_key(key_return, hash_slot::get(args[i]), args[i], args[i + 1], false);
+    append_key_response(_return, key_return);
+  }
+}
+
+void hash_table_partition::multi_upsert(response &_return, const arg_list &args) {
+  if (args.size() < 3 || args.size() % 2 == 0) {
+    RETURN_ERR("!args_error");
+  }
+  response key_return;
+  _return.clear();
+  _return.emplace_back("!ok");
+  for (std::size_t i = 1; i < args.size(); i += 2) {
+    upsert_key(key_return, hash_slot::get(args[i]), args[i], args[i + 1]);
+    append_key_response(_return, key_return);
+  }
+}
+
+void hash_table_partition::multi_remove(response &_return, const arg_list &args) {
+  if (args.size() < 2) {
+    RETURN_ERR("!args_error");
+  }
+  response key_return;
+  _return.clear();
+  _return.emplace_back("!ok");
+  for (std::size_t i = 1; i < args.size(); ++i) {
+    remove_key(key_return, hash_slot::get(args[i]), args[i], "");
+    append_key_response(_return, key_return);
+  }
+}
+
+void hash_table_partition::bulk_load(response &_return, const arg_list &args) {
+  if (args.size() < 3 || args.size() % 2 == 0) {
+    RETURN_ERR("!args_error");
+  }
+  if (metadata_ == "exporting" || metadata_ == "importing") {
+    RETURN_ERR("!redo");
+  }
+  std::size_t bytes = 0;
+  for (std::size_t i = 1; i < args.size(); i += 2) {
+    if (!in_slot_range(hash_slot::get(args[i]))) {
+      RETURN_ERR("!block_moved");
     }
+    bytes += args[i].size() + args[i + 1].size();
   }
-  else if (ser_name_ == "binary") {
-    std::string offset_path = file_path;
-    offset_path.append("_offset");
-    std::ifstream offset_in(offset_path,std::ios::binary);
-    std::size_t key_size = 0;
-    std::size_t value_size = 0;
-    if (offset_in) {
-      while (offset_in.peek() != EOF) {
-        offset_in.read(reinterpret_cast<char *>(&key_size), sizeof(key_size));
-        key.resize(key_size);
-        offset_in.read(&key[0], key_size);
-        offset_in.read(reinterpret_cast<char *>(&value_size), sizeof(value_size));
-        if (key == args[1]) {
-          offset_in.close();
-          RETURN_OK();
-        }
+  if (storage_size() + bytes > storage_capacity()) {
+    RETURN_ERR("!full");
+  }
+  try {
+    block_.reserve(block_.size() + (args.size() - 1) / 2);
+    for (std::size_t i = 1; i < args.size(); i += 2) {
+      auto it = block_.find(make_temporary_binary(args[i]));
+      if (it != block_.end()) {
+        it->second = make_binary(args[i + 1]);
+      } else {
+        block_.emplace(make_binary(args[i]), make_binary(args[i + 1]));
       }
-      offset_in.close();
-      RETURN_ERR("!key_not_found");
-    }
-    else {
-      RETURN_ERR("!fifo_queue_does_not_exist");
     }
+  } catch (std::bad_alloc &e) {
+    RETURN_ERR("!full");
   }
+  RETURN_OK();
+}
+
+void hash_table_partition::exists_ls(response &_return, const arg_list &args) {
+  if (args.size() != 2) {
+    RETURN("!args_error");
+  }
+  auto store = local_store();
+  if (store == nullptr) {
+    RETURN_ERR("!hash_table_does_not_exist");
+  }
+  if (store->exists(args[1])) {
+    RETURN_OK();
+  }
+  RETURN_ERR("!key_not_found");
 }
 
 void hash_table_partition::put_ls(response &_return, const arg_list &args) {
   if (args.size() != 3) {
     RETURN_ERR("!args_error");
   }
-  std::string file_path, line, key, value;
-  file_path = directory_utils::remove_uri(backing_path());
-  directory_utils::push_path_element(file_path,name());
-  if (ser_name_ == "csv") {
-    std::ifstream in(file_path);
-    if (in) {
-      while(getline(in,line)) {
-        int split_index = line.find(",");
-        key = line.substr(0,split_index);
-        if (key == args[1]) {
-          in.close();
-          RETURN_ERR("!duplicate_key");
-        }
-      }
-      in.close();
-      std::ofstream out(file_path,std::ios::app);
-      out << args[1] << "," << args[2] << std::endl;
-      out.close();
-      RETURN_OK();
-    }
-    else {
-      RETURN_ERR("!hash_table_does_not_exist");
-    }
+  auto store = local_store();
+  if (store == nullptr) {
+    RETURN_ERR("!hash_table_does_not_exist");
   }
-  else if (ser_name_ == "binary") {
-    std::string offset_path = file_path;
-    offset_path.append("_offset");
-    std::ifstream offset_in(offset_path,std::ios::binary);
-    std::size_t key_size = 0;
-    std::size_t value_size = 0;
-    if (offset_in) {
-      while (offset_in.peek() != EOF) {
-        offset_in.read(reinterpret_cast<char *>(&key_size), sizeof(key_size));
-        key.resize(key_size);
-        offset_in.read(&key[0], key_size);
-        offset_in.read(reinterpret_cast<char *>(&value_size), sizeof(value_size));
-        if (key == args[1]) {
-          offset_in.close();
-          RETURN_ERR("!duplicate_key");
-        }
-      }
-      offset_in.close();
-      std::ofstream out(file_path,std::ios::app);
-      std::ofstream offset_out(offset_path,std::ios::app);
-      key_size = args[1].size();
-      value_size = args[2].size();
-      offset_out.write(reinterpret_cast<const char *>(&key_size), sizeof(size_t));
-      offset_out.write(reinterpret_cast<const char *>(args[1].data()), key_size);
-      offset_out.write(reinterpret_cast<const char *>(&value_size), sizeof(size_t));
-      out.write(reinterpret_cast<const char *>(args[2].data()), value_size);
-      out.close();
-      offset_out.close();
-      RETURN_OK();
-    }
-    else {
-      RETURN_ERR("!fifo_queue_does_not_exist");
-    }
+  if (store->put(args[1], args[2])) {
+    RETURN_OK();
   }
+  RETURN_ERR("!duplicate_key");
 }
 
 void hash_table_partition::upsert_ls(response &_return, const arg_list &args) {
   if (args.size() != 3) {
     RETURN_ERR("!args_error");
   }
-  std::unordered_map<std::string,std::string> ht;
-  std::string file_path, line, key, value;
-  int key_exist = 0;
-  file_path = directory_utils::remove_uri(backing_path());
-  directory_utils::push_path_element(file_path,name());
-  if (ser_name_ == "csv") {
-    std::ifstream in(file_path);
-    if (in) {
-      while(getline(in,line)) {
-        int split_index = line.find(",");
-        key = line.substr(0,split_index);
-        if (key == args[1]) {
-          key_exist = 1;
-          value = args[2];
-          ht.insert({key,value});
-          continue;
-        }
-        value = line.substr(split_index+1);
-        ht.insert({key,value});
-      }
-      in.close();
-    }
-    else {
-      RETURN_ERR("!hash_table_does_not_exist");
-    }
-    if (key_exist == 0) {
-      ht.insert({args[1],args[2]});
-    }
-    std::ofstream out(file_path);
-    for (auto x: ht) {
-      out << (x.first) << "," << (x.second) << std::endl;
-    }
-    out.close();
-    RETURN_OK();
-  }
-  else if (ser_name_ == "binary") {
-    std::ifstream in(file_path,std::ios::binary);
-    std::string offset_path = file_path;
-    offset_path.append("_offset");
-    std::ifstream offset_in(offset_path,std::ios::binary);
-    std::size_t key_size = 0;
-    std::size_t value_size = 0;
-    if (in && offset_in) {
-      while (offset_in.peek() != EOF) {
-        offset_in.read(reinterpret_cast<char *>(&key_size), sizeof(key_size));
-        key.resize(key_size);
-        offset_in.read(&key[0], key_size);
-        offset_in.read(reinterpret_cast<char *>(&value_size), sizeof(value_size));
-        if (key == args[1]) {
-          key_exist = 1;
-          in.read(&value[0], value_size);
-          ht.insert({key,args[2]});
-          continue;
-        }
-        value.resize(value_size);
-        in.read(&value[0], value_size);
-        ht.insert({key,value});
-      }
-      in.close();
-      offset_in.close();
-    }
-    else {
-      RETURN_ERR("!hash_table_does_not_exist");
-    }
-    if (key_exist == 0) {
-      ht.insert({args[1],args[2]});
-    }
-    std::ofstream out(file_path,std::ios::binary);
-    std::ofstream offset_out(offset_path,std::ios::binary);
-    for (auto x: ht) {
-      key_size = x.first.size();
-      value_size = x.second.size();
-      offset_out.write(reinterpret_cast<const char *>(&key_size), sizeof(size_t));
-      offset_out.write(reinterpret_cast<const char *>(x.first.data()), key_size);
-      offset_out.write(reinterpret_cast<const char *>(&value_size), sizeof(size_t));
-      out.write(reinterpret_cast<const char *>(x.second.data()), value_size);
-    }
-    out.close();
-    offset_out.close();
-    RETURN_OK();
+  auto store = local_store();
+  if (store == nullptr) {
+    RETURN_ERR("!hash_table_does_not_exist");
   }
-  
+  store->upsert(args[1], args[2]);
+  RETURN_OK();
 }
 
 void hash_table_partition::get_ls(response &_return, const arg_list &args) {
   if (args.size() != 2) {
     RETURN("!args_error");
   }
-  std::string file_path, line, key, value;
-  file_path = directory_utils::remove_uri(backing_path());
-  directory_utils::push_path_element(file_path,name());
-  if (ser_name_ == "csv") {
-    std::ifstream in(file_path);
-    if (in) {
-      while(getline(in,line)) {
-        int split_index = line.find(",");
-        key = line.substr(0,split_index);
-        if (key == args[1]) {
-          value = line.substr(split_index+1);
-          RETURN_OK(value);
-        }
-      }
-      in.close();
-      RETURN_ERR("!key_not_found");
-    }
-    else {
-      RETURN_ERR("!hash_table_does_not_exist");
-    }
+  auto store = local_store();
+  if (store == nullptr) {
+    RETURN_ERR("!hash_table_does_not_exist");
   }
-  else if (ser_name_ == "binary") {
-    std::ifstream in(file_path,std::ios::binary);
-    std::string offset_path = file_path;
-    offset_path.append("_offset");
-    std::ifstream offset_in(offset_path,std::ios::binary);
-    std::size_t offset = 0;
-    std::size_t key_size = 0;
-    std::size_t value_size = 0;
-    if (in && offset_in) {
-      while (offset_in.peek() != EOF) {
-        offset_in.read(reinterpret_cast<char *>(&key_size), sizeof(key_size));
-        key.resize(key_size);
-        offset_in.read(&key[0], key_size);
-        offset_in.read(reinterpret_cast<char *>(&value_size), sizeof(value_size));
-        if (key == args[1]) {
-          value.resize(value_size);
-          in.seekg(offset,std::ios::beg);
-          in.read(&value[0], value_size);
-          RETURN_OK(value);
-        }
-        offset += value_size;
-      }
-      in.close();
-      offset_in.close();
-      RETURN_ERR("!key_not_found");
-    }
-    else {
-      RETURN_ERR("!hash_table_does_not_exist");
-    }
+  std::string value;
+  if (store->get(args[1], value)) {
+    RETURN_OK(value);
   }
+  RETURN_ERR("!key_not_found");
 }
 
 void hash_table_partition::update_ls(response &_return, const arg_list &args) {
   if (args.size() != 3) {
     RETURN_ERR("!args_error");
   }
-  
-  std::unordered_map<std::string,std::string> ht;
-  std::string file_path, line, key, value;
-  int key_exist = 0;
-  file_path = directory_utils::remove_uri(backing_path());
-  directory_utils::push_path_element(file_path,name());
-  if (ser_name_ == "csv") {
-    std::ifstream in(file_path);
-    if (in) {
-      while(getline(in,line)) {
-        int split_index = line.find(",");
-        key = line.substr(0,split_index);
-        if (key == args[1]) {
-          key_exist = 1;
-          value = args[2];
-          ht.insert({key,value});
-          continue;
-        }
-        value = line.substr(split_index+1);
-        ht.insert({key,value});
-      }
-      in.close();
-    }
-    else {
-      RETURN_ERR("!hash_table_does_not_exist");
-    }
-    if (key_exist == 1) {
-      std::ofstream out(file_path);
-      for (auto x: ht) {
-        out << (x.first) << "," << (x.second) << std::endl;
-      }
-      out.close();
-      RETURN_OK();
-    }
-    else {
-      RETURN_ERR("!key_not_found");
-    }
+  auto store = local_store();
+  if (store == nullptr) {
+    RETURN_ERR("!hash_table_does_not_exist");
   }
-  else if (ser_name_ == "binary") {
-    std::ifstream in(file_path,std::ios::binary);
-    std::string offset_path = file_path;
-    offset_path.append("_offset");
-    std::ifstream offset_in(offset_path,std::ios::binary);
-    std::size_t key_size = 0;
-    std::size_t value_size = 0;
-    if (in && offset_in) {
-      while (offset_in.peek() != EOF) {
-        offset_in.read(reinterpret_cast<char *>(&key_size), sizeof(key_size));
-        key.resize(key_size);
-        offset_in.read(&key[0], key_size);
-        offset_in.read(reinterpret_cast<char *>(&value_size), sizeof(value_size));
-        if (key == args[1]) {
-          key_exist = 1;
-          in.read(&value[0], value_size);
-          ht.insert({key,args[2]});
-          continue;
-        }
-        value.resize(value_size);
-        in.read(&value[0], value_size);
-        ht.insert({key,value});
-      }
-      in.close();
-      offset_in.close();
-    }
-    else {
-      RETURN_ERR("!hash_table_does_not_exist");
-    }
-    if (key_exist == 0) {
-      RETURN_ERR("!key_not_found");
-    }
-    std::ofstream out(file_path,std::ios::binary);
-    std::ofstream offset_out(offset_path,std::ios::binary);
-    for (auto x: ht) {
-      key_size = x.first.size();
-      value_size = x.second.size();
-      offset_out.write(reinterpret_cast<const char *>(&key_size), sizeof(size_t));
-      offset_out.write(reinterpret_cast<const char *>(x.first.data()), key_size);
-      offset_out.write(reinterpret_cast<const char *>(&value_size), sizeof(size_t));
-      out.write(reinterpret_cast<const char *>(x.second.data()), value_size);
-    }
-    out.close();
-    offset_out.close();
+  if (store->update(args[1], args[2])) {
     RETURN_OK();
   }
+  RETURN_ERR("!key_not_found");
 }
 
 void hash_table_partition::remove_ls(response &_return, const arg_list &args) {
   if (args.size() != 2) {
     RETURN_ERR("!args_error");
   }
-  // Ordinary remove or buffered remove
-  std::unordered_map<std::string,std::string> ht;
-  std::string file_path, line, key, value;
-  int key_exist = 0;
-  file_path = directory_utils::remove_uri(backing_path());
-  directory_utils::push_path_element(file_path,name());
-  if (ser_name_ == "csv") {
-    std::ifstream in(file_path);
-    if (in) {
-      while(getline(in,line)) {
-        int split_index = line.find(",");
-        key = line.substr(0,split_index);
-        if (key == args[1]) {
-          key_exist = 1;
-          continue;
-        }
-        value = line.substr(split_index+1);
-        ht.insert({key,value});
-      }
-      in.close();
-    }
-    else {
-      RETURN_ERR("!hash_table_does_not_exist");
-    }
-    if (key_exist == 1) {
-      std::ofstream out(file_path);
-      for (auto x: ht) {
-        out << (x.first) << "," << (x.second) << std::endl;
-      }
-      out.close();
-      RETURN_OK();
-    }
-    else {
-      RETURN_ERR("!key_not_found");
-    }
+  auto store = local_store();
+  if (store == nullptr) {
+    RETURN_ERR("!hash_table_does_not_exist");
   }
-  else if (ser_name_ == "binary") {
-    std::ifstream in(file_path,std::ios::binary);
-    std::string offset_path = file_path;
-    offset_path.append("_offset");
-    std::ifstream offset_in(offset_path,std::ios::binary);
-    std::size_t key_size = 0;
-    std::size_t value_size = 0;
-    if (in && offset_in) {
-      while (offset_in.peek() != EOF) {
-        offset_in.read(reinterpret_cast<char *>(&key_size), sizeof(key_size));
-        key.resize(key_size);
-        offset_in.read(&key[0], key_size);
-        offset_in.read(reinterpret_cast<char *>(&value_size), sizeof(value_size));
-        if (key == args[1]) {
-          key_exist = 1;
-          in.read(&value[0], value_size);
-          continue;
-        }
-        value.resize(value_size);
-        in.read(&value[0], value_size);
-        ht.insert({key,value});
-      }
-      in.close();
-      offset_in.close();
-    }
-    else {
-      RETURN_ERR("!hash_table_does_not_exist");
-    }
-    if (key_exist == 0) {
-      RETURN_ERR("!key_not_found");
-    }
-    std::ofstream out(file_path,std::ios::binary);
-    std::ofstream offset_out(offset_path,std::ios::binary);
-    for (auto x: ht) {
-      key_size = x.first.size();
-      value_size = x.second.size();
-      offset_out.write(reinterpret_cast<const char *>(&key_size), sizeof(size_t));
-      offset_out.write(reinterpret_cast<const char *>(x.first.data()), key_size);
-      offset_out.write(reinterpret_cast<const char *>(&value_size), sizeof(size_t));
-      out.write(reinterpret_cast<const char *>(x.second.data()), value_size);
-    }
-    out.close();
-    offset_out.close();
+  if (store->remove(args[1])) {
     RETURN_OK();
   }
+  RETURN_ERR("!key_not_found");
+}
+
+hash_table_local_store *hash_table_partition::local_store() {
+  if (local_store_ == nullptr) {
+    auto file_path = directory_utils::remove_uri(backing_path());
+    directory_utils::push_path_element(file_path, name());
+    std::unique_ptr<hash_table_local_store> store(new hash_table_local_store(file_path, ser_name_));
+    if (!store->open()) {
+      return nullptr;
+    }
+    local_store_ = std::move(store);
+  }
+  return local_store_.get();
+}
+
+void hash_table_partition::close_local_store(const std::string &path) {
+  auto decomposed = persistent::persistent_store::decompose_path(path);
+  if (decomposed.first != "local") {
+    return;
+  }
+  auto file_path = directory_utils::remove_uri(path);
+  if (local_store_ != nullptr && local_store_->path() == file_path) {
+    local_store_.reset();
+  }
+  hash_table_local_store::clear(file_path);
 }
 
 void hash_table_partition::scale_remove(response &_return, const arg_list &args) {
@@ -711,29 +522,28 @@ void hash_table_partition::scale_put(response &_return, const arg_list &args) {
 }
 
 void hash_table_partition::get_data_in_slot_range(response &_return, const arg_list &args) {
-  if (args.size() != 4) {
+  if (args.size() != 5) {
     RETURN_ERR("!args_error");
   }
   std::size_t n_items = 0;
   auto slot_begin = std::stoi(args[1]);
   auto slot_end = std::stoi(args[2]);
   auto batch_size = std::stoull(args[3]);
-  for (const auto &entry: block_) {
+  auto cursor = std::stoull(args[4]);
+  _return.clear();
+  _return.emplace_back("!ok");
+  _return.emplace_back();
+  auto next = block_.scan(cursor, [&](const kv_pair_type &entry) {
     auto slot = hash_slot::get(entry.first);
     if (slot >= slot_begin && slot < slot_end) {
-      if (_return.empty())
-        _return.emplace_back("!ok");
       _return.emplace_back(to_string(entry.first));
       _return.emplace_back(to_string(entry.second));
       n_items += 2;
-      if (n_items == static_cast<std::size_t>(batch_size)) {
-        return;
-      }
     }
-  }
-  if (_return.empty()) {
-    RETURN_ERR("!empty");
-  }
+    return n_items < batch_size;
+  });
+  // Cursor wraps around to zero once the whole block has been scanned
+  _return[1] = std::to_string(next < block_.bucket_count() ? next : 0);
 }
 
 void hash_table_partition::update_partition(response &_return, const arg_list &args) {
@@ -806,8 +616,13 @@ void hash_table_partition::get_metadata(response &_return, const arg_list &args)
 }
 
 void hash_table_partition::run_command(response &_return, const arg_list &args) {
-  auto cmd_name = args[0];
-  switch (command_id(cmd_name)) {
+  auto cmd_id = command_id(args[0]);
+  std::unique_lock<std::mutex> mutator_lock(mutator_mtx_, std::defer_lock);
+  if ((incremental_sync_ || background_sync_) && is_mutator(cmd_id)) {
+    // Sync captures the table and the changed keys between mutators, never halfway through one
+    mutator_lock.lock();
+  }
+  switch (cmd_id) {
     case hash_table_cmd_id::ht_exists:exists(_return, args);
       break;
     case hash_table_cmd_id::ht_get:get(_return, args);
@@ -844,15 +659,31 @@ void hash_table_partition::run_command(response &_return, const arg_list &args)
       break;
     case hash_table_cmd_id::ht_scale_remove:scale_remove(_return, args);
       break;
+    case hash_table_cmd_id::ht_multi_get:multi_get(_return, args);
+      break;
+    case hash_table_cmd_id::ht_multi_put:multi_put(_return, args);
+      break;
+    case hash_table_cmd_id::ht_multi_upsert:multi_upsert(_return, args);
+      break;
+    case hash_table_cmd_id::ht_multi_remove:multi_remove(_return, args);
+      break;
+    case hash_table_cmd_id::ht_bulk_load:bulk_load(_return, args);
+      break;
     default: {
       _return.emplace_back("!no_such_command");
       return;
     }
   }
-  if (is_mutator(cmd_name)) {
+  if (is_mutator(cmd_id)) {
     dirty_ = true;
+    if (incremental_sync_) {
+      track_delta(args);
+    }
+  }
+  if (mutator_lock) {
+    mutator_lock.unlock();
   }
-  if (auto_scale_ && is_mutator(cmd_name) && overload() && metadata_ != "exporting" && metadata_ != "importing"
+  if (auto_scale_ && is_mutator(cmd_id) && overload() && metadata_ != "exporting" && metadata_ != "importing"
       && is_tail() && !scaling_up_ && !scaling_down_) {
     LOG(log_level::info) << "Overloaded partition; storage = " << storage_size() << " capacity = " << storage_capacity()
                          << " slot range = (" << slot_begin() << ", " << slot_end() << ")";
@@ -869,7 +700,8 @@ void hash_table_partition::run_command(response &_return, const arg_list &args)
       LOG(log_level::warn) << "Split slot range failed: " << e.what();
     }
   }
-  if (auto_scale_ && cmd_name == "remove" && underload() && metadata_ != "exporting" && metadata_ != "importing"
+  if (auto_scale_ && (cmd_id == hash_table_cmd_id::ht_remove || cmd_id == hash_table_cmd_id::ht_multi_remove)
+      && underload() && metadata_ != "exporting" && metadata_ != "importing"
       && name() != "0_65536" && is_tail() && !scaling_down_ && !scaling_up_) {
     LOG(log_level::info) << "Underloaded partition; storage = " << storage_size() << " capacity = "
                          << storage_capacity() << " slot range = (" << slot_begin() << ", " << slot_end() << ")";
@@ -900,17 +732,31 @@ bool hash_table_partition::is_dirty() const {
 }
 
 void hash_table_partition::load(const std::string &path) {
+  wait_persisted();
   auto remote = persistent::persistent_store::instance(path, ser_);
   auto decomposed = persistent::persistent_store::decompose_path(path);
+  if (decomposed.first == "local") {
+    // Fold local store writes into the table file before reading it
+    auto file_path = directory_utils::remove_uri(path);
+    if (local_store_ != nullptr && local_store_->path() == file_path) {
+      local_store_->compact();
+    } else if (hash_table_local_store::has_log(file_path)) {
+      hash_table_local_store store(file_path, ser_name_);
+      if (store.open()) {
+        store.compact();
+      }
+    }
+  }
   remote->read<hash_table_type>(decomposed.second, block_);
+  if (incremental_sync_) {
+    replay_deltas(path);
+  }
 }
 
 bool hash_table_partition::sync(const std::string &path) {
   if (dirty_) {
-    auto remote = persistent::persistent_store::instance(path, ser_);
-    auto decomposed = persistent::persistent_store::decompose_path(path);
-    remote->write<hash_table_type>(block_, decomposed.second);
-    dirty_ = false;
+    close_local_store(path);
+    persist(path, true);
     return true;
   }
   return false;
@@ -919,12 +765,14 @@ bool hash_table_partition::sync(const std::string &path) {
 bool hash_table_partition::dump(const std::string &path) {
   bool flushed = false;
   if (dirty_) {
-    auto remote = persistent::persistent_store::instance(path, ser_);
-    auto decomposed = persistent::persistent_store::decompose_path(path);
-    remote->write<hash_table_type>(block_, decomposed.second);
+    close_local_store(path);
+    // The file counts as persisted once dump returns
+    persist(path, false);
     flushed = true;
   }
+  wait_persisted();
   block_.clear();
+  reset_deltas();
   next_->reset("nil");
   path_ = "";
   sub_map_.clear();
@@ -947,6 +795,29 @@ void hash_table_partition::forward_all() {
   }
 }
 
+void hash_table_partition::notify(const arg_list &args) {
+  switch (command_id(args.front())) {
+    case hash_table_cmd_id::ht_multi_put:
+      for (std::size_t i = 1; i + 1 < args.size(); i += 2)
+        subscriptions().notify(command_name(hash_table_cmd_id::ht_put), args[i]);
+      break;
+    case hash_table_cmd_id::ht_multi_upsert:
+    case hash_table_cmd_id::ht_bulk_load:
+      for (std::size_t i = 1; i + 1 < args.size(); i += 2)
+        subscriptions().notify(command_name(hash_table_cmd_id::ht_upsert), args[i]);
+      break;
+    case hash_table_cmd_id::ht_multi_remove:
+      for (std::size_t i = 1; i < args.size(); ++i)
+        subscriptions().notify(command_name(hash_table_cmd_id::ht_remove), args[i]);
+      break;
+    case hash_table_cmd_id::ht_multi_get:
+      for (std::size_t i = 1; i < args.size(); ++i)
+        subscriptions().notify(command_name(hash_table_cmd_id::ht_get), args[i]);
+      break;
+    default:partition::notify(args);
+  }
+}
+
 bool hash_table_partition::overload() {
   return storage_size() > static_cast<size_t>(static_cast<double>(storage_capacity()) * threshold_hi_);
 }
@@ -967,6 +838,244 @@ void hash_table_partition::buffer_remove() {
   remove_cache_.clear();
 }
 
+void hash_table_partition::track_delta(const arg_list &args) {
+  switch (command_id(args[0])) {
+    case hash_table_cmd_id::ht_put:
+    case hash_table_cmd_id::ht_upsert:
+    case hash_table_cmd_id::ht_update:
+    case hash_table_cmd_id::ht_remove:
+      if (args.size() > 1)
+        delta_keys_.insert(args[1]);
+      break;
+    case hash_table_cmd_id::ht_multi_put:
+    case hash_table_cmd_id::ht_multi_upsert:
+    case hash_table_cmd_id::ht_bulk_load:
+    case hash_table_cmd_id::ht_scale_put:
+      for (std::size_t i = 1; i + 1 < args.size(); i += 2)
+        delta_keys_.insert(args[i]);
+      break;
+    case hash_table_cmd_id::ht_multi_remove:
+    case hash_table_cmd_id::ht_scale_remove:
+      for (std::size_t i = 1; i < args.size(); ++i)
+        delta_keys_.insert(args[i]);
+      break;
+    default:
+      // Local store writes and partition updates change the table in bulk
+      snapshot_required_ = true;
+  }
+}
+
+void hash_table_partition::persist(const std::string &path, bool background) {
+  wait_persisted();
+  background = background && background_sync_;
+  std::function<void()> job;
+  {
+    // Mutators only wait while the state to write is captured, not while it is written
+    std::unique_lock<std::mutex> mutator_lock(mutator_mtx_, std::defer_lock);
+    if (incremental_sync_ || background_sync_) {
+      mutator_lock.lock();
+    }
+    job = capture(path, background);
+  }
+  if (!background) {
+    try {
+      job();
+    } catch (std::exception &e) {
+      std::unique_lock<std::mutex> mutator_lock(mutator_mtx_, std::defer_lock);
+      if (incremental_sync_ || background_sync_) {
+        mutator_lock.lock();
+      }
+      dirty_ = true;
+      snapshot_required_ = true;
+      throw;
+    }
+    return;
+  }
+  std::unique_lock<std::mutex> lock(persist_mtx_);
+  persist_job_ = std::move(job);
+  persist_cv_.notify_all();
+}
+
+std::function<void()> hash_table_partition::capture(const std::string &path, bool background) {
+  dirty_ = false;
+  auto remote = persistent::persistent_store::instance(path, ser_);
+  auto key = persistent::persistent_store::decompose_path(path).second;
+  if (!incremental_sync_) {
+    return capture_table(remote, key, background);
+  }
+  if (snapshot_required_ || path != snapshot_path_ || num_deltas_ >= max_deltas_ || delta_bytes_ >= snapshot_bytes_) {
+    return capture_snapshot(remote, path, background);
+  }
+  if (delta_keys_.empty()) {
+    return [] {};
+  }
+  auto delta = std::make_shared<hash_table_delta_type>();
+  delta->epoch = epoch_;
+  std::size_t bytes = 0;
+  for (const auto &k: delta_keys_) {
+    auto it = block_.end();
+    try {
+      it = block_.find(make_temporary_binary(k));
+    } catch (std::bad_alloc &e) {
+      // The key could not be looked up, so its state is unknown and the whole table is written instead
+      snapshot_required_ = true;
+      return capture_snapshot(remote, path, background);
+    }
+    if (it != block_.end()) {
+      delta->upserts.emplace_back(k, to_string(it->second));
+      bytes += k.size() + it->second.size();
+    } else {
+      delta->removes.push_back(k);
+      bytes += k.size();
+    }
+  }
+  ++num_deltas_;
+  delta_bytes_ += bytes;
+  delta_keys_.clear();
+  auto bytes_per_sec = background ? sync_bytes_per_sec_ : 0;
+  return [remote, delta, bytes, bytes_per_sec, path = delta_path(key, num_deltas_)] {
+    remote->write<hash_table_delta_type>(*delta, path);
+    // Deltas are written whole, and the writes that follow are held back instead
+    utils::rate_limiter(bytes_per_sec).acquire(bytes);
+  };
+}
+
+std::function<void()> hash_table_partition::capture_table(std::shared_ptr<persistent::persistent_service> remote,
+                                                          const std::string &key,
+                                                          bool background) {
+  if (!incremental_sync_ && !background_sync_) {
+    // Mutators do not wait for sync, so the table is written as it is
+    return [this, remote, key] {
+      remote->write<hash_table_type>(block_, key);
+    };
+  }
+  std::shared_ptr<hash_table_snapshot_type> snapshot;
+  try {
+    snapshot = std::make_shared<hash_table_snapshot_type>(block_, binary_allocator_, sync_copy_bytes_,
+                                                          background ? sync_bytes_per_sec_ : 0);
+  } catch (std::bad_alloc &e) {
+    // The copy does not fit, so mutators wait while the table is written in place
+    return [this, remote, key] {
+      std::unique_lock<std::mutex> mutator_lock(mutator_mtx_);
+      remote->write<hash_table_type>(block_, key);
+    };
+  }
+  return [remote, key, snapshot] {
+    remote->write<hash_table_snapshot_type>(*snapshot, key);
+  };
+}
+
+std::function<void()> hash_table_partition::capture_snapshot(std::shared_ptr<persistent::persistent_service> remote,
+                                                             const std::string &path,
+                                                             bool background) {
+  auto key = persistent::persistent_store::decompose_path(path).second;
+  auto write_table = capture_table(remote, key, background);
+  auto epoch = std::max(time_utils::now_us(), epoch_ + 1);
+  snapshot_path_ = path;
+  epoch_ = epoch;
+  num_deltas_ = 0;
+  delta_bytes_ = 0;
+  snapshot_bytes_ = storage_size();
+  delta_keys_.clear();
+  snapshot_required_ = false;
+  return [remote, write_table, epoch, marker_path = delta_path(key, 0)] {
+    // The deltas of the previous snapshot are retired before it is replaced, so that a crash
+    // in between leaves the previous snapshot alone rather than old deltas over a new snapshot;
+    // the local store writes the new snapshot aside and renames it over the previous one
+    hash_table_delta_type marker;
+    remote->write<hash_table_delta_type>(marker, marker_path);
+    write_table();
+    marker.epoch = epoch;
+    remote->write<hash_table_delta_type>(marker, marker_path);
+  };
+}
+
+void hash_table_partition::persist_loop() {
+  std::unique_lock<std::mutex> lock(persist_mtx_);
+  while (true) {
+    persist_cv_.wait(lock, [this] { return stop_persister_ || persist_job_ != nullptr; });
+    // A pending write is finished before stopping
+    if (persist_job_ == nullptr) {
+      break;
+    }
+    auto job = persist_job_;
+    lock.unlock();
+    try {
+      job();
+    } catch (std::exception &e) {
+      LOG(log_level::error) << "Background sync of partition " << name() << " failed: " << e.what();
+      std::unique_lock<std::mutex> mutator_lock(mutator_mtx_);
+      dirty_ = true;
+      snapshot_required_ = true;
+    }
+    lock.lock();
+    persist_job_ = nullptr;
+    persist_cv_.notify_all();
+  }
+}
+
+void hash_table_partition::wait_persisted() {
+  std::unique_lock<std::mutex> lock(persist_mtx_);
+  persist_cv_.wait(lock, [this] { return persist_job_ == nullptr; });
+}
+
+void hash_table_partition::replay_deltas(const std::string &path) {
+  auto remote = persistent::persistent_store::instance(path, ser_);
+  auto decomposed = persistent::persistent_store::decompose_path(path);
+  reset_deltas();
+  hash_table_delta_type marker;
+  try {
+    remote->read<hash_table_delta_type>(delta_path(decomposed.second, 0), marker);
+  } catch (std::exception &e) {
+    // Written without incremental sync
+    return;
+  }
+  if (!marker.found || marker.epoch == 0) {
+    return;
+  }
+  for (std::size_t num = 1;; ++num) {
+    hash_table_delta_type delta;
+    try {
+      remote->read<hash_table_delta_type>(delta_path(decomposed.second, num), delta);
+    } catch (std::exception &e) {
+      break;
+    }
+    // Deltas left over from earlier snapshots carry an older epoch
+    if (!delta.found || delta.epoch != marker.epoch) {
+      break;
+    }
+    for (const auto &key: delta.removes) {
+      block_.erase(make_temporary_binary(key));
+      delta_bytes_ += key.size();
+    }
+    for (const auto &e: delta.upserts) {
+      auto it = block_.find(make_temporary_binary(e.first));
+      if (it != block_.end()) {
+        it->second = make_binary(e.second);
+      } else {
+        block_.emplace(make_binary(e.first), make_binary(e.second));
+      }
+      delta_bytes_ += e.first.size() + e.second.size();
+    }
+    num_deltas_ = num;
+  }
+  // Later syncs keep adding deltas over the same snapshot
+  snapshot_path_ = path;
+  epoch_ = marker.epoch;
+  snapshot_bytes_ = storage_size();
+  snapshot_required_ = false;
+}
+
+void hash_table_partition::reset_deltas() {
+  delta_keys_.clear();
+  snapshot_required_ = true;
+  snapshot_path_.clear();
+  epoch_ = 0;
+  num_deltas_ = 0;
+  delta_bytes_ = 0;
+  snapshot_bytes_ = 0;
+}
+
 REGISTER_IMPLEMENTATION("hashtable", hash_table_partition);
 
 }
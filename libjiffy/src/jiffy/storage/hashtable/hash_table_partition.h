@@ -2,6 +2,12 @@
 #define JIFFY_KV_SERVICE_SHARD_H
 
 #include <string>
+#include <unordered_set>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <jiffy/utils/property_map.h>
 #include "jiffy/storage/serde/serde_all.h"
 #include "jiffy/storage/partition.h"
@@ -9,13 +15,14 @@
 #include "jiffy/storage/chain_module.h"
 #include "jiffy/storage/hashtable/hash_table_ops.h"
 #include "hash_table_defs.h"
+#include "hash_table_local_store.h"
 
 namespace jiffy {
 namespace storage {
 
-#define BEGIN_CATCH_HANDLER                       \
+#define BEGIN_CATCH_HANDLER(key)                  \
   try {                                           \
-  auto it = block_.find(make_binary(args[1]))
+  auto it = block_.find(make_temporary_binary(key))
 
 
 
@@ -43,7 +50,7 @@ class hash_table_partition : public chain_module {
   /**
    * @brief Virtual destructor
    */
-  ~hash_table_partition() override = default;
+  ~hash_table_partition() override;
 
   /**
    * @brief Set block hash slot range
@@ -196,7 +203,49 @@ class hash_table_partition : public chain_module {
    */
   void remove(response &_return, const arg_list &args);
 
- /**
+  /**
+   * @brief Get values for a batch of keys
+   * The response holds one sub-response per key, each prefixed by its length
+   * @param _return Response
+   * @param args Arguments
+   */
+  void multi_get(response &_return, const arg_list &args);
+
+  /**
+   * @brief Insert a batch of new key value pairs
+   * The response holds one sub-response per key, each prefixed by its length
+   * @param _return Response
+   * @param args Arguments
+   */
+  void multi_put(response &_return, const arg_list &args);
+
+  /**
+   * @brief Insert or update a batch of key value pairs
+   * The response holds one sub-response per key, each prefixed by its length
+   * @param _return Response
+   * @param args Arguments
+   */
+  void multi_upsert(response &_return, const arg_list &args);
+
+  /**
+   * @brief Remove a batch of keys
+   * The response holds one sub-response per key, each prefixed by its length
+   * @param _return Response
+   * @param args Arguments
+   */
+  void multi_remove(response &_return, const arg_list &args);
+
+  /**
+   * @brief Load a batch of key value pairs, updating keys that exist
+   * The batch is applied as a whole with a single response; it is rejected
+   * without changes if a key is outside the slot range, the slot range is
+   * being moved or the batch does not fit
+   * @param _return Response
+   * @param args Arguments
+   */
+  void bulk_load(response &_return, const arg_list &args);
+
+  /**
    * @brief Check if hash map contains key
    * @param _return Response
    * @param args Arguments
@@ -253,10 +302,11 @@ class hash_table_partition : public chain_module {
   void scale_put(response &_return, const arg_list &args);
 
   /**
-   * @brief Fetch data from keys which lie in slot range
-   * @param data Data to be fetched
+   * @brief Fetch a batch of key value pairs which lie in slot range, resuming the scan at a cursor
+   * Responds with the cursor to resume at, zero once the scan reached the end of the block,
+   * followed by the key value pairs
    * @param _return Response
-   * @param args Arguments
+   * @param args Arguments: slot begin, slot end, batch size and cursor
    */
   void get_data_in_slot_range(response &_return, const arg_list &args);
 
@@ -308,12 +358,15 @@ class hash_table_partition : public chain_module {
 
   /**
    * @brief Load persistent data into the block, lock the block while doing this
+   * With incremental sync, the deltas written after the snapshot are replayed on top of it
    * @param path Persistent storage path
    */
   void load(const std::string &path) override;
 
   /**
    * @brief If dirty, synchronize persistent storage and block
+   * With incremental sync, only the keys changed since the last sync are written, as a delta
+   * With background sync, a copy of the changes is taken and written on a background thread
    * @param path Persistent storage path
    * @return Bool value, true if block successfully synchronized
    */
@@ -331,6 +384,12 @@ class hash_table_partition : public chain_module {
    */
   void forward_all() override;
 
+  /**
+   * @brief Notify the listener, once per key for batched commands
+   * @param args Arguments
+   */
+  void notify(const arg_list &args) override;
+
  private:
   /**
    * @brief Check if block is overloaded
@@ -349,6 +408,144 @@ class hash_table_partition : public chain_module {
    */
   void buffer_remove();
 
+  /**
+   * @brief Fetch the local store over the partition's backing file, opening it if needed
+   * @return Local store, null if the backing file does not exist
+   */
+  hash_table_local_store *local_store();
+
+  /**
+   * @brief Close the local store and drop its logs before its file is rewritten
+   * @param path Persistent storage path being written
+   */
+  void close_local_store(const std::string &path);
+
+  /**
+   * @brief Record the keys changed by a mutator for the next incremental sync
+   * @param args Mutator arguments
+   */
+  void track_delta(const arg_list &args);
+
+  /**
+   * @brief Write the block to persistent storage, as a snapshot or as a delta over the last snapshot
+   * @param path Persistent storage path
+   * @param background Bool value, true if the write may finish after returning
+   */
+  void persist(const std::string &path, bool background);
+
+  /**
+   * @brief Capture the state of the block to persist and clear the dirty bit
+   * @param path Persistent storage path
+   * @param background Bool value, true if the write is paced for the background
+   * @return Write of the captured state
+   */
+  std::function<void()> capture(const std::string &path, bool background);
+
+  /**
+   * @brief Capture the whole block
+   * The block is copied if mutators may run during the write, or written in place while they
+   * wait if the copy does not fit
+   * @param remote Persistent service
+   * @param key Persistent store key
+   * @param background Bool value, true if the write is paced for the background
+   * @return Write of the block
+   */
+  std::function<void()> capture_table(std::shared_ptr<persistent::persistent_service> remote,
+                                      const std::string &key,
+                                      bool background);
+
+  /**
+   * @brief Capture the whole block and start a new epoch of deltas over it
+   * @param remote Persistent service
+   * @param path Persistent storage path
+   * @param background Bool value, true if the write is paced for the background
+   * @return Write of the snapshot and its epoch
+   */
+  std::function<void()> capture_snapshot(std::shared_ptr<persistent::persistent_service> remote,
+                                         const std::string &path,
+                                         bool background);
+
+  /**
+   * @brief Run background writes until stopped
+   */
+  void persist_loop();
+
+  /**
+   * @brief Wait for the background write in progress, if any
+   */
+  void wait_persisted();
+
+  /**
+   * @brief Replay the deltas of the snapshot just read into the block
+   * @param path Persistent storage path
+   */
+  void replay_deltas(const std::string &path);
+
+  /**
+   * @brief Reset the incremental sync state
+   */
+  void reset_deltas();
+
+  /**
+   * @brief Fetch the persistent path of a delta
+   * @param key Persistent store key of the snapshot
+   * @param num Delta number, 0 for the marker written along with the snapshot
+   * @return Persistent store key of the delta
+   */
+  static std::string delta_path(const std::string &key, std::size_t num) {
+    return key + "_delta_" + std::to_string(num);
+  }
+
+  /**
+   * @brief Insert new key value pair
+   * @param _return Response
+   * @param hash Hash slot of the key
+   * @param key Key
+   * @param value Value
+   * @param redirected Bool value, true if request was redirected from the exporting partition
+   */
+  void put_key(response &_return, int32_t hash, const std::string &key, const std::string &value, bool redirected);
+
+  /**
+   * @brief Insert or update key value pair, without redirection
+   * @param _return Response
+   * @param hash Hash slot of the key
+   * @param key Key
+   * @param value Value
+   */
+  void upsert_key(response &_return, int32_t hash, const std::string &key, const std::string &value);
+
+  /**
+   * @brief Get value for specified key
+   * @param _return Response
+   * @param hash Hash slot of the key
+   * @param key Key
+   * @param redirected Bool value, true if request was redirected from the exporting partition
+   */
+  void get_key(response &_return, int32_t hash, const std::string &key, bool redirected);
+
+  /**
+   * @brief Remove value for specified key
+   * @param _return Response
+   * @param hash Hash slot of the key
+   * @param key Key
+   * @param mode Empty for ordinary remove, "!redirected" or "!buffered" otherwise
+   */
+  void remove_key(response &_return, int32_t hash, const std::string &key, const std::string &mode);
+
+  /**
+   * @brief Append a single key's response to a batched response
+   * @param _return Batched response
+   * @param key_return Response for the key, consumed
+   */
+  void append_key_response(response &_return, response &key_return) {
+    _return.emplace_back(std::to_string(key_return.size()));
+    for (auto &r: key_return) {
+      _return.emplace_back(std::move(r));
+    }
+    key_return.clear();
+  }
+
   /**
    * @brief Construct binary string for temporary values
    * @param str String
@@ -358,8 +555,20 @@ class hash_table_partition : public chain_module {
     return binary(str, temporary_data_allocator_);
   }
 
+  /**
+   * @brief Return ok status along with a value, copying the value out of block memory exactly once
+   * @param _return Response
+   * @param value Binary value
+   */
+  void return_value(response &_return, const binary &value) {
+    _return.clear();
+    _return.reserve(2);
+    _return.emplace_back("!ok");
+    _return.emplace_back(reinterpret_cast<const char *>(value.data()), value.size());
+  }
+
   /* Cuckoo hash map partition */
-  std::unordered_map<key_type, value_type, hash_type, equal_type> block_;
+  hash_table_type block_;
 
   /* Custom serializer/deserializer */
   std::shared_ptr<serde> ser_;
@@ -380,7 +589,7 @@ class hash_table_partition : public chain_module {
   bool scaling_down_;
 
   /* Bool partition dirty bit */
-  bool dirty_;
+  std::atomic_bool dirty_;
 
   /* Hash slot range */
   std::pair<int32_t, int32_t> slot_range_;
@@ -418,6 +627,63 @@ class hash_table_partition : public chain_module {
   /* Temporary data manager */
   block_memory_manager* temporary_data_manager_;
 
+  /* Indexed local store over the backing file */
+  std::unique_ptr<hash_table_local_store> local_store_;
+
+  /* Bool value, true if sync writes deltas over a snapshot instead of the whole block */
+  bool incremental_sync_;
+
+  /* Number of deltas after which the next sync writes a snapshot */
+  std::size_t max_deltas_;
+
+  /* Keys changed since the last sync */
+  std::unordered_set<std::string> delta_keys_;
+
+  /* Bool value, true if the next sync must write a snapshot */
+  bool snapshot_required_;
+
+  /* Persistent path of the last snapshot */
+  std::string snapshot_path_;
+
+  /* Epoch of the last snapshot */
+  uint64_t epoch_;
+
+  /* Number of deltas written over the last snapshot */
+  std::size_t num_deltas_;
+
+  /* Bytes written as deltas over the last snapshot */
+  std::size_t delta_bytes_;
+
+  /* Storage size at the last snapshot */
+  std::size_t snapshot_bytes_;
+
+  /* Bool value, true if sync writes to persistent storage on a background thread */
+  bool background_sync_;
+
+  /* Number of bytes per second background writes are limited to, 0 for no limit */
+  std::size_t sync_bytes_per_sec_;
+
+  /* Maximum number of bytes a sync may copy, larger tables are written in place */
+  std::size_t sync_copy_bytes_;
+
+  /* Mutator mutex, taken with incremental or background sync, held while the state to persist is captured */
+  std::mutex mutator_mtx_;
+
+  /* Background write mutex */
+  std::mutex persist_mtx_;
+
+  /* Condition variable for background writes */
+  std::condition_variable persist_cv_;
+
+  /* Background write waiting or in progress, null if there is none */
+  std::function<void()> persist_job_;
+
+  /* Bool value, true if the background writer should stop */
+  bool stop_persister_;
+
+  /* Background writer thread */
+  std::thread persister_;
+
 };
 
 }
@@ -0,0 +1,495 @@
+#ifndef JIFFY_OPEN_HASH_TABLE_H
+#define JIFFY_OPEN_HASH_TABLE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace jiffy {
+namespace storage {
+
+/* Open addressing hash table class
+ * Linear probing over a flat array of 8 byte slots, each holding a 32 bit
+ * fragment of the key hash next to the index of its entry, so a probe only
+ * touches a key when the fragments match. Entries live in fixed size chunks
+ * and never move: growing the table only rebuilds the slot array, and
+ * references to entries stay valid until the entry is erased. Erasing uses
+ * backward shift deletion, so probe sequences never accumulate tombstones.
+ * The slot array and the chunks are both obtained from the allocator, so
+ * with a block memory allocator the index counts against the block capacity. */
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator = std::allocator<uint8_t>>
+class open_hash_table {
+ public:
+  typedef std::pair<const Key, Value> value_type;
+  typedef std::size_t size_type;
+
+  /* Forward iterator over the entries, in slot order */
+  template<bool Const>
+  class iterator_base {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef typename open_hash_table::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef typename std::conditional<Const, const value_type, value_type>::type &reference;
+    typedef typename std::conditional<Const, const value_type, value_type>::type *pointer;
+    typedef typename std::conditional<Const, const open_hash_table, open_hash_table>::type table_type;
+
+    iterator_base() : table_(nullptr), pos_(0) {}
+
+    iterator_base(table_type *table, size_type pos) : table_(table), pos_(pos) {
+      skip_empty();
+    }
+
+    template<bool C, typename = typename std::enable_if<Const && !C>::type>
+    iterator_base(const iterator_base<C> &other) : table_(other.table_), pos_(other.pos_) {}
+
+    reference operator*() const {
+      return table_->entry(table_->slots_[pos_].entry);
+    }
+
+    pointer operator->() const {
+      return &(**this);
+    }
+
+    iterator_base &operator++() {
+      ++pos_;
+      skip_empty();
+      return *this;
+    }
+
+    iterator_base operator++(int) {
+      auto it = *this;
+      ++(*this);
+      return it;
+    }
+
+    bool operator==(const iterator_base &other) const {
+      return pos_ == other.pos_;
+    }
+
+    bool operator!=(const iterator_base &other) const {
+      return pos_ != other.pos_;
+    }
+
+   private:
+    friend class open_hash_table;
+    template<bool C> friend
+    class iterator_base;
+
+    void skip_empty() {
+      while (pos_ < table_->slots_.size() && table_->slots_[pos_].entry == EMPTY) {
+        ++pos_;
+      }
+    }
+
+    table_type *table_;
+    size_type pos_;
+  };
+
+  typedef iterator_base<false> iterator;
+  typedef iterator_base<true> const_iterator;
+
+  /**
+   * @brief Constructor
+   * @param allocator Allocator for the slots and the entry chunks
+   * @param hash Hash function
+   * @param equal Key equality function
+   */
+  explicit open_hash_table(const Allocator &allocator = Allocator(),
+                           const Hash &hash = Hash(),
+                           const Equal &equal = Equal())
+      : slots_(slot_allocator(allocator)),
+        chunks_(chunk_list_allocator(allocator)),
+        chunk_allocator_(allocator),
+        free_head_(EMPTY),
+        next_entry_(0),
+        size_(0),
+        hash_(hash),
+        equal_(equal) {}
+
+  open_hash_table(const open_hash_table &) = delete;
+
+  open_hash_table &operator=(const open_hash_table &) = delete;
+
+  open_hash_table(open_hash_table &&other) noexcept
+      : slots_(std::move(other.slots_)),
+        chunks_(std::move(other.chunks_)),
+        chunk_allocator_(other.chunk_allocator_),
+        free_head_(other.free_head_),
+        next_entry_(other.next_entry_),
+        size_(other.size_),
+        hash_(std::move(other.hash_)),
+        equal_(std::move(other.equal_)) {
+    other.reset();
+  }
+
+  open_hash_table &operator=(open_hash_table &&other) noexcept {
+    if (this != &other) {
+      clear();
+      slots_ = std::move(other.slots_);
+      chunks_ = std::move(other.chunks_);
+      chunk_allocator_ = other.chunk_allocator_;
+      free_head_ = other.free_head_;
+      next_entry_ = other.next_entry_;
+      size_ = other.size_;
+      hash_ = std::move(other.hash_);
+      equal_ = std::move(other.equal_);
+      other.reset();
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Destructor
+   */
+  ~open_hash_table() {
+    clear();
+  }
+
+  iterator begin() {
+    return iterator(this, 0);
+  }
+
+  iterator end() {
+    return iterator(this, slots_.size());
+  }
+
+  const_iterator begin() const {
+    return const_iterator(this, 0);
+  }
+
+  const_iterator end() const {
+    return const_iterator(this, slots_.size());
+  }
+
+  /**
+   * @brief Find entry for key
+   * @param key Key
+   * @return Iterator to the entry, end() if key does not exist
+   */
+  template<typename K>
+  iterator find(const K &key) {
+    return iterator(this, find_slot(key, tag(key)));
+  }
+
+  template<typename K>
+  const_iterator find(const K &key) const {
+    return const_iterator(this, find_slot(key, tag(key)));
+  }
+
+  /**
+   * @brief Construct entry in place if its key does not exist
+   * The key is looked up first, so an existing key costs no entry
+   * @param key Key
+   * @param value Value
+   * @return Iterator to the entry with the key, and whether the entry was inserted
+   */
+  template<typename K, typename V>
+  std::pair<iterator, bool> emplace(K &&key, V &&value) {
+    return emplace_key(key, std::forward<K>(key), std::forward<V>(value));
+  }
+
+  /**
+   * @brief Insert key value pair if its key does not exist
+   * @param kv Key value pair
+   * @return Iterator to the entry with the key, and whether the entry was inserted
+   */
+  template<typename P>
+  std::pair<iterator, bool> emplace(P &&kv) {
+    return emplace_key(kv.first, std::forward<P>(kv));
+  }
+
+  /**
+   * @brief Erase entry for key
+   * @param key Key
+   * @return Number of entries erased
+   */
+  template<typename K>
+  size_type erase(const K &key) {
+    auto pos = find_slot(key, tag(key));
+    if (pos == slots_.size()) {
+      return 0;
+    }
+    erase_slot(pos);
+    return 1;
+  }
+
+  /**
+   * @brief Size the slot array so that a number of entries fit without growing it
+   * @param n Number of entries
+   */
+  void reserve(size_type n) {
+    size_type slots = MIN_SLOTS;
+    while (n * MAX_LOAD_DEN > slots * MAX_LOAD_NUM) {
+      slots *= 2;
+    }
+    if (slots > slots_.size()) {
+      rehash(slots);
+    }
+  }
+
+  /**
+   * @brief Erase all entries and free memory
+   */
+  void clear() {
+    for (const auto &s: slots_) {
+      if (s.entry != EMPTY) {
+        entry(s.entry).~value_type();
+      }
+    }
+    slots_.clear();
+    slots_.shrink_to_fit();
+    for (auto chunk: chunks_) {
+      chunk_allocator_.deallocate(chunk, CHUNK_SIZE);
+    }
+    chunks_.clear();
+    chunks_.shrink_to_fit();
+    free_head_ = EMPTY;
+    next_entry_ = 0;
+    size_ = 0;
+  }
+
+  size_type size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  /**
+   * @brief Fetch number of slots
+   * @return Number of slots
+   */
+  size_type slot_count() const {
+    return slots_.size();
+  }
+
+  /**
+   * @brief Visit entries in slot order, starting at a slot
+   * @param pos First slot to visit
+   * @param f Visitor called with each entry, returns false to stop the scan
+   * @return Slot to resume the scan at, slot_count() once all slots have been visited
+   */
+  template<typename F>
+  size_type scan(size_type pos, F &&f) const {
+    for (; pos < slots_.size(); ++pos) {
+      if (slots_[pos].entry != EMPTY && !f(entry(slots_[pos].entry))) {
+        return pos + 1;
+      }
+    }
+    return slots_.size();
+  }
+
+  /**
+   * @brief Fetch bytes used by the table itself, excluding memory owned by keys and values
+   * @return Bytes used
+   */
+  size_type footprint() const {
+    return slots_.capacity() * sizeof(slot) + chunks_.size() * CHUNK_SIZE * sizeof(storage_type)
+        + chunks_.capacity() * sizeof(storage_type *);
+  }
+
+ private:
+  /* Slot, empty if entry is EMPTY */
+  struct slot {
+    uint32_t tag;
+    uint32_t entry;
+  };
+
+  typedef typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage_type;
+  typedef typename std::allocator_traits<Allocator>::template rebind_alloc<slot> slot_allocator;
+  typedef typename std::allocator_traits<Allocator>::template rebind_alloc<storage_type> chunk_allocator;
+  typedef typename std::allocator_traits<Allocator>::template rebind_alloc<storage_type *> chunk_list_allocator;
+
+  static constexpr uint32_t EMPTY = UINT32_MAX;
+  static constexpr size_type CHUNK_SIZE = 1024;
+  static constexpr size_type MIN_SLOTS = 16;
+  static constexpr size_type MAX_LOAD_NUM = 3;
+  static constexpr size_type MAX_LOAD_DEN = 4;
+
+  /**
+   * @brief Mix key hash into the slot tag, the low bits pick the home slot
+   * @param key Key
+   * @return Tag
+   */
+  template<typename K>
+  uint32_t tag(const K &key) const {
+    uint64_t h = hash_(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<uint32_t>(h);
+  }
+
+  template<typename K, typename... Args>
+  std::pair<iterator, bool> emplace_key(const K &key, Args &&... args) {
+    auto t = tag(key);
+    auto pos = find_slot(key, t);
+    if (pos != slots_.size()) {
+      return std::make_pair(iterator(this, pos), false);
+    }
+    if ((size_ + 1) * MAX_LOAD_DEN > slots_.size() * MAX_LOAD_NUM) {
+      rehash(std::max<size_type>(slots_.size() * 2, MIN_SLOTS));
+    }
+    auto idx = allocate_entry();
+    try {
+      new(&storage(idx)) value_type(std::forward<Args>(args)...);
+    } catch (...) {
+      release_entry(idx);
+      throw;
+    }
+    pos = insert_slot(t, idx);
+    ++size_;
+    return std::make_pair(iterator(this, pos), true);
+  }
+
+  template<typename K>
+  size_type find_slot(const K &key, uint32_t t) const {
+    if (size_ == 0) {
+      return slots_.size();
+    }
+    auto mask = slots_.size() - 1;
+    for (auto pos = t & mask;; pos = (pos + 1) & mask) {
+      const auto &s = slots_[pos];
+      if (s.entry == EMPTY) {
+        return slots_.size();
+      }
+      if (s.tag == t && equal_(entry(s.entry).first, key)) {
+        return pos;
+      }
+    }
+  }
+
+  size_type insert_slot(uint32_t t, uint32_t idx) {
+    auto mask = slots_.size() - 1;
+    auto pos = t & mask;
+    while (slots_[pos].entry != EMPTY) {
+      pos = (pos + 1) & mask;
+    }
+    slots_[pos].tag = t;
+    slots_[pos].entry = idx;
+    return pos;
+  }
+
+  void erase_slot(size_type pos) {
+    destroy_entry(slots_[pos].entry);
+    --size_;
+    auto mask = slots_.size() - 1;
+    auto hole = pos;
+    for (auto next = (hole + 1) & mask; slots_[next].entry != EMPTY; next = (next + 1) & mask) {
+      auto home = slots_[next].tag & mask;
+      // Shift back unless the hole lies before the entry's home slot in its probe sequence
+      if (((next - home) & mask) >= ((next - hole) & mask)) {
+        slots_[hole] = slots_[next];
+        hole = next;
+      }
+    }
+    slots_[hole].entry = EMPTY;
+  }
+
+  void rehash(size_type n) {
+    std::vector<slot, slot_allocator> slots(n, slot{0, EMPTY}, slots_.get_allocator());
+    slots.swap(slots_);
+    for (const auto &s: slots) {
+      if (s.entry != EMPTY) {
+        insert_slot(s.tag, s.entry);
+      }
+    }
+  }
+
+  uint32_t allocate_entry() {
+    if (free_head_ != EMPTY) {
+      auto idx = free_head_;
+      free_head_ = *reinterpret_cast<uint32_t *>(&storage(idx));
+      return idx;
+    }
+    if (next_entry_ == EMPTY) {
+      throw std::bad_alloc();
+    }
+    if (next_entry_ / CHUNK_SIZE == chunks_.size()) {
+      auto chunk = chunk_allocator_.allocate(CHUNK_SIZE);
+      try {
+        chunks_.push_back(chunk);
+      } catch (...) {
+        chunk_allocator_.deallocate(chunk, CHUNK_SIZE);
+        throw;
+      }
+    }
+    return next_entry_++;
+  }
+
+  void release_entry(uint32_t idx) {
+    // Free entries are threaded through their own storage
+    *reinterpret_cast<uint32_t *>(&storage(idx)) = free_head_;
+    free_head_ = idx;
+  }
+
+  void destroy_entry(uint32_t idx) {
+    entry(idx).~value_type();
+    release_entry(idx);
+  }
+
+  storage_type &storage(uint32_t idx) {
+    return chunks_[idx / CHUNK_SIZE][idx % CHUNK_SIZE];
+  }
+
+  value_type &entry(uint32_t idx) {
+    return *reinterpret_cast<value_type *>(&storage(idx));
+  }
+
+  const value_type &entry(uint32_t idx) const {
+    return *reinterpret_cast<const value_type *>(&chunks_[idx / CHUNK_SIZE][idx % CHUNK_SIZE]);
+  }
+
+  void reset() {
+    slots_.clear();
+    chunks_.clear();
+    free_head_ = EMPTY;
+    next_entry_ = 0;
+    size_ = 0;
+  }
+
+  /* Slots */
+  std::vector<slot, slot_allocator> slots_;
+  /* Entry storage chunks, each holding CHUNK_SIZE entries */
+  std::vector<storage_type *, chunk_list_allocator> chunks_;
+  /* Allocator for the entry storage chunks */
+  chunk_allocator chunk_allocator_;
+  /* Head of the free entry list */
+  uint32_t free_head_;
+  /* Number of entries handed out from the chunks */
+  uint32_t next_entry_;
+  /* Number of entries */
+  size_type size_;
+  /* Hash function */
+  Hash hash_;
+  /* Key equality function */
+  Equal equal_;
+};
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+constexpr uint32_t open_hash_table<Key, Value, Hash, Equal, Allocator>::EMPTY;
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+constexpr std::size_t open_hash_table<Key, Value, Hash, Equal, Allocator>::CHUNK_SIZE;
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+constexpr std::size_t open_hash_table<Key, Value, Hash, Equal, Allocator>::MIN_SLOTS;
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+constexpr std::size_t open_hash_table<Key, Value, Hash, Equal, Allocator>::MAX_LOAD_NUM;
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Allocator>
+constexpr std::size_t open_hash_table<Key, Value, Hash, Equal, Allocator>::MAX_LOAD_DEN;
+
+}
+}
+
+#endif //JIFFY_OPEN_HASH_TABLE_H
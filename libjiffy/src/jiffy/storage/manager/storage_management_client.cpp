@@ -97,5 +97,9 @@ void storage_management_client::update_partition(const int32_t block_id,
   client_->update_partition_data(block_id, partition_name, partition_metadata);
 }
 
+void storage_management_client::create_partitions(const std::vector<rpc_partition_setup> &partitions) {
+  client_->create_partitions(partitions);
+}
+
 }
 }
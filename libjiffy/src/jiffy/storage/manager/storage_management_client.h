@@ -148,6 +148,13 @@ class storage_management_client {
                         const std::string &partition_name,
                         const std::string &partition_metadata);
 
+  /**
+   * @brief Create partitions and set up their replica chains in one call
+   * @param partitions Partition and chain setup for each block
+   */
+
+  void create_partitions(const std::vector<rpc_partition_setup> &partitions);
+
  private:
   /* Socket */
   std::shared_ptr<apache::thrift::transport::TSocket> socket_{};
@@ -201,5 +201,20 @@ storage_management_service_update_partition_data_result::~storage_management_ser
 storage_management_service_update_partition_data_presult::~storage_management_service_update_partition_data_presult() throw() {
 }
 
+storage_management_service_create_partitions_args::~storage_management_service_create_partitions_args() throw() {
+}
+
+
+storage_management_service_create_partitions_pargs::~storage_management_service_create_partitions_pargs() throw() {
+}
+
+
+storage_management_service_create_partitions_result::~storage_management_service_create_partitions_result() throw() {
+}
+
+
+storage_management_service_create_partitions_presult::~storage_management_service_create_partitions_presult() throw() {
+}
+
 }} // namespace
 
@@ -33,6 +33,7 @@ class storage_management_serviceIf {
   virtual void resend_pending(const int32_t block_id) = 0;
   virtual void forward_all(const int32_t block_id) = 0;
   virtual void update_partition_data(const int32_t block_id, const std::string& partition_name, const std::string& partition_metadata) = 0;
+  virtual void create_partitions(const std::vector<rpc_partition_setup> & partitions) = 0;
 };
 
 class storage_management_serviceIfFactory {
@@ -100,6 +101,9 @@ class storage_management_serviceNull : virtual public storage_management_service
   void update_partition_data(const int32_t /* block_id */, const std::string& /* partition_name */, const std::string& /* partition_metadata */) {
     return;
   }
+  void create_partitions(const std::vector<rpc_partition_setup> & /* partitions */) {
+    return;
+  }
 };
 
 typedef struct _storage_management_service_create_partition_args__isset {
@@ -1544,6 +1548,116 @@ class storage_management_service_update_partition_data_presult {
 
 };
 
+typedef struct _storage_management_service_create_partitions_args__isset {
+  _storage_management_service_create_partitions_args__isset() : partitions(false) {}
+  bool partitions :1;
+} _storage_management_service_create_partitions_args__isset;
+
+class storage_management_service_create_partitions_args {
+ public:
+
+  storage_management_service_create_partitions_args(const storage_management_service_create_partitions_args&);
+  storage_management_service_create_partitions_args& operator=(const storage_management_service_create_partitions_args&);
+  storage_management_service_create_partitions_args() {
+  }
+
+  virtual ~storage_management_service_create_partitions_args() throw();
+  std::vector<rpc_partition_setup>  partitions;
+
+  _storage_management_service_create_partitions_args__isset __isset;
+
+  void __set_partitions(const std::vector<rpc_partition_setup> & val);
+
+  bool operator == (const storage_management_service_create_partitions_args & rhs) const
+  {
+    if (!(partitions == rhs.partitions))
+      return false;
+    return true;
+  }
+  bool operator != (const storage_management_service_create_partitions_args &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const storage_management_service_create_partitions_args & ) const;
+
+  template <class Protocol_>
+  uint32_t read(Protocol_* iprot);
+  template <class Protocol_>
+  uint32_t write(Protocol_* oprot) const;
+
+};
+
+
+class storage_management_service_create_partitions_pargs {
+ public:
+
+
+  virtual ~storage_management_service_create_partitions_pargs() throw();
+  const std::vector<rpc_partition_setup> * partitions;
+
+  template <class Protocol_>
+  uint32_t write(Protocol_* oprot) const;
+
+};
+
+typedef struct _storage_management_service_create_partitions_result__isset {
+  _storage_management_service_create_partitions_result__isset() : ex(false) {}
+  bool ex :1;
+} _storage_management_service_create_partitions_result__isset;
+
+class storage_management_service_create_partitions_result {
+ public:
+
+  storage_management_service_create_partitions_result(const storage_management_service_create_partitions_result&);
+  storage_management_service_create_partitions_result& operator=(const storage_management_service_create_partitions_result&);
+  storage_management_service_create_partitions_result() {
+  }
+
+  virtual ~storage_management_service_create_partitions_result() throw();
+  storage_management_exception ex;
+
+  _storage_management_service_create_partitions_result__isset __isset;
+
+  void __set_ex(const storage_management_exception& val);
+
+  bool operator == (const storage_management_service_create_partitions_result & rhs) const
+  {
+    if (!(ex == rhs.ex))
+      return false;
+    return true;
+  }
+  bool operator != (const storage_management_service_create_partitions_result &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const storage_management_service_create_partitions_result & ) const;
+
+  template <class Protocol_>
+  uint32_t read(Protocol_* iprot);
+  template <class Protocol_>
+  uint32_t write(Protocol_* oprot) const;
+
+};
+
+typedef struct _storage_management_service_create_partitions_presult__isset {
+  _storage_management_service_create_partitions_presult__isset() : ex(false) {}
+  bool ex :1;
+} _storage_management_service_create_partitions_presult__isset;
+
+class storage_management_service_create_partitions_presult {
+ public:
+
+
+  virtual ~storage_management_service_create_partitions_presult() throw();
+  storage_management_exception ex;
+
+  _storage_management_service_create_partitions_presult__isset __isset;
+
+  template <class Protocol_>
+  uint32_t read(Protocol_* iprot);
+
+};
+
 template <class Protocol_>
 class storage_management_serviceClientT : virtual public storage_management_serviceIf {
  public:
@@ -1606,6 +1720,9 @@ class storage_management_serviceClientT : virtual public storage_management_serv
   void update_partition_data(const int32_t block_id, const std::string& partition_name, const std::string& partition_metadata);
   void send_update_partition_data(const int32_t block_id, const std::string& partition_name, const std::string& partition_metadata);
   void recv_update_partition_data();
+  void create_partitions(const std::vector<rpc_partition_setup> & partitions);
+  void send_create_partitions(const std::vector<rpc_partition_setup> & partitions);
+  void recv_create_partitions();
  protected:
   apache::thrift::stdcxx::shared_ptr< Protocol_> piprot_;
   apache::thrift::stdcxx::shared_ptr< Protocol_> poprot_;
@@ -1658,6 +1775,8 @@ class storage_management_serviceProcessorT : public ::apache::thrift::TDispatchP
   void process_forward_all(int32_t seqid, Protocol_* iprot, Protocol_* oprot, void* callContext);
   void process_update_partition_data(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
   void process_update_partition_data(int32_t seqid, Protocol_* iprot, Protocol_* oprot, void* callContext);
+  void process_create_partitions(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
+  void process_create_partitions(int32_t seqid, Protocol_* iprot, Protocol_* oprot, void* callContext);
  public:
   storage_management_serviceProcessorT(::apache::thrift::stdcxx::shared_ptr<storage_management_serviceIf> iface) :
     iface_(iface) {
@@ -1697,6 +1816,9 @@ class storage_management_serviceProcessorT : public ::apache::thrift::TDispatchP
     processMap_["update_partition_data"] = ProcessFunctions(
       &storage_management_serviceProcessorT::process_update_partition_data,
       &storage_management_serviceProcessorT::process_update_partition_data);
+    processMap_["create_partitions"] = ProcessFunctions(
+      &storage_management_serviceProcessorT::process_create_partitions,
+      &storage_management_serviceProcessorT::process_create_partitions);
   }
 
   virtual ~storage_management_serviceProcessorT() {}
@@ -1839,6 +1961,15 @@ class storage_management_serviceMultiface : virtual public storage_management_se
     ifaces_[i]->update_partition_data(block_id, partition_name, partition_metadata);
   }
 
+  void create_partitions(const std::vector<rpc_partition_setup> & partitions) {
+    size_t sz = ifaces_.size();
+    size_t i = 0;
+    for (; i < (sz - 1); ++i) {
+      ifaces_[i]->create_partitions(partitions);
+    }
+    ifaces_[i]->create_partitions(partitions);
+  }
+
 };
 
 // The 'concurrent' client is a thread safe client that correctly handles
@@ -1906,6 +2037,9 @@ class storage_management_serviceConcurrentClientT : virtual public storage_manag
   void update_partition_data(const int32_t block_id, const std::string& partition_name, const std::string& partition_metadata);
   int32_t send_update_partition_data(const int32_t block_id, const std::string& partition_name, const std::string& partition_metadata);
   void recv_update_partition_data(const int32_t seqid);
+  void create_partitions(const std::vector<rpc_partition_setup> & partitions);
+  int32_t send_create_partitions(const std::vector<rpc_partition_setup> & partitions);
+  void recv_create_partitions(const int32_t seqid);
  protected:
   apache::thrift::stdcxx::shared_ptr< Protocol_> piprot_;
   apache::thrift::stdcxx::shared_ptr< Protocol_> poprot_;
@@ -119,6 +119,19 @@ void storage_management_service_handler::update_partition_data(const int32_t blo
   }
 }
 
+void storage_management_service_handler::create_partitions(const std::vector<rpc_partition_setup> &partitions) {
+  try {
+    for (const auto &p: partitions) {
+      auto &b = blocks_.at(static_cast<std::size_t>(p.block_id));
+      b->setup(p.partition_type, p.backing_path, p.partition_name, p.partition_metadata, utils::property_map(p.conf));
+      b->impl()->setup(p.path, p.chain, static_cast<storage::chain_role>(p.chain_role), p.next_block_id);
+    }
+  } catch (std::exception &e) {
+    LOG(log_level::info) << "Caught exception: " << e.what();
+    throw make_exception(e);
+  }
+}
+
 storage_management_exception storage_management_service_handler::make_exception(std::exception &e) {
   storage_management_exception ex;
   ex.msg = e.what();
@@ -126,6 +126,13 @@ class storage_management_service_handler : public storage_management_serviceIf {
                              const std::string &partition_name,
                              const std::string &partition_metadata) override;
 
+  /**
+   * @brief Create partitions and set up their replica chains
+   * @param partitions Partition and chain setup for each block
+   */
+
+  void create_partitions(const std::vector<rpc_partition_setup> &partitions) override;
+
  private:
 
   /**
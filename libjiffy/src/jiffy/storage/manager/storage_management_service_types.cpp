@@ -61,4 +61,109 @@ const char* storage_management_exception::what() const throw() {
   }
 }
 
+rpc_partition_setup::~rpc_partition_setup() throw() {
+}
+
+
+void rpc_partition_setup::__set_block_id(const int32_t val) {
+  this->block_id = val;
+}
+
+void rpc_partition_setup::__set_partition_type(const std::string& val) {
+  this->partition_type = val;
+}
+
+void rpc_partition_setup::__set_backing_path(const std::string& val) {
+  this->backing_path = val;
+}
+
+void rpc_partition_setup::__set_partition_name(const std::string& val) {
+  this->partition_name = val;
+}
+
+void rpc_partition_setup::__set_partition_metadata(const std::string& val) {
+  this->partition_metadata = val;
+}
+
+void rpc_partition_setup::__set_conf(const std::map<std::string, std::string> & val) {
+  this->conf = val;
+}
+
+void rpc_partition_setup::__set_path(const std::string& val) {
+  this->path = val;
+}
+
+void rpc_partition_setup::__set_chain(const std::vector<std::string> & val) {
+  this->chain = val;
+}
+
+void rpc_partition_setup::__set_chain_role(const int32_t val) {
+  this->chain_role = val;
+}
+
+void rpc_partition_setup::__set_next_block_id(const std::string& val) {
+  this->next_block_id = val;
+}
+std::ostream& operator<<(std::ostream& out, const rpc_partition_setup& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+
+void swap(rpc_partition_setup &a, rpc_partition_setup &b) {
+  using ::std::swap;
+  swap(a.block_id, b.block_id);
+  swap(a.partition_type, b.partition_type);
+  swap(a.backing_path, b.backing_path);
+  swap(a.partition_name, b.partition_name);
+  swap(a.partition_metadata, b.partition_metadata);
+  swap(a.conf, b.conf);
+  swap(a.path, b.path);
+  swap(a.chain, b.chain);
+  swap(a.chain_role, b.chain_role);
+  swap(a.next_block_id, b.next_block_id);
+}
+
+rpc_partition_setup::rpc_partition_setup(const rpc_partition_setup& other16) {
+  block_id = other16.block_id;
+  partition_type = other16.partition_type;
+  backing_path = other16.backing_path;
+  partition_name = other16.partition_name;
+  partition_metadata = other16.partition_metadata;
+  conf = other16.conf;
+  path = other16.path;
+  chain = other16.chain;
+  chain_role = other16.chain_role;
+  next_block_id = other16.next_block_id;
+}
+rpc_partition_setup& rpc_partition_setup::operator=(const rpc_partition_setup& other17) {
+  block_id = other17.block_id;
+  partition_type = other17.partition_type;
+  backing_path = other17.backing_path;
+  partition_name = other17.partition_name;
+  partition_metadata = other17.partition_metadata;
+  conf = other17.conf;
+  path = other17.path;
+  chain = other17.chain;
+  chain_role = other17.chain_role;
+  next_block_id = other17.next_block_id;
+  return *this;
+}
+void rpc_partition_setup::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "rpc_partition_setup(";
+  out << "block_id=" << to_string(block_id);
+  out << ", " << "partition_type=" << to_string(partition_type);
+  out << ", " << "backing_path=" << to_string(backing_path);
+  out << ", " << "partition_name=" << to_string(partition_name);
+  out << ", " << "partition_metadata=" << to_string(partition_metadata);
+  out << ", " << "conf=" << to_string(conf);
+  out << ", " << "path=" << to_string(path);
+  out << ", " << "chain=" << to_string(chain);
+  out << ", " << "chain_role=" << to_string(chain_role);
+  out << ", " << "next_block_id=" << to_string(next_block_id);
+  out << ")";
+}
+
 }} // namespace
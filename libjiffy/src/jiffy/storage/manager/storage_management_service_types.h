@@ -22,6 +22,8 @@ namespace jiffy { namespace storage {
 
 class storage_management_exception;
 
+class rpc_partition_setup;
+
 typedef struct _storage_management_exception__isset {
   _storage_management_exception__isset() : msg(false) {}
   bool msg :1;
@@ -68,6 +70,89 @@ void swap(storage_management_exception &a, storage_management_exception &b);
 
 std::ostream& operator<<(std::ostream& out, const storage_management_exception& obj);
 
+
+class rpc_partition_setup {
+ public:
+
+  rpc_partition_setup(const rpc_partition_setup&);
+  rpc_partition_setup& operator=(const rpc_partition_setup&);
+  rpc_partition_setup() : block_id(0), partition_type(), backing_path(), partition_name(), partition_metadata(), path(), chain_role(0), next_block_id() {
+  }
+
+  virtual ~rpc_partition_setup() throw();
+  int32_t block_id;
+  std::string partition_type;
+  std::string backing_path;
+  std::string partition_name;
+  std::string partition_metadata;
+  std::map<std::string, std::string>  conf;
+  std::string path;
+  std::vector<std::string>  chain;
+  int32_t chain_role;
+  std::string next_block_id;
+
+  void __set_block_id(const int32_t val);
+
+  void __set_partition_type(const std::string& val);
+
+  void __set_backing_path(const std::string& val);
+
+  void __set_partition_name(const std::string& val);
+
+  void __set_partition_metadata(const std::string& val);
+
+  void __set_conf(const std::map<std::string, std::string> & val);
+
+  void __set_path(const std::string& val);
+
+  void __set_chain(const std::vector<std::string> & val);
+
+  void __set_chain_role(const int32_t val);
+
+  void __set_next_block_id(const std::string& val);
+
+  bool operator == (const rpc_partition_setup & rhs) const
+  {
+    if (!(block_id == rhs.block_id))
+      return false;
+    if (!(partition_type == rhs.partition_type))
+      return false;
+    if (!(backing_path == rhs.backing_path))
+      return false;
+    if (!(partition_name == rhs.partition_name))
+      return false;
+    if (!(partition_metadata == rhs.partition_metadata))
+      return false;
+    if (!(conf == rhs.conf))
+      return false;
+    if (!(path == rhs.path))
+      return false;
+    if (!(chain == rhs.chain))
+      return false;
+    if (!(chain_role == rhs.chain_role))
+      return false;
+    if (!(next_block_id == rhs.next_block_id))
+      return false;
+    return true;
+  }
+  bool operator != (const rpc_partition_setup &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const rpc_partition_setup & ) const;
+
+  template <class Protocol_>
+  uint32_t read(Protocol_* iprot);
+  template <class Protocol_>
+  uint32_t write(Protocol_* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(rpc_partition_setup &a, rpc_partition_setup &b);
+
+std::ostream& operator<<(std::ostream& out, const rpc_partition_setup& obj);
+
 }} // namespace
 
 #include "storage_management_service_types.tcc"
@@ -1,5 +1,7 @@
 #include "storage_manager.h"
 
+#include <future>
+
 #include "jiffy/storage/manager/detail/block_id_parser.h"
 #include "storage_management_client.h"
 #include "../../utils/logger.h"
@@ -103,5 +105,53 @@ void storage_manager::update_partition(const std::string &block_name,
   client.update_partition(bid.id, partition_name, partition_metadata);
 }
 
+void storage_manager::create_partitions(const std::vector<partition_setup> &partitions) {
+  std::map<std::pair<std::string, int32_t>, std::vector<rpc_partition_setup>> batches;
+  for (const auto &p: partitions) {
+    auto bid = block_id_parser::parse(p.block_id);
+    rpc_partition_setup setup;
+    setup.block_id = bid.id;
+    setup.partition_type = p.type;
+    setup.backing_path = p.backing_path;
+    setup.partition_name = p.name;
+    setup.partition_metadata = p.metadata;
+    setup.conf = p.conf;
+    setup.path = p.path;
+    setup.chain = p.chain;
+    setup.chain_role = p.role;
+    setup.next_block_id = p.next_block_id;
+    batches[std::make_pair(bid.host, bid.management_port)].push_back(std::move(setup));
+  }
+  auto send = [](const std::string &host, int32_t port, const std::vector<rpc_partition_setup> &batch) {
+    storage_management_client client(host, port);
+    LOG(log_level::info) << "Creating " << batch.size() << " partitions on " << host << ":" << port;
+    client.create_partitions(batch);
+  };
+  if (batches.size() == 1) {
+    auto &batch = *batches.begin();
+    send(batch.first.first, batch.first.second, batch.second);
+    return;
+  }
+  std::vector<std::future<void>> futures;
+  for (const auto &batch: batches) {
+    futures.push_back(std::async(std::launch::async, send, batch.first.first, batch.first.second,
+                                 std::cref(batch.second)));
+  }
+  // Wait for every server before reporting the first failure
+  std::exception_ptr error = nullptr;
+  for (auto &f: futures) {
+    try {
+      f.get();
+    } catch (...) {
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
 }
 }
\ No newline at end of file
@@ -124,6 +124,14 @@ class storage_manager : public storage_management_ops {
   void update_partition(const std::string &block_name,
                         const std::string &partition_name,
                         const std::string &partition_metadata) override;
+
+  /**
+   * @brief Create partitions and set up their replica chains, sending one
+   * batch per storage server and contacting all servers in parallel
+   * @param partitions Partition and chain setup for each block
+   */
+
+  void create_partitions(const std::vector<partition_setup> &partitions) override;
 };
 
 }
@@ -51,20 +51,31 @@ const std::string &partition::metadata() const {
 }
 
 bool partition::is_accessor(const std::string &cmd) const {
-  // Does not require lock since block_ops don't change
-  return supported_commands_.at(cmd).is_accessor();
+  return is_accessor(command_id(cmd));
 }
 
 bool partition::is_mutator(const std::string &cmd) const {
+  return is_mutator(command_id(cmd));
+}
+
+bool partition::is_accessor(uint32_t cmd_id) const {
+  // Does not require lock since block_ops don't change
+  auto info = supported_commands_.info(cmd_id);
+  return info != nullptr && info->is_accessor();
+}
+
+bool partition::is_mutator(uint32_t cmd_id) const {
   // Does not require lock since block_ops don't change
-  return supported_commands_.at(cmd).is_mutator();
+  auto info = supported_commands_.info(cmd_id);
+  return info != nullptr && info->is_mutator();
+}
+
+uint32_t partition::command_id(const std::string &cmd_name) const {
+  return supported_commands_.id(cmd_name);
 }
 
-uint32_t partition::command_id(const std::string &cmd_name) {
-  auto it = supported_commands_.find(cmd_name);
-  if (it == supported_commands_.end())
-    return UINT32_MAX;
-  return it->second.id;
+const std::string &partition::command_name(uint32_t cmd_id) const {
+  return supported_commands_.name(cmd_id);
 }
 
 std::size_t partition::storage_capacity() {
@@ -89,7 +100,8 @@ void partition::set_name_and_metadata(const std::string &name, const std::string
 }
 
 void partition::notify(const arg_list &args) {
-  subscriptions().notify(args.front(), args[1]);
+  auto &op = args.front();
+  subscriptions().notify(command_opcode::is_opcode(op) ? command_name(command_id(op)) : op, args[1]);
 }
 
 binary partition::make_binary(const std::string &str) {
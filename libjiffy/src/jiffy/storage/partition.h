@@ -118,24 +118,45 @@ class partition {
 
   /**
    * @brief Check if ith command type is accessor
-   * @param cmd Command name
+   * @param cmd Command name or opcode
    * @return Bool value, true if block is accessor
    */
   bool is_accessor(const std::string& cmd) const;
 
   /**
    * @brief Check if ith command  type is mutator
-   * @param cmd Command name
+   * @param cmd Command name or opcode
    * @return Bool value, true if is mutator
    */
   bool is_mutator(const std::string& cmd) const;
 
+  /**
+   * @brief Check if command type is accessor
+   * @param cmd_id Command identifier
+   * @return Bool value, true if command is accessor
+   */
+  bool is_accessor(uint32_t cmd_id) const;
+
+  /**
+   * @brief Check if command type is mutator
+   * @param cmd_id Command identifier
+   * @return Bool value, true if command is mutator
+   */
+  bool is_mutator(uint32_t cmd_id) const;
+
   /**
    * @brief Fetch command id
-   * @param cmd_name Name of the command
+   * @param cmd_name Name or opcode of the command
    * @return Command ID
    */
-  uint32_t command_id(const std::string& cmd_name);
+  uint32_t command_id(const std::string& cmd_name) const;
+
+  /**
+   * @brief Fetch command name
+   * @param cmd_id Command identifier
+   * @return Command name
+   */
+  const std::string &command_name(uint32_t cmd_id) const;
 
   /**
    * Management Operations
@@ -165,9 +186,10 @@ class partition {
 
   /**
    * @brief Get the storage utilized by the partition.
+   * Partitions that keep state outside block memory add it in.
    * @return The storage capacity utilized by the partition.
    */
-  std::size_t storage_size();
+  virtual std::size_t storage_size();
 
   /**
    * @brief Build STL compliant allocator with memory managed by block memory manager.
@@ -204,7 +226,7 @@ class partition {
    * @brief Notify the listener
    * @param args Arguments
    */
-  void notify(const arg_list & args);
+  virtual void notify(const arg_list & args);
 
  protected:
   /**
@@ -223,7 +245,7 @@ class partition {
   /* Partition path */
   std::string path_;
   /* Supported commands */
-  const command_map &supported_commands_;
+  command_index supported_commands_;
   /* Subscription map */
   subscription_map sub_map_{};
   /* Block response client map */
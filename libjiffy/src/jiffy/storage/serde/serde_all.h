@@ -10,6 +10,7 @@
 #include <sstream>
 #include <iostream>
 #include <fstream>
+#include <unordered_map>
 
 using namespace jiffy::utils;
 
@@ -65,6 +66,83 @@ class serde {
     return binary(str, allocator_);
   }
 
+ protected:
+
+  /**
+   * @brief Serialize hash table delta
+   * Deltas are length framed whatever the format, since keys and values may hold any byte
+   * @param delta Hash table delta
+   * @param out_path Output path
+   * @return Output stream position
+   */
+
+  std::size_t serialize_delta(const hash_table_delta_type &delta, const std::string &out_path) {
+    std::ofstream out(out_path, std::ios::binary);
+    auto write_string = [&out](const std::string &str) {
+      std::size_t size = str.size();
+      out.write(reinterpret_cast<const char *>(&size), sizeof(size_t));
+      out.write(str.data(), size);
+    };
+    std::size_t num_upserts = delta.upserts.size();
+    std::size_t num_removes = delta.removes.size();
+    out.write(reinterpret_cast<const char *>(&delta.epoch), sizeof(uint64_t));
+    out.write(reinterpret_cast<const char *>(&num_upserts), sizeof(size_t));
+    for (const auto &e: delta.upserts) {
+      write_string(e.first);
+      write_string(e.second);
+    }
+    out.write(reinterpret_cast<const char *>(&num_removes), sizeof(size_t));
+    for (const auto &key: delta.removes) {
+      write_string(key);
+    }
+    out.flush();
+    auto sz = out.tellp();
+    out.close();
+    return static_cast<std::size_t>(sz);
+  }
+
+  /**
+   * @brief Deserialize hash table delta
+   * @param delta Hash table delta
+   * @param in_path Input path
+   * @return Input stream position
+   */
+
+  std::size_t deserialize_delta(hash_table_delta_type &delta, const std::string &in_path) {
+    std::ifstream in(in_path, std::ios::binary);
+    if (!in) {
+      delta.found = false;
+      return 0;
+    }
+    auto read_string = [&in](std::string &str) {
+      std::size_t size = 0;
+      in.read(reinterpret_cast<char *>(&size), sizeof(size_t));
+      str.resize(in ? size : 0);
+      in.read(&str[0], str.size());
+    };
+    std::size_t num_upserts = 0;
+    std::size_t num_removes = 0;
+    in.read(reinterpret_cast<char *>(&delta.epoch), sizeof(uint64_t));
+    in.read(reinterpret_cast<char *>(&num_upserts), sizeof(size_t));
+    for (std::size_t i = 0; in && i < num_upserts; ++i) {
+      std::pair<std::string, std::string> e;
+      read_string(e.first);
+      read_string(e.second);
+      delta.upserts.push_back(std::move(e));
+    }
+    in.read(reinterpret_cast<char *>(&num_removes), sizeof(size_t));
+    for (std::size_t i = 0; in && i < num_removes; ++i) {
+      std::string key;
+      read_string(key);
+      delta.removes.push_back(std::move(key));
+    }
+    // A partially written delta is treated as missing
+    delta.found = static_cast<bool>(in);
+    auto sz = in.tellg();
+    in.close();
+    return static_cast<std::size_t>(sz);
+  }
+
  private:
 
   /**
@@ -103,6 +181,24 @@ class serde {
 
   virtual std::size_t virtual_serialize(const shared_log_serde_type &table, const std::string &out_path) = 0;
 
+  /**
+   * @brief Virtual serialize function for hash table delta
+   * @param delta Hash table delta
+   * @param out Output stream
+   * @return Output stream position
+   */
+
+  virtual std::size_t virtual_serialize(const hash_table_delta_type &delta, const std::string &out_path) = 0;
+
+  /**
+   * @brief Virtual serialize function for hash table snapshot, read back as a hash table
+   * @param table Hash table snapshot
+   * @param out Output stream
+   * @return Output stream position
+   */
+
+  virtual std::size_t virtual_serialize(const hash_table_snapshot_type &table, const std::string &out_path) = 0;
+
   /**
    * @brief Virtual deserialize function for new hash table type
    * @param in Input stream
@@ -139,6 +235,15 @@ class serde {
 
   virtual std::size_t virtual_deserialize(shared_log_serde_type &table, const std::string &in_path) = 0;
 
+  /**
+   * @brief Virtual deserialize function for hash table delta
+   * @param in Input stream
+   * @param delta Hash table delta
+   * @return Input stream position
+   */
+
+  virtual std::size_t virtual_deserialize(hash_table_delta_type &delta, const std::string &in_path) = 0;
+
   /* Block memory allocator */
   block_memory_allocator<uint8_t> allocator_;
 
@@ -204,6 +309,28 @@ class derived : public impl {
     return impl::serialize_impl(table, out_path);
   }
 
+  /**
+   * @brief Virtual serialize function for hash table delta
+   * @param delta Hash table delta
+   * @param out Output stream
+   * @return Output stream position
+   */
+
+  std::size_t virtual_serialize(const hash_table_delta_type &delta, const std::string &out_path) final {
+    return impl::serialize_delta(delta, out_path);
+  }
+
+  /**
+   * @brief Virtual serialize function for hash table snapshot
+   * @param table Hash table snapshot
+   * @param out Output stream
+   * @return Output stream position
+   */
+
+  std::size_t virtual_serialize(const hash_table_snapshot_type &table, const std::string &out_path) final {
+    return impl::serialize_impl(table, out_path);
+  }
+
   /**
    * @brief Virtual deserialize function for new hash table type
    * @param in Input stream
@@ -246,6 +373,17 @@ class derived : public impl {
   std::size_t virtual_deserialize(shared_log_serde_type &table, const std::string &in_path) final {
     return impl::deserialize_impl(table, in_path);
   }
+
+  /**
+   * @brief Virtual deserialize function for hash table delta
+   * @param in Input stream
+   * @param delta Hash table delta
+   * @return Input stream position
+   */
+
+  std::size_t virtual_deserialize(hash_table_delta_type &delta, const std::string &in_path) final {
+    return impl::deserialize_delta(delta, in_path);
+  }
 };
 
 /* CSV serializer/deserializer class
@@ -535,7 +673,7 @@ class binary_serde_impl : public serde {
    */
 
   size_t serialize_impl(const shared_log_serde_type &table, const std::string &out_path) {
-    std::vector<std::vector<int>> log_info = table.log_info;
+    const shared_log_block &block = *table.block;
     std::size_t seq_no = table.seq_no;
 
     std::ofstream out(out_path, std::ios::binary);
@@ -544,33 +682,28 @@ class binary_serde_impl : public serde {
     std::ofstream offset_out(offset_out_path, std::ios::binary);
 
     out.write(reinterpret_cast<const char *>(&seq_no), sizeof(size_t));
-    std::size_t log_info_size = log_info.size();
+    std::size_t log_info_size = block.num_entries();
     out.write(reinterpret_cast<const char *>(&log_info_size), sizeof(size_t));
-    for (size_t i = 0; i < log_info.size(); ++i) {
-
-      auto info_set = log_info[i];
-      std::size_t num_args = info_set.size() - 1;
-      int temp_offset = info_set[0];
+    for (size_t i = 0; i < block.num_entries(); ++i) {
 
-      if (temp_offset == -1) continue;
+      auto entry = block.entry(i);
+      if (entry.offset == -1) continue;
 
-      std::size_t data_size = info_set[1];
+      std::size_t num_args = entry.num_streams + 1;
+      std::size_t data_size = entry.length;
 
       offset_out.write(reinterpret_cast<const char *>(&i), sizeof(size_t));
       offset_out.write(reinterpret_cast<const char *>(&num_args), sizeof(size_t));
       offset_out.write(reinterpret_cast<const char *>(&data_size), sizeof(size_t));
 
-      for (size_t j = 2; j < info_set.size(); j++) {
-        size_t stream_size = info_set[j];
-        std::string stream =
-            (*table.block).read(static_cast<std::size_t>(temp_offset), static_cast<std::size_t>(info_set[j])).second;
-
+      // Stream tags are interned in memory, and written out by name
+      for (auto id : block.streams(i)) {
+        const std::string &stream = table.streams[id];
+        size_t stream_size = stream.size();
         offset_out.write(reinterpret_cast<const char *>(&stream_size), sizeof(size_t));
         out.write(reinterpret_cast<const char *>(stream.data()), stream_size);
-        temp_offset += info_set[j];
       }
-      std::string
-          data = (*table.block).read(static_cast<std::size_t>(temp_offset), static_cast<std::size_t>(data_size)).second;
+      std::string data = block.read_entry(i);
       out.write(reinterpret_cast<const char *>(data.data()), data_size);
 
     }
@@ -670,7 +803,9 @@ class binary_serde_impl : public serde {
     std::string offset_in_path = in_path;
     offset_in_path.append("_offset");
     std::ifstream offset_in(offset_in_path, std::ios::binary);
-    std::vector<std::vector<int>> log_info;
+    shared_log_block &block = *table.block;
+    std::vector<std::string> streams;
+    std::unordered_map<std::string, uint32_t> stream_ids;
 
     std::size_t seq_no;
     in.read(reinterpret_cast<char *>(&seq_no), sizeof(seq_no));
@@ -679,40 +814,44 @@ class binary_serde_impl : public serde {
     std::size_t log_size;
     in.read(reinterpret_cast<char *>(&log_size), sizeof(log_size));
 
-    std::size_t temp_offset = 0;
+    // Trimmed entries keep their position in the log, with an invalid index record
+    auto append_trimmed = [&block](std::size_t log_position) {
+      while (log_position > block.num_entries()) {
+        if (!block.append({}, "")) throw std::length_error("Shared log does not fit in the block");
+        block.invalidate(block.num_entries() - 1);
+      }
+    };
 
     while (in.peek() != EOF && offset_in.peek() != EOF) {
       std::size_t log_position;
       offset_in.read(reinterpret_cast<char *>(&log_position), sizeof(log_position));
-      while (log_position > log_info.size()) {
-        std::vector<int> info_set = {-1, 0};
-        log_info.push_back(info_set);
-      }
+      append_trimmed(log_position);
       std::size_t num_args;
       offset_in.read(reinterpret_cast<char *>(&num_args), sizeof(num_args));
       std::size_t data_size;
       offset_in.read(reinterpret_cast<char *>(&data_size), sizeof(data_size));
+      std::vector<uint32_t> ids;
       for (size_t i = 0; i < num_args - 1; ++i) {
         std::size_t stream_size;
         offset_in.read(reinterpret_cast<char *>(&stream_size), sizeof(stream_size));
         std::string stream;
         stream.resize(stream_size);
         in.read(&stream[0], stream_size);
-        (*table.block).write(stream, temp_offset);
-        temp_offset += stream.size();
+        auto it = stream_ids.find(stream);
+        if (it == stream_ids.end()) {
+          it = stream_ids.emplace(stream, static_cast<uint32_t>(streams.size())).first;
+          streams.push_back(stream);
+        }
+        ids.push_back(it->second);
       }
       std::string data;
       data.resize(data_size);
       in.read(&data[0], data_size);
-      (*table.block).write(data, temp_offset);
-      temp_offset += data.size();
+      if (!block.append(ids, data)) throw std::length_error("Shared log does not fit in the block");
     }
 
-    while (log_info.size() < log_size) {
-      std::vector<int> info_set = {-1, 0};
-      log_info.push_back(info_set);
-    }
-    table.log_info = log_info;
+    append_trimmed(log_size);
+    table.streams = streams;
 
     auto sz = in.tellg();
     in.close();
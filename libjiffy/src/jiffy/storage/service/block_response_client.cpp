@@ -12,6 +12,7 @@ block_response_client::block_response_client(std::shared_ptr<TProtocol> protocol
     : client_(std::make_shared<thrift_client>(protocol)) {}
 
 void block_response_client::response(const sequence_id &seq, const std::vector<std::string> &result) {
+  std::lock_guard<std::mutex> lock(mtx_);
   client_->response(seq, result);
 }
 
@@ -1,6 +1,7 @@
 #ifndef JIFFY_BLOCK_RESPONSE_CLIENT_H
 #define JIFFY_BLOCK_RESPONSE_CLIENT_H
 
+#include <mutex>
 #include <thrift/transport/TSocket.h>
 #include "block_response_service.h"
 
@@ -29,6 +30,8 @@ class block_response_client {
  private:
   /* Block response service client */
   std::shared_ptr<thrift_client> client_{};
+  /* Serializes responses written to the same connection from different threads */
+  std::mutex mtx_;
 };
 
 }
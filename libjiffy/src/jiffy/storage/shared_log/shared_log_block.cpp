@@ -18,12 +18,16 @@ shared_log_block::shared_log_block(const shared_log_block &other) {
   alloc_ = other.alloc_;
   max_ = other.max_;
   data_ = other.data_;
+  data_end_ = other.data_end_;
+  num_entries_ = other.num_entries_;
 }
 
 shared_log_block &shared_log_block::operator=(const shared_log_block &other) {
   alloc_ = other.alloc_;
   max_ = other.max_;
   data_ = other.data_;
+  data_end_ = other.data_end_;
+  num_entries_ = other.num_entries_;
   return *this;
 }
 
@@ -52,11 +56,93 @@ void shared_log_block::clear() {
   for (std::size_t i = 0; i < max_; i++) {
     data_[i] = 0;
   }
+  data_end_ = 0;
+  num_entries_ = 0;
 }
 
 char *shared_log_block::data() const {
   return data_;
 }
 
+bool shared_log_block::append(const std::vector<uint32_t> &streams, const std::string &data) {
+  auto size = entry_size(data.size(), streams.size());
+  if (data_end_ + index_size() + size > max_) {
+    return false;
+  }
+  shared_log_entry e{static_cast<int64_t>(data_end_), static_cast<uint32_t>(data.size()),
+                     static_cast<uint32_t>(streams.size())};
+  if (!streams.empty()) {
+    std::memcpy(data_ + data_end_, streams.data(), streams.size() * sizeof(uint32_t));
+    data_end_ += streams.size() * sizeof(uint32_t);
+  }
+  std::memcpy(data_ + data_end_, data.data(), data.size());
+  data_end_ += data.size();
+  // Records are copied in and out, since the end of the block need not be aligned
+  std::memcpy(record(num_entries_), &e, sizeof(e));
+  num_entries_++;
+  return true;
+}
+
+shared_log_entry shared_log_block::entry(std::size_t i) const {
+  if (i >= num_entries_) {
+    throw std::out_of_range("Entry position exceeds number of entries");
+  }
+  shared_log_entry e{};
+  std::memcpy(&e, record(i), sizeof(e));
+  return e;
+}
+
+std::vector<uint32_t> shared_log_block::streams(std::size_t i) const {
+  auto e = entry(i);
+  if (e.offset == -1) {
+    return {};
+  }
+  std::vector<uint32_t> ids(e.num_streams);
+  if (!ids.empty()) {
+    std::memcpy(ids.data(), data_ + e.offset, e.num_streams * sizeof(uint32_t));
+  }
+  return ids;
+}
+
+std::string shared_log_block::read_entry(std::size_t i) const {
+  auto e = entry(i);
+  return std::string(data_ + e.offset + e.num_streams * sizeof(uint32_t), e.length);
+}
+
+void shared_log_block::invalidate(std::size_t i) {
+  auto e = entry(i);
+  e.offset = -1;
+  std::memcpy(record(i), &e, sizeof(e));
+}
+
+void shared_log_block::compact(std::size_t num_dropped) {
+  std::size_t end = 0;
+  // Entries move towards the front, and records towards the back, so nothing is overwritten before it is moved
+  for (std::size_t i = num_dropped; i < num_entries_; i++) {
+    auto e = entry(i);
+    if (e.offset != -1) {
+      auto size = e.num_streams * sizeof(uint32_t) + e.length;
+      std::memmove(data_ + end, data_ + e.offset, size);
+      e.offset = static_cast<int64_t>(end);
+      end += size;
+    }
+    std::memcpy(record(i - num_dropped), &e, sizeof(e));
+  }
+  num_entries_ -= num_dropped;
+  data_end_ = end;
+}
+
+std::size_t shared_log_block::num_entries() const {
+  return num_entries_;
+}
+
+std::size_t shared_log_block::data_size() const {
+  return data_end_;
+}
+
+std::size_t shared_log_block::index_size() const {
+  return num_entries_ * sizeof(shared_log_entry);
+}
+
 }
 }
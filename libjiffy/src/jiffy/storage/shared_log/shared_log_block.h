@@ -2,6 +2,7 @@
 #define JIFFY_SHARED_LOG_BLOCK_H
 
 #include <string>
+#include <cstdint>
 #include <cstring>
 #include <vector>
 #include <map>
@@ -10,6 +11,20 @@
 
 namespace jiffy {
 namespace storage {
+
+/**
+ * @brief Index record of a shared log entry
+ * The stream ids of the entry are stored ahead of its data, starting at the offset
+ */
+struct shared_log_entry {
+  /* Offset of the entry in the block, -1 if the entry is trimmed */
+  int64_t offset;
+  /* Data length */
+  uint32_t length;
+  /* Number of stream ids */
+  uint32_t num_streams;
+};
+
 /**
  * @brief Dummy_block class
  * This data structure only mainly blocks of memory without metadata
@@ -102,7 +117,88 @@ class shared_log_block {
 
   char *data() const;
 
+  /**
+   * @brief Append an entry, storing its stream ids and data from the front of the block
+   * and its index record from the back of the block
+   * @param streams Stream ids
+   * @param data Entry data
+   * @return Bool value, true if the entry fit in the block
+   */
+  bool append(const std::vector<uint32_t> &streams, const std::string &data);
+
+  /**
+   * @brief Fetch the index record of an entry
+   * @param i Entry position
+   * @return Index record
+   */
+  shared_log_entry entry(std::size_t i) const;
+
+  /**
+   * @brief Fetch the stream ids of an entry
+   * @param i Entry position
+   * @return Stream ids, empty if the entry is trimmed
+   */
+  std::vector<uint32_t> streams(std::size_t i) const;
+
+  /**
+   * @brief Read the data of an entry
+   * @param i Entry position
+   * @return Entry data
+   */
+  std::string read_entry(std::size_t i) const;
+
+  /**
+   * @brief Mark an entry as trimmed
+   * @param i Entry position
+   */
+  void invalidate(std::size_t i);
+
+  /**
+   * @brief Reclaim the space of trimmed entries
+   * The leading trimmed entries are dropped, so the remaining entries move up by that many positions,
+   * and the data of the remaining live entries is packed at the front of the block
+   * @param num_dropped Number of leading entries to drop, all of which must be trimmed
+   */
+  void compact(std::size_t num_dropped);
+
+  /**
+   * @brief Fetch number of entries, trimmed entries included
+   * @return Number of entries
+   */
+  std::size_t num_entries() const;
+
+  /**
+   * @brief Fetch number of bytes used by entry stream ids and data
+   * @return Data size
+   */
+  std::size_t data_size() const;
+
+  /**
+   * @brief Fetch number of bytes used by entry index records
+   * @return Index size
+   */
+  std::size_t index_size() const;
+
+  /**
+   * @brief Fetch the number of block bytes an entry takes up, index record included
+   * @param data_size Data length
+   * @param num_streams Number of stream ids
+   * @return Entry footprint
+   */
+  static std::size_t entry_size(std::size_t data_size, std::size_t num_streams) {
+    return sizeof(shared_log_entry) + num_streams * sizeof(uint32_t) + data_size;
+  }
+
  private:
+  /**
+   * @brief Fetch location of the index record of an entry
+   * @param i Entry position
+   * @return Record pointer
+   */
+  char *record(std::size_t i) const {
+    return data_ + max_ - (i + 1) * sizeof(shared_log_entry);
+  }
+
   /* Block memory allocator */
   block_memory_allocator<char> alloc_;
 
@@ -112,6 +208,12 @@ class shared_log_block {
   /* Data pointer */
   char *data_{};
 
+  /* Offset past the last entry's data */
+  std::size_t data_end_{};
+
+  /* Number of entries */
+  std::size_t num_entries_{};
+
 };
 
 }
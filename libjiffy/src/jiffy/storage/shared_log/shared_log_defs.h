@@ -14,8 +14,8 @@ typedef shared_log_block shared_log_type;
 struct shared_log_triple
 {
     shared_log_block* block;
-    std::vector<std::vector<int>> log_info;
     int seq_no;
+    std::vector<std::string> streams;
 };
 typedef struct shared_log_triple shared_log_serde_type;
 
@@ -5,6 +5,7 @@
 #include "jiffy/auto_scaling/auto_scaling_client.h"
 #include <jiffy/utils/directory_utils.h>
 #include <thread>
+#include <algorithm>
 #include <iostream>
 
 namespace jiffy {
@@ -42,25 +43,27 @@ void shared_log_partition::write(response &_return, const arg_list &args) {
     RETURN_ERR("!args_error");
   }
   auto position = std::stoi(args[1]);
-  if (log_info_.size() == 0) {
+  if (partition_.num_entries() == 0) {
     seq_no_ = position;
   }
-  auto data = args[2];
-  std::string logical_stream = "";
-  std::vector<int> info_set;
-  info_set.push_back(int(starting_offset_));
-  info_set.push_back(int(data.size()));
+  std::vector<uint32_t> ids;
   for (std::size_t i = 3; i < args.size(); i++) {
-    logical_stream += args[i];
-    info_set.push_back(int(args[i].size()));
+    auto id = intern_stream(args[i]);
+    // An entry is listed once per stream, keeping each posting list strictly increasing
+    if (std::find(ids.begin(), ids.end(), id) == ids.end()) ids.push_back(id);
   }
-  log_info_.push_back(info_set);
-  std::string writing_content = logical_stream + data;
-  auto ret = partition_.write(writing_content, starting_offset_);
-  if (!ret.first) {
-    throw std::logic_error("Write failed");
+  if (!partition_.append(ids, args[2])) {
+    reclaim();
+    if (partition_.num_entries() == 0) {
+      seq_no_ = position;
+    }
+    if (!partition_.append(ids, args[2])) {
+      RETURN_ERR("!block_full");
+    }
+  }
+  for (auto id : ids) {
+    postings_[id].push_back(static_cast<uint32_t>(partition_.num_entries() - 1));
   }
-  starting_offset_ += writing_content.size();
   RETURN_OK();
 
 }
@@ -69,42 +72,36 @@ void shared_log_partition::scan(response &_return, const arg_list &args) {
   if (args.size() < 4) {
     RETURN_ERR("!args_error");
   }
+  auto num_entries = partition_.num_entries();
   auto start_pos = std::stoi(args[1]) - seq_no_;
   auto end_pos = std::stoi(args[2]) - seq_no_;
-  if (static_cast<size_t>(end_pos) > log_info_.size()) end_pos = log_info_.size() - 1;
-  std::vector<std::string> logical_streams = {};
-  for (std::size_t i = 3; i < args.size(); i++) {
-    logical_streams.push_back(args[i]);
-  }
   std::vector<std::string> ret = {"!ok"};
-  if (log_info_.size() == 0) {
+  if (num_entries == 0 || end_pos < 0) {
     _return = ret;
     return;
   }
-  if (start_pos < 0 || static_cast<size_t>(start_pos) >= log_info_.size() || end_pos < 0 || end_pos < start_pos)
+  if (static_cast<size_t>(end_pos) >= num_entries) end_pos = num_entries - 1;
+  // Positions ahead of the first entry were trimmed and reclaimed
+  if (start_pos < 0) start_pos = 0;
+  if (start_pos < 0 || static_cast<size_t>(start_pos) >= num_entries || end_pos < 0 || end_pos < start_pos)
     throw std::invalid_argument("scan position invalid");
-  for (int i = start_pos; i <= end_pos; i++) {
-    auto info_set = log_info_[i];
-    if (info_set[0] == -1) continue;
-    int temp_offset = info_set[0];
-    int data_size = info_set[1];
-    int stream_size = 0;
-    for (std::size_t j = 2; j < info_set.size(); j++) {
-      stream_size += info_set[j];
-    }
-    for (std::size_t j = 2; j < info_set.size(); j++) {
-      auto
-          stream = partition_.read(static_cast<std::size_t>(temp_offset), static_cast<std::size_t>(info_set[j])).second;
-      temp_offset += info_set[j];
-      std::vector<std::string>::iterator it;
-      it = find(logical_streams.begin(), logical_streams.end(), stream);
-      if (it != logical_streams.end()) {
-        auto data = partition_.read(static_cast<std::size_t>(info_set[0] + stream_size),
-                                    static_cast<std::size_t>(data_size)).second;
-        ret.push_back(data);
-        break;
-      }
-    }
+  std::vector<uint32_t> positions;
+  for (std::size_t i = 3; i < args.size(); i++) {
+    auto it = stream_ids_.find(args[i]);
+    if (it == stream_ids_.end()) continue;
+    const auto &posting = postings_[it->second];
+    auto begin = std::lower_bound(posting.begin(), posting.end(), static_cast<uint32_t>(start_pos));
+    auto end = std::upper_bound(begin, posting.end(), static_cast<uint32_t>(end_pos));
+    positions.insert(positions.end(), begin, end);
+  }
+  if (args.size() > 4) {
+    // Entries in more than one of the streams are returned once, in log order
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+  }
+  for (auto i : positions) {
+    if (partition_.entry(i).offset == -1) continue;
+    ret.push_back(partition_.read_entry(i));
   }
   _return = ret;
 
@@ -114,31 +111,46 @@ void shared_log_partition::trim(response &_return, const arg_list &args) {
   if (args.size() != 3) {
     RETURN_ERR("!args_error");
   }
-  if (log_info_.size() == 0) {
-    RETURN_OK(0);
-  }
+  auto num_entries = partition_.num_entries();
   auto start_pos = std::stoi(args[1]) - seq_no_;
   auto end_pos = std::stoi(args[2]) - seq_no_;
-  if (start_pos < 0 || static_cast<size_t>(start_pos) >= log_info_.size() || end_pos < 0 || end_pos < start_pos)
+  if (num_entries == 0 || end_pos < 0) {
+    RETURN_OK("0", "0");
+  }
+  // Positions ahead of the first entry were trimmed and reclaimed
+  if (start_pos < 0) start_pos = 0;
+  if (static_cast<size_t>(start_pos) >= num_entries || end_pos < start_pos)
     throw std::invalid_argument("trim position invalid");
-  if (static_cast<size_t>(end_pos) > log_info_.size()) end_pos = log_info_.size() - 1;
-  int trimmed_length = 0;
+  if (static_cast<size_t>(end_pos) >= num_entries) end_pos = num_entries - 1;
+  std::size_t trimmed_length = 0;
+  std::size_t reclaimed = 0;
   for (int i = start_pos; i <= end_pos; i++) {
-    auto info_set = log_info_[i];
-    if (info_set[0] == -1) continue;
-    log_info_[i][0] = -1; // make the log entry invalid
-    for (std::size_t j = 1; j < info_set.size(); j++) {
-      trimmed_length += info_set[j];
+    auto entry = partition_.entry(i);
+    if (entry.offset == -1) continue;
+    trimmed_length += entry.length;
+    for (auto id : partition_.streams(i)) {
+      trimmed_length += streams_[id].size();
     }
+    reclaimed += shared_log_block::entry_size(entry.length, entry.num_streams) - sizeof(shared_log_entry);
+    partition_.invalidate(i); // make the log entry invalid
   }
+  // Index records are only reclaimed once every entry ahead of them is trimmed
+  auto prefix = trimmed_prefix_;
+  while (trimmed_prefix_ < num_entries && partition_.entry(trimmed_prefix_).offset == -1) {
+    trimmed_prefix_++;
+  }
+  reclaimed += (trimmed_prefix_ - prefix) * sizeof(shared_log_entry);
 
-  RETURN_OK(std::to_string(trimmed_length));
+  RETURN_OK(std::to_string(trimmed_length), std::to_string(reclaimed));
 }
 
 void shared_log_partition::update_partition(response &_return, const arg_list &args) {
   if (args.size() >= 2) {
     block_allocated_ = true;
     allocated_blocks_.insert(allocated_blocks_.end(), args.begin() + 1, args.end());
+  } else {
+    // Scaling failed before any block was added, the next add_blocks asks again
+    scaling_up_ = false;
   }
   RETURN_OK();
 }
@@ -170,12 +182,12 @@ void shared_log_partition::get_storage_capacity(response &_return, const arg_lis
   if (args.size() != 1) {
     RETURN_ERR("!args_error");
   }
-  RETURN_OK(std::to_string(manager_->mb_capacity()));
+  RETURN_OK(std::to_string(manager_->mb_capacity()), std::to_string(index_size()));
 }
 
 void shared_log_partition::run_command(response &_return, const arg_list &args) {
-  auto cmd_name = args[0];
-  switch (command_id(cmd_name)) {
+  auto cmd_id = command_id(args[0]);
+  switch (cmd_id) {
     case shared_log_cmd_id::shared_log_write:write(_return, args);
       break;
     case shared_log_cmd_id::shared_log_scan:scan(_return, args);
@@ -194,11 +206,81 @@ void shared_log_partition::run_command(response &_return, const arg_list &args)
     }
   }
 
-  if (is_mutator(cmd_name)) {
+  if (is_mutator(cmd_id)) {
     dirty_ = true;
   }
 }
 
+uint32_t shared_log_partition::intern_stream(const std::string &stream) {
+  auto it = stream_ids_.find(stream);
+  if (it != stream_ids_.end()) {
+    return it->second;
+  }
+  auto id = static_cast<uint32_t>(streams_.size());
+  streams_.push_back(stream);
+  postings_.emplace_back();
+  stream_ids_.emplace(stream, id);
+  return id;
+}
+
+void shared_log_partition::rebuild_stream_index() {
+  stream_ids_.clear();
+  postings_.assign(streams_.size(), {});
+  for (std::size_t id = 0; id < streams_.size(); id++) {
+    stream_ids_.emplace(streams_[id], static_cast<uint32_t>(id));
+  }
+  trimmed_prefix_ = 0;
+  for (std::size_t i = 0; i < partition_.num_entries(); i++) {
+    if (trimmed_prefix_ == i && partition_.entry(i).offset == -1) {
+      trimmed_prefix_++;
+    }
+    for (auto id : partition_.streams(i)) {
+      postings_[id].push_back(static_cast<uint32_t>(i));
+    }
+  }
+}
+
+void shared_log_partition::reclaim() {
+  auto dropped = trimmed_prefix_;
+  partition_.compact(dropped);
+  seq_no_ += static_cast<int>(dropped);
+  trimmed_prefix_ = 0;
+  if (dropped == 0) {
+    return;
+  }
+  for (auto &posting : postings_) {
+    auto begin = std::lower_bound(posting.begin(), posting.end(), static_cast<uint32_t>(dropped));
+    posting.erase(posting.begin(), begin);
+    for (auto &pos : posting) {
+      pos -= static_cast<uint32_t>(dropped);
+    }
+  }
+}
+
+std::size_t shared_log_partition::index_size() const {
+  auto size = partition_.index_size();
+  for (const auto &posting : postings_) {
+    size += posting.capacity() * sizeof(uint32_t);
+  }
+  return size;
+}
+
+std::size_t shared_log_partition::stream_index_size() const {
+  std::size_t size = streams_.capacity() * sizeof(std::string) + postings_.capacity() * sizeof(std::vector<uint32_t>);
+  for (std::size_t id = 0; id < streams_.size(); id++) {
+    // Each name is held twice, once in streams_ and once as a stream_ids_ key
+    size += 2 * streams_[id].size() + postings_[id].capacity() * sizeof(uint32_t);
+  }
+  // One node per stream id holding the pair, the next pointer and the cached hash
+  size += stream_ids_.bucket_count() * sizeof(void *)
+      + stream_ids_.size() * (sizeof(std::pair<const std::string, uint32_t>) + sizeof(void *) + sizeof(std::size_t));
+  return size;
+}
+
+std::size_t shared_log_partition::storage_size() {
+  return partition::storage_size() + stream_index_size();
+}
+
 std::size_t shared_log_partition::size() const {
   return partition_.size();
 }
@@ -210,15 +292,19 @@ bool shared_log_partition::is_dirty() const {
 void shared_log_partition::load(const std::string &path) {
   auto remote = persistent::persistent_store::instance(path, ser_);
   auto decomposed = persistent::persistent_store::decompose_path(path);
-  shared_log_serde_type triple = {&partition_, log_info_, seq_no_};
+  partition_.clear();
+  shared_log_serde_type triple = {&partition_, 0, {}};
   remote->read<shared_log_serde_type>(decomposed.second, triple);
+  streams_ = std::move(triple.streams);
+  seq_no_ = triple.seq_no;
+  rebuild_stream_index();
 }
 
 bool shared_log_partition::sync(const std::string &path) {
   if (dirty_) {
     auto remote = persistent::persistent_store::instance(path, ser_);
     auto decomposed = persistent::persistent_store::decompose_path(path);
-    shared_log_serde_type triple = {&partition_, log_info_, seq_no_};
+    shared_log_serde_type triple = {&partition_, seq_no_, streams_};
     remote->write<shared_log_serde_type>(triple, decomposed.second);
     dirty_ = false;
     return true;
@@ -231,11 +317,16 @@ bool shared_log_partition::dump(const std::string &path) {
   if (dirty_) {
     auto remote = persistent::persistent_store::instance(path, ser_);
     auto decomposed = persistent::persistent_store::decompose_path(path);
-    shared_log_serde_type triple = {&partition_, log_info_, seq_no_};
+    shared_log_serde_type triple = {&partition_, seq_no_, streams_};
     remote->write<shared_log_serde_type>(triple, decomposed.second);
     flushed = true;
   }
   partition_.clear();
+  streams_.clear();
+  stream_ids_.clear();
+  postings_.clear();
+  seq_no_ = 0;
+  trimmed_prefix_ = 0;
   next_->reset("nil");
   path_ = "";
   sub_map_.clear();
@@ -2,6 +2,7 @@
 #define JIFFY_SHARED_LOG_SERVICE_SHARD_H
 
 #include <string>
+#include <unordered_map>
 #include <jiffy/utils/property_map.h>
 #include "jiffy/storage/serde/serde_all.h"
 #include "jiffy/storage/partition.h"
@@ -48,6 +49,7 @@ class shared_log_partition : public chain_module {
 
   /**
    * @brief Write data to the shared_log
+   * Responds with !block_full if the entry does not fit even after reclaiming trimmed entries
    * @param _return Response
    * @param args Arguments
    */
@@ -62,6 +64,8 @@ class shared_log_partition : public chain_module {
 
   /**
    * @brief Trim data from the shared_log
+   * Responds with the trimmed length and the number of block bytes the trim frees up,
+   * which are reclaimed once a write no longer fits
    * @param _return Response
    * @param args Arguments
    */
@@ -89,7 +93,7 @@ class shared_log_partition : public chain_module {
   void add_blocks(response &_return, const arg_list &args);
 
   /**
-   * @brief Get storage capacity of the partition
+   * @brief Get storage capacity of the partition, along with the bytes taken up by its index
    * @param _return Response
    * @param args Arguments
    */
@@ -133,11 +137,48 @@ class shared_log_partition : public chain_module {
    */
   void forward_all() override;
 
-  /* index: seq no. of log; value: <metadata.start_offset, metadata.length, log_info.length>*/
-  std::vector<std::vector<int>> log_info_;
+  /**
+   * @brief Fetch storage used by the partition, including the stream index
+   * @return Block memory used plus the bytes of the stream index
+   */
+  std::size_t storage_size() override;
+
+  /* Interned logical stream names, indexed by stream id; like the rest of the
+   * stream index it lives on the heap, since the log takes the whole block */
+  std::vector<std::string> streams_;
 
  private:
 
+  /**
+   * @brief Fetch the id of a logical stream, interning the stream if it is new
+   * @param stream Logical stream name
+   * @return Stream id
+   */
+  uint32_t intern_stream(const std::string &stream);
+
+  /**
+   * @brief Rebuild stream ids and posting lists from the log entries
+   */
+  void rebuild_stream_index();
+
+  /**
+   * @brief Fetch number of bytes used by the entry index records and the posting lists
+   * @return Index size
+   */
+  std::size_t index_size() const;
+
+  /**
+   * @brief Fetch number of heap bytes used by the stream names, stream ids and posting lists
+   * @return Stream index size
+   */
+  std::size_t stream_index_size() const;
+
+  /**
+   * @brief Reclaim the space of trimmed entries, dropping the leading trimmed entries
+   * and moving up the first position of the partition past them
+   */
+  void reclaim();
+
   /* Shared log partition */
   shared_log_type partition_;
 
@@ -171,8 +212,14 @@ class shared_log_partition : public chain_module {
   /* starting seq no. in this partition */
   int seq_no_ = 0;
 
-  /* starting offset of the next input entry */
-  int starting_offset_ = 0;
+  /* Stream ids of the interned logical stream names */
+  std::unordered_map<std::string, uint32_t> stream_ids_;
+
+  /* Posting lists: stream id to the sorted positions of the log entries in that stream */
+  std::vector<std::vector<uint32_t>> postings_;
+
+  /* Number of leading trimmed entries */
+  std::size_t trimmed_prefix_ = 0;
 
 };
 
@@ -0,0 +1,313 @@
+#ifdef MEMKIND_IN_USE
+  #include <memkind.h>
+#else
+  #include <jemalloc/jemalloc.h>
+#endif
+#include <algorithm>
+#include <new>
+#include "slab_allocator.h"
+
+namespace jiffy {
+namespace storage {
+
+/* Next slab allocator identifier */
+static std::atomic<uint64_t> next_allocator_id(1);
+
+/* Next byte counter to hand out to a thread */
+static std::atomic<std::size_t> next_counter(0);
+
+/* Mutex protecting the live slab allocators */
+static std::mutex &registry_mutex() {
+  static std::mutex mtx;
+  return mtx;
+}
+
+/* Live slab allocators */
+static std::unordered_map<uint64_t, slab_allocator *> &registry() {
+  static std::unordered_map<uint64_t, slab_allocator *> allocators;
+  return allocators;
+}
+
+/* Bytes in front of a large allocation holding its size */
+static const std::size_t LARGE_HEADER_SIZE = 16;
+
+/* Number of objects moved between a thread cache and the shared free lists at a time */
+static std::size_t batch_size(std::size_t cls) {
+  return std::max<std::size_t>(1, std::min<std::size_t>(32, slab_allocator::objects_per_slab(cls) / 4));
+}
+
+slab_allocator::thread_caches::~thread_caches() {
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  for (auto &entry: caches) {
+    auto it = registry().find(entry.first);
+    if (it != registry().end()) {
+      for (std::size_t cls = 0; cls < NUM_SIZE_CLASSES; ++cls) {
+        it->second->release(entry.second, cls, entry.second->count[cls]);
+      }
+    }
+    delete entry.second;
+  }
+}
+
+slab_allocator::slab_allocator(const std::string &memory_mode, void *mem_kind)
+    : id_(next_allocator_id.fetch_add(1)), memory_mode_(memory_mode), mem_kind_(mem_kind) {
+  #ifdef MEMKIND_IN_USE
+    if (memory_mode_ == "DRAM") {
+      mem_kind_ = MEMKIND_DEFAULT;
+    }
+  #endif
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  registry().emplace(id_, this);
+}
+
+slab_allocator::~slab_allocator() {
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    registry().erase(id_);
+  }
+  for (auto &slab: slabs_) {
+    raw_free(reinterpret_cast<void *>(slab.first));
+  }
+}
+
+void *slab_allocator::allocate(std::size_t size) {
+  if (size > MAX_SLAB_OBJECT_SIZE) {
+    // Record the size in front of the allocation, for frees that do not know it
+    auto ptr = static_cast<char *>(raw_allocate(size + LARGE_HEADER_SIZE, 0));
+    if (ptr == nullptr) {
+      return nullptr;
+    }
+    *reinterpret_cast<std::size_t *>(ptr) = size;
+    account(static_cast<int64_t>(size));
+    return ptr + LARGE_HEADER_SIZE;
+  }
+  auto cls = size_class(size);
+  auto cache = local_cache();
+  if (cache->head[cls] == nullptr && !refill(cache, cls)) {
+    return nullptr;
+  }
+  auto obj = cache->head[cls];
+  cache->head[cls] = obj->next;
+  --cache->count[cls];
+  return obj;
+}
+
+void slab_allocator::deallocate(void *ptr, std::size_t size) {
+  if (size > MAX_SLAB_OBJECT_SIZE) {
+    raw_free(static_cast<char *>(ptr) - LARGE_HEADER_SIZE);
+    account(-static_cast<int64_t>(size));
+    return;
+  }
+  auto cls = size_class(size);
+  auto cache = local_cache();
+  auto obj = static_cast<free_object *>(ptr);
+  obj->next = cache->head[cls];
+  cache->head[cls] = obj;
+  ++cache->count[cls];
+  auto batch = batch_size(cls);
+  if (cache->count[cls] > 2 * batch) {
+    release(cache, cls, batch);
+  }
+}
+
+void slab_allocator::deallocate(void *ptr) {
+  auto slab = reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(SLAB_SIZE - 1);
+  std::unique_lock<std::mutex> lock(slabs_mtx_);
+  auto it = slabs_.find(slab);
+  if (it != slabs_.end()) {
+    auto size = class_size(it->second);
+    lock.unlock();
+    deallocate(ptr, size);
+    return;
+  }
+  lock.unlock();
+  deallocate(ptr, *reinterpret_cast<std::size_t *>(static_cast<char *>(ptr) - LARGE_HEADER_SIZE));
+}
+
+std::size_t slab_allocator::used() const {
+  int64_t total = 0;
+  for (const auto &counter: used_) {
+    total += counter.bytes.load(std::memory_order_relaxed);
+  }
+  return total > 0 ? static_cast<std::size_t>(total) : 0;
+}
+
+std::size_t slab_allocator::size_class(std::size_t size) {
+  // 16 byte steps up to 128 bytes, then four classes per power of two
+  if (size <= 128) {
+    return size == 0 ? 0 : (size - 1) / 16;
+  }
+  std::size_t shift = 63 - static_cast<std::size_t>(__builtin_clzll(size - 1));
+  std::size_t base = static_cast<std::size_t>(1) << shift;
+  return 8 + (shift - 7) * 4 + (size - 1 - base) / (base / 4);
+}
+
+std::size_t slab_allocator::class_size(std::size_t cls) {
+  if (cls < 8) {
+    return (cls + 1) * 16;
+  }
+  std::size_t base = static_cast<std::size_t>(1) << (7 + (cls - 8) / 4);
+  return base + ((cls - 8) % 4 + 1) * (base / 4);
+}
+
+std::size_t slab_allocator::objects_per_slab(std::size_t cls) {
+  return (SLAB_SIZE - SLAB_HEADER_SIZE) / class_size(cls);
+}
+
+slab_allocator::thread_cache *slab_allocator::local_cache() {
+  static thread_local thread_caches local;
+  if (local.last_id == id_) {
+    return local.last;
+  }
+  auto it = local.caches.find(id_);
+  if (it == local.caches.end()) {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    // Drop caches of destroyed allocators; their objects went away with the slabs
+    for (auto entry = local.caches.begin(); entry != local.caches.end();) {
+      if (registry().find(entry->first) == registry().end()) {
+        delete entry->second;
+        entry = local.caches.erase(entry);
+      } else {
+        ++entry;
+      }
+    }
+    it = local.caches.emplace(id_, new thread_cache()).first;
+  }
+  local.last_id = id_;
+  local.last = it->second;
+  return local.last;
+}
+
+bool slab_allocator::refill(thread_cache *cache, std::size_t cls) {
+  auto &central = central_[cls];
+  std::lock_guard<std::mutex> lock(central.mtx);
+  if (central.head == nullptr && new_slab(cls) == nullptr) {
+    return false;
+  }
+  auto batch = batch_size(cls);
+  std::size_t n = 0;
+  while (n < batch && central.head != nullptr) {
+    auto slab = central.head;
+    while (n < batch && slab->free != nullptr) {
+      auto obj = slab->free;
+      slab->free = obj->next;
+      --slab->free_count;
+      obj->next = cache->head[cls];
+      cache->head[cls] = obj;
+      ++n;
+    }
+    if (slab->free == nullptr) {
+      // Out of free objects, drop it from the central list until one comes back
+      central.head = slab->next;
+      if (central.head != nullptr) {
+        central.head->prev = nullptr;
+      }
+    }
+  }
+  cache->count[cls] += n;
+  return true;
+}
+
+void slab_allocator::release(thread_cache *cache, std::size_t cls, std::size_t n) {
+  auto &central = central_[cls];
+  auto capacity = objects_per_slab(cls);
+  std::lock_guard<std::mutex> lock(central.mtx);
+  std::size_t moved = 0;
+  while (moved < n && cache->head[cls] != nullptr) {
+    auto obj = cache->head[cls];
+    cache->head[cls] = obj->next;
+    ++moved;
+    auto slab = reinterpret_cast<slab_header *>(reinterpret_cast<uintptr_t>(obj) & ~static_cast<uintptr_t>(SLAB_SIZE - 1));
+    if (slab->free == nullptr) {
+      slab->prev = nullptr;
+      slab->next = central.head;
+      if (central.head != nullptr) {
+        central.head->prev = slab;
+      }
+      central.head = slab;
+    }
+    obj->next = slab->free;
+    slab->free = obj;
+    if (++slab->free_count == capacity) {
+      if (slab->prev != nullptr) {
+        slab->prev->next = slab->next;
+      } else {
+        central.head = slab->next;
+      }
+      if (slab->next != nullptr) {
+        slab->next->prev = slab->prev;
+      }
+      free_slab(slab);
+    }
+  }
+  cache->count[cls] -= moved;
+}
+
+slab_allocator::slab_header *slab_allocator::new_slab(std::size_t cls) {
+  auto mem = static_cast<char *>(raw_allocate(SLAB_SIZE, SLAB_SIZE));
+  if (mem == nullptr) {
+    return nullptr;
+  }
+  static_assert(sizeof(slab_header) <= SLAB_HEADER_SIZE, "Slab header does not fit");
+  auto slab = new(mem) slab_header();
+  auto size = class_size(cls);
+  auto capacity = objects_per_slab(cls);
+  for (std::size_t i = capacity; i > 0; --i) {
+    auto obj = reinterpret_cast<free_object *>(mem + SLAB_HEADER_SIZE + (i - 1) * size);
+    obj->next = slab->free;
+    slab->free = obj;
+  }
+  slab->free_count = capacity;
+  auto &central = central_[cls];
+  slab->next = central.head;
+  if (central.head != nullptr) {
+    central.head->prev = slab;
+  }
+  central.head = slab;
+  {
+    std::lock_guard<std::mutex> slabs_lock(slabs_mtx_);
+    slabs_.emplace(reinterpret_cast<uintptr_t>(mem), cls);
+  }
+  account(static_cast<int64_t>(SLAB_SIZE));
+  return slab;
+}
+
+void slab_allocator::free_slab(slab_header *slab) {
+  {
+    std::lock_guard<std::mutex> slabs_lock(slabs_mtx_);
+    slabs_.erase(reinterpret_cast<uintptr_t>(slab));
+  }
+  raw_free(slab);
+  account(-static_cast<int64_t>(SLAB_SIZE));
+}
+
+void *slab_allocator::raw_allocate(std::size_t size, std::size_t alignment) {
+  #ifdef MEMKIND_IN_USE
+    if (alignment == 0) {
+      return memkind_malloc((struct memkind *) mem_kind_, size);
+    }
+    void *ptr = nullptr;
+    if (memkind_posix_memalign((struct memkind *) mem_kind_, &ptr, alignment, size) != 0) {
+      return nullptr;
+    }
+    return ptr;
+  #else
+    return mallocx(size, alignment == 0 ? 0 : MALLOCX_ALIGN(alignment));
+  #endif
+}
+
+void slab_allocator::raw_free(void *ptr) {
+  #ifdef MEMKIND_IN_USE
+    memkind_free((struct memkind *) mem_kind_, ptr);
+  #else
+    free(ptr);
+  #endif
+}
+
+void slab_allocator::account(int64_t delta) {
+  static thread_local std::size_t counter = next_counter.fetch_add(1) % NUM_COUNTERS;
+  used_[counter].bytes.fetch_add(delta, std::memory_order_relaxed);
+}
+
+}
+}
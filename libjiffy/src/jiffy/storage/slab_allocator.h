@@ -0,0 +1,236 @@
+#ifndef JIFFY_SLAB_ALLOCATOR_H
+#define JIFFY_SLAB_ALLOCATOR_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace jiffy {
+namespace storage {
+
+/**
+ * @brief Size-class slab allocator for a single memory block.
+ *
+ * Small allocations are rounded up to one of a fixed set of size classes and
+ * carved out of 64 KB slabs; each thread keeps its own free lists, so the
+ * common path takes no lock. A slab is returned to the underlying allocator
+ * once all of its objects are back on the shared free lists. Allocations
+ * larger than the largest size class go straight to the underlying
+ * allocator, prefixed with their size.
+ */
+class slab_allocator {
+ public:
+  /* Slab size */
+  static const std::size_t SLAB_SIZE = 65536;
+  /* Largest allocation served from slabs */
+  static const std::size_t MAX_SLAB_OBJECT_SIZE = 4096;
+  /* Number of size classes */
+  static const std::size_t NUM_SIZE_CLASSES = 28;
+  /* Bytes at the start of each slab reserved for its header */
+  static const std::size_t SLAB_HEADER_SIZE = 64;
+
+  /**
+   * @brief Constructor
+   * @param memory_mode Memory mode
+   * @param mem_kind Memory kind
+   */
+
+  slab_allocator(const std::string &memory_mode, void *mem_kind);
+
+  /**
+   * @brief Destructor, releases all slabs
+   */
+
+  ~slab_allocator();
+
+  slab_allocator(const slab_allocator &) = delete;
+  slab_allocator &operator=(const slab_allocator &) = delete;
+
+  /**
+   * @brief Allocate memory
+   * @param size Number of bytes to allocate
+   * @return Pointer to allocated memory, null if allocation fails
+   */
+
+  void *allocate(std::size_t size);
+
+  /**
+   * @brief Free memory
+   * @param ptr Pointer to memory allocation
+   * @param size Number of bytes requested when allocating
+   */
+
+  void deallocate(void *ptr, std::size_t size);
+
+  /**
+   * @brief Free memory whose size is not known to the caller
+   * @param ptr Pointer to memory allocation
+   */
+
+  void deallocate(void *ptr);
+
+  /**
+   * @brief Fetch number of bytes taken from the underlying allocator, counting
+   * whole slabs and the requested size of large allocations
+   * @return Number of bytes allocated
+   */
+
+  std::size_t used() const;
+
+  /**
+   * @brief Fetch size class for allocation size
+   * @param size Allocation size, at most MAX_SLAB_OBJECT_SIZE
+   * @return Size class
+   */
+
+  static std::size_t size_class(std::size_t size);
+
+  /**
+   * @brief Fetch object size of size class
+   * @param cls Size class
+   * @return Object size
+   */
+
+  static std::size_t class_size(std::size_t cls);
+
+  /**
+   * @brief Fetch number of objects in a slab of a size class
+   * @param cls Size class
+   * @return Number of objects
+   */
+
+  static std::size_t objects_per_slab(std::size_t cls);
+
+ private:
+  /* Free object, linked through its first word */
+  struct free_object {
+    free_object *next;
+  };
+
+  /* Slab header, at the start of the slab; guarded by the size class's central list */
+  struct slab_header {
+    /* Free objects of the slab that are not in a thread cache */
+    free_object *free;
+    /* Number of free objects */
+    std::size_t free_count;
+    /* Neighbours in the central list while the slab has free objects */
+    slab_header *prev;
+    slab_header *next;
+  };
+
+  /* Slabs with free objects, shared by all threads for one size class */
+  struct central_list {
+    std::mutex mtx;
+    slab_header *head{nullptr};
+  };
+
+  /* Per-thread free lists */
+  struct thread_cache {
+    std::array<free_object *, NUM_SIZE_CLASSES> head{};
+    std::array<std::size_t, NUM_SIZE_CLASSES> count{};
+  };
+
+  /* Per-thread free lists of every live slab allocator */
+  struct thread_caches {
+    ~thread_caches();
+    uint64_t last_id{0};
+    thread_cache *last{nullptr};
+    std::unordered_map<uint64_t, thread_cache *> caches;
+  };
+
+  /* Byte counter padded to a cache line */
+  struct byte_counter {
+    std::atomic<int64_t> bytes{0};
+    char padding[64 - sizeof(std::atomic<int64_t>)];
+  };
+
+  static const std::size_t NUM_COUNTERS = 16;
+
+  /**
+   * @brief Fetch calling thread's free lists, creating them if needed
+   * @return Calling thread's free lists
+   */
+
+  thread_cache *local_cache();
+
+  /**
+   * @brief Move a batch of free objects of a size class into a thread cache
+   * @param cache Thread cache
+   * @param cls Size class
+   * @return True if at least one object was moved
+   */
+
+  bool refill(thread_cache *cache, std::size_t cls);
+
+  /**
+   * @brief Move a batch of free objects of a size class out of a thread cache,
+   * freeing slabs that become empty
+   * @param cache Thread cache
+   * @param cls Size class
+   * @param n Number of objects to move
+   */
+
+  void release(thread_cache *cache, std::size_t cls, std::size_t n);
+
+  /**
+   * @brief Allocate a slab whose objects are all free, with the central list's mutex held
+   * @param cls Size class
+   * @return Slab header, null on failure
+   */
+
+  slab_header *new_slab(std::size_t cls);
+
+  /**
+   * @brief Free an empty slab, with the central list's mutex held
+   * @param slab Slab header
+   */
+
+  void free_slab(slab_header *slab);
+
+  /**
+   * @brief Allocate memory from the underlying allocator
+   * @param size Number of bytes
+   * @param alignment Alignment, or zero for default alignment
+   * @return Pointer to memory, null on failure
+   */
+
+  void *raw_allocate(std::size_t size, std::size_t alignment);
+
+  /**
+   * @brief Free memory allocated with raw_allocate
+   * @param ptr Pointer to memory
+   */
+
+  void raw_free(void *ptr);
+
+  /**
+   * @brief Add to allocated bytes
+   * @param delta Number of bytes allocated, negative if freed
+   */
+
+  void account(int64_t delta);
+
+  /* Unique identifier, never reused */
+  uint64_t id_;
+  /* Memory mode */
+  std::string memory_mode_;
+  /* Memory kind */
+  void *mem_kind_;
+  /* Free lists shared by all threads */
+  std::array<central_list, NUM_SIZE_CLASSES> central_;
+  /* Mutex protecting slabs */
+  std::mutex slabs_mtx_;
+  /* Slab address to size class */
+  std::unordered_map<uintptr_t, std::size_t> slabs_;
+  /* Allocated bytes, striped across threads */
+  std::array<byte_counter, NUM_COUNTERS> used_;
+};
+
+}
+}
+
+#endif //JIFFY_SLAB_ALLOCATOR_H
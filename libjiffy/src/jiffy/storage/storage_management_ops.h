@@ -2,7 +2,9 @@
 #define JIFFY_KV_SERVICE_H
 
 #include <cstddef>
+#include <map>
 #include <string>
+#include <vector>
 #include <jiffy/utils/property_map.h>
 
 #include "jiffy/persistent/persistent_service.h"
@@ -11,6 +13,30 @@
 namespace jiffy {
 namespace storage {
 
+/* Partition and replica chain setup for a single block */
+struct partition_setup {
+  /* Block identifier */
+  std::string block_id;
+  /* Partition type */
+  std::string type;
+  /* Backing path */
+  std::string backing_path;
+  /* Partition name */
+  std::string name;
+  /* Partition metadata */
+  std::string metadata;
+  /* Partition configuration parameters */
+  std::map<std::string, std::string> conf;
+  /* File path */
+  std::string path;
+  /* Replica chain */
+  std::vector<std::string> chain;
+  /* Chain role */
+  int32_t role;
+  /* Next block identifier */
+  std::string next_block_id;
+};
+
 /* Storage management operation virtual class */
 class storage_management_ops {
  public:
@@ -48,6 +74,18 @@ class storage_management_ops {
   virtual void update_partition(const std::string &block_id,
                                 const std::string &partition_name,
                                 const std::string &partition_metadata) = 0;
+
+  /**
+   * @brief Create partitions and set up their replica chains, by default one block at a time
+   * @param partitions Partition and chain setup for each block
+   */
+
+  virtual void create_partitions(const std::vector<partition_setup> &partitions) {
+    for (const auto &p: partitions) {
+      create_partition(p.block_id, p.type, p.backing_path, p.name, p.metadata, p.conf);
+      setup_chain(p.block_id, p.path, p.chain, p.role, p.next_block_id);
+    }
+  }
 };
 
 }
@@ -72,6 +72,13 @@ byte_string::byte_string(const byte_string &other)
   memcpy(data_, other.data_, size_);
 }
 
+byte_string::byte_string(const byte_string &other, const binary_allocator &allocator)
+    : size_(other.size_),
+      allocator_(allocator),
+      data_(allocator_.allocate(size_)) {
+  memcpy(data_, other.data_, size_);
+}
+
 byte_string::byte_string(byte_string &&other)
     : size_(other.size_),
       allocator_(other.allocator_),
@@ -139,6 +146,9 @@ byte_string &byte_string::operator--() {
 }
 
 byte_string &byte_string::operator=(const byte_string &other) {
+  if (this == &other)
+    return *this;
+  allocator_.deallocate(data_, size_);
   size_ = other.size_;
   allocator_ = other.allocator_;
   data_ = allocator_.allocate(size_);
@@ -169,6 +179,9 @@ std::string byte_string::to_string() const {
 }
 
 byte_string &byte_string::operator=(byte_string &&other) {
+  if (this == &other)
+    return *this;
+  allocator_.deallocate(data_, size_);
   size_ = other.size_;
   allocator_ = other.allocator_;
   data_ = other.data_;
@@ -242,6 +242,13 @@ class byte_string {
    */
   byte_string(const byte_string &other);
 
+  /**
+   * Constructs a byte_string from another byte_string, in memory from another allocator
+   * @param other A reference to the other byte_string to copy from
+   * @param allocator Allocator for the copy
+   */
+  byte_string(const byte_string &other, const binary_allocator &allocator);
+
   /**
    * Initializes a given byte_string
    * @param other A double referenced byte_string to be initialized
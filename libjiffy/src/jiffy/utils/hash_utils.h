@@ -0,0 +1,116 @@
+#ifndef JIFFY_HASH_UTILS_H
+#define JIFFY_HASH_UTILS_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+namespace jiffy {
+namespace utils {
+
+/* Hash utility class
+ * 64-bit multiply-mix hash in the style of wyhash. Reads eight bytes at a
+ * time and, for long inputs, keeps three independent mixing lanes so the
+ * multiplications overlap in the pipeline. Not stable across endianness,
+ * so only meant for in-memory indexes, never for data placement */
+class hash_utils {
+ public:
+  /**
+   * @brief Hash byte sequence
+   * @param data Data pointer
+   * @param len Data length
+   * @param seed Hash seed
+   * @return Hash value
+   */
+  static inline uint64_t hash(const void *data, std::size_t len, uint64_t seed = 0) {
+    auto p = static_cast<const uint8_t *>(data);
+    seed ^= mix(seed ^ S0, S1);
+    uint64_t a, b;
+    if (len <= 16) {
+      if (len >= 4) {
+        a = (read32(p) << 32) | read32(p + ((len >> 3) << 2));
+        b = (read32(p + len - 4) << 32) | read32(p + len - 4 - ((len >> 3) << 2));
+      } else if (len > 0) {
+        a = read3(p, len);
+        b = 0;
+      } else {
+        a = b = 0;
+      }
+    } else {
+      std::size_t i = len;
+      if (i > 48) {
+        uint64_t seed1 = seed, seed2 = seed;
+        do {
+          seed = mix(read64(p) ^ S1, read64(p + 8) ^ seed);
+          seed1 = mix(read64(p + 16) ^ S2, read64(p + 24) ^ seed1);
+          seed2 = mix(read64(p + 32) ^ S3, read64(p + 40) ^ seed2);
+          p += 48;
+          i -= 48;
+        } while (i > 48);
+        seed ^= seed1 ^ seed2;
+      }
+      while (i > 16) {
+        seed = mix(read64(p) ^ S1, read64(p + 8) ^ seed);
+        p += 16;
+        i -= 16;
+      }
+      a = read64(p + i - 16);
+      b = read64(p + i - 8);
+    }
+    a ^= S1;
+    b ^= seed;
+    multiply(a, b);
+    return mix(a ^ S0 ^ len, b ^ S1);
+  }
+
+ private:
+  static constexpr uint64_t S0 = 0xa0761d6478bd642full;
+  static constexpr uint64_t S1 = 0xe7037ed1a0b428dbull;
+  static constexpr uint64_t S2 = 0x8ebc6af09c88c6e3ull;
+  static constexpr uint64_t S3 = 0x589965cc75374cc3ull;
+
+  /* Full 128-bit product of a and b, low half in a and high half in b */
+  static inline void multiply(uint64_t &a, uint64_t &b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = a;
+    r *= b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+#else
+    uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    a = lo;
+    b = hi;
+#endif
+  }
+
+  static inline uint64_t mix(uint64_t a, uint64_t b) {
+    multiply(a, b);
+    return a ^ b;
+  }
+
+  static inline uint64_t read64(const uint8_t *p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  static inline uint64_t read32(const uint8_t *p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  static inline uint64_t read3(const uint8_t *p, std::size_t k) {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+  }
+};
+
+}
+}
+
+#endif //JIFFY_HASH_UTILS_H
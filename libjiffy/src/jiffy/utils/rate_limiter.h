@@ -0,0 +1,53 @@
+#ifndef JIFFY_RATE_LIMITER_H
+#define JIFFY_RATE_LIMITER_H
+
+#include <cstdint>
+#include <thread>
+#include "time_utils.h"
+
+namespace jiffy {
+namespace utils {
+/* Rate limiter class, paces a stream of work to a number of units per second */
+class rate_limiter {
+ public:
+  /**
+   * @brief Constructor
+   * @param units_per_sec Number of units per second, 0 for no limit
+   */
+
+  explicit rate_limiter(std::size_t units_per_sec = 0) : units_per_sec_(units_per_sec), start_us_(0), units_(0) {}
+
+  /**
+   * @brief Account for units of work, sleeping until they are within the rate
+   * Sleeps only once the work is a millisecond ahead, so short bursts go through
+   * @param units Number of units
+   */
+
+  void acquire(std::size_t units) {
+    if (units_per_sec_ == 0) {
+      return;
+    }
+    auto now = time_utils::now_us();
+    if (start_us_ == 0) {
+      start_us_ = now;
+    }
+    units_ += units;
+    auto due = start_us_ + static_cast<uint64_t>(units_ * 1000000.0 / units_per_sec_);
+    if (due > now + 1000) {
+      std::this_thread::sleep_for(std::chrono::microseconds(due - now));
+    }
+  }
+
+ private:
+  /* Number of units per second */
+  std::size_t units_per_sec_;
+  /* Time of the first unit in microseconds */
+  uint64_t start_us_;
+  /* Number of units so far */
+  uint64_t units_;
+};
+
+}
+}
+
+#endif //JIFFY_RATE_LIMITER_H
@@ -19,6 +19,7 @@
 #include "jiffy/directory/fs/sync_worker.h"
 #include "jiffy/directory/lease/lease_expiry_worker.h"
 #include "jiffy/auto_scaling/auto_scaling_server.h"
+#include "jiffy/auto_scaling/auto_scaling_scheduler.h"
 #include "jiffy/utils/rand_utils.h"
 
 using namespace jiffy::client;
@@ -34,6 +35,58 @@ using namespace ::apache::thrift::transport;
 #define STORAGE_MANAGEMENT_PORT 9092
 #define AUTO_SCALING_SERVICE_PORT 9095
 
+TEST_CASE("auto_scaling_scheduler_test", "[submit][stats]") {
+  auto_scaling_scheduler scheduler(4);
+  scheduler.start();
+  std::mutex mtx;
+  std::map<std::string, std::vector<int>> order;
+  std::map<std::string, int> running;
+  std::atomic<int> max_paths_running(0), paths_running(0);
+  bool overlap = false;
+  for (int i = 0; i < 10; ++i) {
+    for (const auto &path: {"/a", "/b", "/c", "/d"}) {
+      std::string p(path);
+      scheduler.submit(p, [&, p, i] {
+        {
+          std::unique_lock<std::mutex> lock(mtx);
+          // Requests on the same path never overlap
+          if (running[p]++ > 0)
+            overlap = true;
+          order[p].push_back(i);
+        }
+        auto n = ++paths_running;
+        int cur = max_paths_running.load();
+        while (n > cur && !max_paths_running.compare_exchange_weak(cur, n));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        --paths_running;
+        std::unique_lock<std::mutex> lock(mtx);
+        --running[p];
+      });
+    }
+  }
+  scheduler.submit("/a", [] { throw std::runtime_error("failed"); });
+  while (scheduler.stats().num_completed < 41) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  scheduler.stop();
+
+  auto stats = scheduler.stats();
+  REQUIRE(stats.num_submitted == 41);
+  REQUIRE(stats.num_completed == 41);
+  REQUIRE(stats.num_failed == 1);
+  REQUIRE(stats.num_queued == 0);
+  REQUIRE(stats.num_running == 0);
+  REQUIRE(stats.max_queue_delay_us > 0);
+  REQUIRE(stats.total_queue_delay_us >= stats.max_queue_delay_us);
+  REQUIRE_FALSE(overlap);
+  // Different paths run in parallel, bounded by the number of workers
+  REQUIRE(max_paths_running.load() > 1);
+  REQUIRE(max_paths_running.load() <= 4);
+  for (const auto &entry: order) {
+    REQUIRE(entry.second == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+  }
+}
+
 TEST_CASE("hash_table_auto_scale_up_test", "[directory_service][storage_server][management_server]") {
   auto alloc = std::make_shared<sequential_block_allocator>();
   auto block_names = test_utils::init_block_names(100, STORAGE_SERVICE_PORT, STORAGE_MANAGEMENT_PORT);
@@ -100,6 +153,98 @@ TEST_CASE("hash_table_auto_scale_up_test", "[directory_service][storage_server][
   }
 }
 
+TEST_CASE("hash_table_auto_scale_allocation_failure_test", "[directory_service][storage_server][management_server]") {
+  // Fails block allocation while set, the way a directory out of free blocks does
+  class failing_block_allocator : public sequential_block_allocator {
+   public:
+    std::vector<std::string> allocate(std::size_t count, const std::vector<std::string> &hints) override {
+      if (fail.load()) {
+        ++failures;
+        throw std::out_of_range("Injected allocation failure");
+      }
+      return sequential_block_allocator::allocate(count, hints);
+    }
+
+    std::atomic_bool fail{false};
+    std::atomic<std::size_t> failures{0};
+  };
+
+  auto alloc = std::make_shared<failing_block_allocator>();
+  auto block_names = test_utils::init_block_names(100, STORAGE_SERVICE_PORT, STORAGE_MANAGEMENT_PORT);
+  alloc->add_blocks(block_names);
+
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  auto blocks = test_utils::init_hash_table_blocks(block_names, memory_mode, mem_kind, 2200, 0.05, 0.5);
+
+  auto storage_server = block_server::create(blocks, STORAGE_SERVICE_PORT);
+  std::thread storage_serve_thread([&storage_server] { storage_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_SERVICE_PORT);
+
+  auto mgmt_server = storage_management_server::create(blocks, HOST, STORAGE_MANAGEMENT_PORT);
+  std::thread mgmt_serve_thread([&mgmt_server] { mgmt_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_MANAGEMENT_PORT);
+
+  auto as_server = auto_scaling_server::create(HOST, DIRECTORY_SERVICE_PORT, HOST, AUTO_SCALING_SERVICE_PORT);
+  std::thread auto_scaling_thread([&as_server] { as_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, AUTO_SCALING_SERVICE_PORT);
+
+  auto sm = std::make_shared<storage_manager>();
+  auto t = std::make_shared<directory_tree>(alloc, sm);
+
+  auto dir_server = directory_server::create(t, HOST, DIRECTORY_SERVICE_PORT);
+  std::thread dir_serve_thread([&dir_server] { dir_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, DIRECTORY_SERVICE_PORT);
+
+  auto status = t->create("/sandbox/scale_fail.txt", "hashtable", "/tmp", 1, 1, 0, perms::all(),
+                          {"0_65536"}, {"regular"}, {});
+  hash_table_client client(t, "/sandbox/scale_fail.txt", status);
+
+  // Write until the partition asks to split and the split fails
+  alloc->fail = true;
+  std::size_t num_keys = 0;
+  while (alloc->failures.load() == 0) {
+    REQUIRE_NOTHROW(client.put(std::to_string(num_keys), std::to_string(num_keys)));
+    ++num_keys;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  REQUIRE(t->dstatus("/sandbox/scale_fail.txt").data_blocks().size() == 1);
+
+  // The partition learns of the failure, so a later write splits it once blocks can be allocated again
+  alloc->fail = false;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (t->dstatus("/sandbox/scale_fail.txt").data_blocks().size() == 1
+      && std::chrono::steady_clock::now() < deadline) {
+    REQUIRE_NOTHROW(client.update("0", "0"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  REQUIRE(t->dstatus("/sandbox/scale_fail.txt").data_blocks().size() == 2);
+
+  for (std::size_t i = 0; i < num_keys; i++) {
+    REQUIRE(client.get(std::to_string(i)) == std::to_string(i));
+  }
+  t->remove("/sandbox/scale_fail.txt");
+  as_server->stop();
+  if (auto_scaling_thread.joinable()) {
+    auto_scaling_thread.join();
+  }
+
+  storage_server->stop();
+  if (storage_serve_thread.joinable()) {
+    storage_serve_thread.join();
+  }
+
+  mgmt_server->stop();
+  if (mgmt_serve_thread.joinable()) {
+    mgmt_serve_thread.join();
+  }
+
+  dir_server->stop();
+  if (dir_serve_thread.joinable()) {
+    dir_serve_thread.join();
+  }
+}
+
 TEST_CASE("hash_table_auto_scale_down_test", "[directory_service][storage_server][management_server]") {
   auto alloc = std::make_shared<sequential_block_allocator>();
   auto block_names = test_utils::init_block_names(100, STORAGE_SERVICE_PORT, STORAGE_MANAGEMENT_PORT);
@@ -104,6 +104,292 @@ TEST_CASE("chain_replication_no_failure_test", "[put][get]") {
   }
 }
 
+TEST_CASE("chain_replication_pipelined_test", "[put][get]") {
+  std::vector<std::vector<std::string>> block_names(NUM_BLOCKS);
+  std::vector<std::vector<std::shared_ptr<block>>> blocks(NUM_BLOCKS);
+  std::vector<std::shared_ptr<TServer>> management_servers(NUM_BLOCKS);
+  std::vector<std::shared_ptr<TServer>> chain_servers(NUM_BLOCKS);
+  std::vector<std::shared_ptr<TServer>> storage_servers(NUM_BLOCKS);
+  std::vector<std::thread> server_threads;
+
+  auto alloc = std::make_shared<sequential_block_allocator>();
+  for (int32_t i = 0; i < NUM_BLOCKS; i++) {
+    block_names[i] = test_utils::init_block_names(1,
+                                                  STORAGE_SERVICE_PORT_N(i),
+                                                  STORAGE_MANAGEMENT_PORT_N(i));
+    alloc->add_blocks(block_names[i]);
+    std::string memory_mode = getenv("JIFFY_TEST_MODE");
+    void* mem_kind = test_utils::init_kind();
+    blocks[i] = test_utils::init_hash_table_blocks(block_names[i], memory_mode, mem_kind);
+
+    management_servers[i] = storage_management_server::create(blocks[i], HOST, STORAGE_MANAGEMENT_PORT_N(i));
+    server_threads.emplace_back([i, &management_servers] { management_servers[i]->serve(); });
+    test_utils::wait_till_server_ready(HOST, STORAGE_MANAGEMENT_PORT_N(i));
+
+    chain_servers[i] = block_server::create(blocks[i], STORAGE_CHAIN_PORT_N(i));
+    server_threads.emplace_back([i, &chain_servers] { chain_servers[i]->serve(); });
+    test_utils::wait_till_server_ready(HOST, STORAGE_CHAIN_PORT_N(i));
+
+    storage_servers[i] = block_server::create(blocks[i], STORAGE_SERVICE_PORT_N(i));
+    server_threads.emplace_back([i, &storage_servers] { storage_servers[i]->serve(); });
+    test_utils::wait_till_server_ready(HOST, STORAGE_SERVICE_PORT_N(i));
+  }
+
+  auto sm = std::make_shared<storage_manager>();
+  auto t = std::make_shared<directory_tree>(alloc, sm);
+
+  auto dserver = directory_server::create(t, HOST, DIRECTORY_SERVICE_PORT);
+  server_threads.emplace_back([&] { dserver->serve(); });
+  test_utils::wait_till_server_ready(HOST, DIRECTORY_SERVICE_PORT);
+
+  t->create("/file", "hashtable", "/tmp", 1, 3, 0, 0, {"0_65536"}, {"regular"});
+  auto chain = t->dstatus("/file").data_blocks()[0];
+
+  replica_chain_client client(t, "/file", chain, HT_OPS, 100);
+  // Keeps many writes in flight, so that the head forwards them down the chain in batches
+  std::vector<int64_t> seq_nos;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    seq_nos.push_back(client.send_command_pipelined({"put", std::to_string(i), std::to_string(i)}));
+  }
+  for (auto seq_no: seq_nos) {
+    REQUIRE(client.recv_response(seq_no).front() == "!ok");
+  }
+
+  for (size_t i = 0; i < NUM_BLOCKS; i++) {
+    auto ht = std::dynamic_pointer_cast<hash_table_partition>(blocks[i][0]->impl());
+    for (std::size_t j = 0; j < 1000; j++) {
+      response resp;
+      REQUIRE_NOTHROW(ht->get(resp, {"get", std::to_string(j)}));
+      REQUIRE(resp[0] == "!ok");
+      REQUIRE(resp[1] == std::to_string(j));
+    }
+  }
+
+  for (const auto &s: storage_servers) {
+    s->stop();
+  }
+
+  for (const auto &c: chain_servers) {
+    c->stop();
+  }
+
+  for (const auto &m: management_servers) {
+    m->stop();
+  }
+
+  dserver->stop();
+
+  for (auto &st: server_threads) {
+    if (st.joinable())
+      st.join();
+  }
+}
+
+TEST_CASE("chain_replication_resend_in_flight_test", "[put][get]") {
+  std::vector<std::vector<std::string>> block_names(NUM_BLOCKS);
+  std::vector<std::vector<std::shared_ptr<block>>> blocks(NUM_BLOCKS);
+  std::vector<std::shared_ptr<TServer>> management_servers(NUM_BLOCKS);
+  std::vector<std::shared_ptr<TServer>> chain_servers(NUM_BLOCKS);
+  std::vector<std::shared_ptr<TServer>> storage_servers(NUM_BLOCKS);
+  std::vector<std::thread> server_threads;
+
+  auto alloc = std::make_shared<sequential_block_allocator>();
+  for (int32_t i = 0; i < NUM_BLOCKS; i++) {
+    block_names[i] = test_utils::init_block_names(1,
+                                                  STORAGE_SERVICE_PORT_N(i),
+                                                  STORAGE_MANAGEMENT_PORT_N(i));
+    alloc->add_blocks(block_names[i]);
+    std::string memory_mode = getenv("JIFFY_TEST_MODE");
+    void* mem_kind = test_utils::init_kind();
+    blocks[i] = test_utils::init_hash_table_blocks(block_names[i], memory_mode, mem_kind);
+
+    management_servers[i] = storage_management_server::create(blocks[i], HOST, STORAGE_MANAGEMENT_PORT_N(i));
+    server_threads.emplace_back([i, &management_servers] { management_servers[i]->serve(); });
+    test_utils::wait_till_server_ready(HOST, STORAGE_MANAGEMENT_PORT_N(i));
+
+    chain_servers[i] = block_server::create(blocks[i], STORAGE_CHAIN_PORT_N(i));
+    server_threads.emplace_back([i, &chain_servers] { chain_servers[i]->serve(); });
+    test_utils::wait_till_server_ready(HOST, STORAGE_CHAIN_PORT_N(i));
+
+    storage_servers[i] = block_server::create(blocks[i], STORAGE_SERVICE_PORT_N(i));
+    server_threads.emplace_back([i, &storage_servers] { storage_servers[i]->serve(); });
+    test_utils::wait_till_server_ready(HOST, STORAGE_SERVICE_PORT_N(i));
+  }
+
+  auto sm = std::make_shared<storage_manager>();
+  auto t = std::make_shared<directory_tree>(alloc, sm);
+
+  auto dserver = directory_server::create(t, HOST, DIRECTORY_SERVICE_PORT);
+  server_threads.emplace_back([&] { dserver->serve(); });
+  test_utils::wait_till_server_ready(HOST, DIRECTORY_SERVICE_PORT);
+
+  t->create("/file", "hashtable", "/tmp", 1, 3, 0, 0, {"0_65536"}, {"regular"});
+  auto chain = t->dstatus("/file").data_blocks()[0];
+
+  replica_chain_client client(t, "/file", chain, HT_OPS, 100);
+  // Re-sends the pending requests the way the head does after reconnecting, while writes and their acks are in flight
+  auto head = blocks[0][0]->impl();
+  std::atomic_bool done(false);
+  std::thread resender([&head, &done] {
+    while (!done.load()) {
+      head->resend_pending();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  std::vector<int64_t> seq_nos;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    seq_nos.push_back(client.send_command_pipelined({"put", std::to_string(i), std::to_string(i)}));
+  }
+  for (auto seq_no: seq_nos) {
+    REQUIRE(client.recv_response(seq_no).front() == "!ok");
+  }
+  done = true;
+  resender.join();
+
+  for (size_t i = 0; i < NUM_BLOCKS; i++) {
+    auto ht = std::dynamic_pointer_cast<hash_table_partition>(blocks[i][0]->impl());
+    for (std::size_t j = 0; j < 1000; j++) {
+      response resp;
+      REQUIRE_NOTHROW(ht->get(resp, {"get", std::to_string(j)}));
+      REQUIRE(resp[0] == "!ok");
+      REQUIRE(resp[1] == std::to_string(j));
+    }
+  }
+
+  for (const auto &s: storage_servers) {
+    s->stop();
+  }
+
+  for (const auto &c: chain_servers) {
+    c->stop();
+  }
+
+  for (const auto &m: management_servers) {
+    m->stop();
+  }
+
+  dserver->stop();
+
+  for (auto &st: server_threads) {
+    if (st.joinable())
+      st.join();
+  }
+}
+
+TEST_CASE("chain_request_batch_test", "[batch]") {
+  std::vector<chain_op> ops(2);
+  ops[0].seq.client_id = 1;
+  ops[0].seq.client_seq_no = 2;
+  ops[0].seq.server_seq_no = 3;
+  ops[0].args = {"put", "a", "b"};
+  ops[1].seq.client_id = -1;
+  ops[1].seq.client_seq_no = 0;
+  ops[1].seq.server_seq_no = 4;
+  ops[1].args = {"remove", ""};
+
+  auto args = chain_module::encode_batch(ops);
+  REQUIRE(chain_module::is_batch(args));
+  REQUIRE_FALSE(chain_module::is_batch({"put", "a", "b"}));
+  auto decoded = chain_module::decode_batch(args);
+  REQUIRE(decoded.size() == 2);
+  for (std::size_t i = 0; i < ops.size(); i++) {
+    REQUIRE(decoded[i].seq.client_id == ops[i].seq.client_id);
+    REQUIRE(decoded[i].seq.client_seq_no == ops[i].seq.client_seq_no);
+    REQUIRE(decoded[i].seq.server_seq_no == ops[i].seq.server_seq_no);
+    REQUIRE(decoded[i].args == ops[i].args);
+  }
+
+  args.pop_back();
+  REQUIRE_THROWS_AS(chain_module::decode_batch(args), std::invalid_argument);
+  REQUIRE_THROWS_AS(chain_module::decode_batch({"!batch"}), std::invalid_argument);
+}
+
+TEST_CASE("chain_replication_replica_reads_test", "[put][get]") {
+  std::vector<std::vector<std::string>> block_names(NUM_BLOCKS);
+  std::vector<std::vector<std::shared_ptr<block>>> blocks(NUM_BLOCKS);
+  std::vector<std::shared_ptr<TServer>> management_servers(NUM_BLOCKS);
+  std::vector<std::shared_ptr<TServer>> chain_servers(NUM_BLOCKS);
+  std::vector<std::shared_ptr<TServer>> storage_servers(NUM_BLOCKS);
+  std::vector<std::thread> server_threads;
+
+  auto alloc = std::make_shared<sequential_block_allocator>();
+  for (int32_t i = 0; i < NUM_BLOCKS; i++) {
+    block_names[i] = test_utils::init_block_names(1,
+                                                  STORAGE_SERVICE_PORT_N(i),
+                                                  STORAGE_MANAGEMENT_PORT_N(i));
+    alloc->add_blocks(block_names[i]);
+    std::string memory_mode = getenv("JIFFY_TEST_MODE");
+    void* mem_kind = test_utils::init_kind();
+    blocks[i] = test_utils::init_hash_table_blocks(block_names[i], memory_mode, mem_kind);
+
+    management_servers[i] = storage_management_server::create(blocks[i], HOST, STORAGE_MANAGEMENT_PORT_N(i));
+    server_threads.emplace_back([i, &management_servers] { management_servers[i]->serve(); });
+    test_utils::wait_till_server_ready(HOST, STORAGE_MANAGEMENT_PORT_N(i));
+
+    chain_servers[i] = block_server::create(blocks[i], STORAGE_CHAIN_PORT_N(i));
+    server_threads.emplace_back([i, &chain_servers] { chain_servers[i]->serve(); });
+    test_utils::wait_till_server_ready(HOST, STORAGE_CHAIN_PORT_N(i));
+
+    storage_servers[i] = block_server::create(blocks[i], STORAGE_SERVICE_PORT_N(i));
+    server_threads.emplace_back([i, &storage_servers] { storage_servers[i]->serve(); });
+    test_utils::wait_till_server_ready(HOST, STORAGE_SERVICE_PORT_N(i));
+  }
+
+  auto sm = std::make_shared<storage_manager>();
+  auto t = std::make_shared<directory_tree>(alloc, sm);
+
+  auto dserver = directory_server::create(t, HOST, DIRECTORY_SERVICE_PORT);
+  server_threads.emplace_back([&] { dserver->serve(); });
+  test_utils::wait_till_server_ready(HOST, DIRECTORY_SERVICE_PORT);
+
+  t->create("/file", "hashtable", "/tmp", 1, 3, 0, 0, {"0_65536"}, {"regular"});
+  auto chain = t->dstatus("/file").data_blocks()[0];
+
+  replica_chain_client client(t, "/file", chain, HT_OPS, 100);
+  client.read_from_replicas(true);
+  REQUIRE(client.read_from_replicas());
+  // Reads right after each write may find the head and middle replicas dirty, and must still see the write
+  for (std::size_t i = 0; i < 1000; ++i) {
+    REQUIRE(client.run_command({"put", std::to_string(i), std::to_string(i)}).front() == "!ok");
+    for (std::size_t j = 0; j < NUM_BLOCKS; ++j) {
+      auto ret = client.run_command({"get", std::to_string(i)});
+      REQUIRE(ret[0] == "!ok");
+      REQUIRE(ret[1] == std::to_string(i));
+    }
+  }
+  for (std::size_t i = 1000; i < 2000; ++i) {
+    REQUIRE(client.run_command({"get", std::to_string(i)}).front() == "!key_not_found");
+  }
+
+  // Once all writes are acknowledged, every replica serves reads itself
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (size_t i = 0; i < NUM_BLOCKS; i++) {
+    response resp;
+    blocks[i][0]->impl()->run_command_direct(resp, {"get", "0"});
+    REQUIRE(resp[0] == "!ok");
+    REQUIRE(resp[1] == "0");
+  }
+
+  for (const auto &s: storage_servers) {
+    s->stop();
+  }
+
+  for (const auto &c: chain_servers) {
+    c->stop();
+  }
+
+  for (const auto &m: management_servers) {
+    m->stop();
+  }
+
+  dserver->stop();
+
+  for (auto &st: server_threads) {
+    if (st.joinable())
+      st.join();
+  }
+}
+
 TEST_CASE("chain_replication_head_failure_test", "[put][get]") {
   std::vector<std::vector<std::string>> block_names(NUM_BLOCKS);
   std::vector<std::vector<std::shared_ptr<block>>> blocks(NUM_BLOCKS);
@@ -358,6 +358,40 @@ TEST_CASE("tags_test", "[file]") {
   REQUIRE(tree.dstatus("/sandbox/file.txt").get_tag("key") == "value2");
 }
 
+TEST_CASE("hash_table_capacity_hint_test", "[file]") {
+  auto alloc = std::make_shared<dummy_block_allocator>(8);
+  auto sm = std::make_shared<dummy_storage_manager>();
+  sm->CAPACITY = 1000;
+  directory_tree tree(alloc, sm);
+
+  REQUIRE_NOTHROW(tree.create("/sandbox/a", "hashtable", "local://tmp", 1, 1, 0, perms::all(), {"0_65536"},
+                              {"regular"}, {{"hashtable.expected_bytes", "500"}}));
+  REQUIRE(tree.dstatus("/sandbox/a").data_blocks().size() == 1);
+  REQUIRE(tree.dstatus("/sandbox/a").data_blocks()[0].name == "0_65536");
+
+  REQUIRE_NOTHROW(tree.create("/sandbox/b", "hashtable", "local://tmp", 1, 1, 0, perms::all(), {"0_65536"},
+                              {"regular"}, {{"hashtable.expected_bytes", "3000"}}));
+  auto blocks = tree.dstatus("/sandbox/b").data_blocks();
+  REQUIRE(blocks.size() == 4);
+  REQUIRE(blocks[0].name == "0_16384");
+  REQUIRE(blocks[1].name == "16384_32768");
+  REQUIRE(blocks[2].name == "32768_49152");
+  REQUIRE(blocks[3].name == "49152_65536");
+  REQUIRE(alloc->num_allocated_blocks() == 5);
+
+  auto num_free_blocks = alloc->num_free_blocks();
+  REQUIRE_THROWS_AS(tree.create("/sandbox/c", "hashtable", "local://tmp", 1, 1, 0, perms::all(), {"0_65536"},
+                                {"regular"}, {{"hashtable.expected_bytes", "lots"}}), directory_ops_exception);
+  REQUIRE(alloc->num_free_blocks() == num_free_blocks);
+  REQUIRE(alloc->num_allocated_blocks() == 5);
+
+  // More partitions than free blocks
+  REQUIRE_THROWS(tree.create("/sandbox/d", "hashtable", "local://tmp", 1, 1, 0, perms::all(), {"0_65536"},
+                             {"regular"}, {{"hashtable.expected_bytes", "10000"}}));
+  REQUIRE(alloc->num_free_blocks() == num_free_blocks);
+  REQUIRE(alloc->num_allocated_blocks() == 5);
+}
+
 TEST_CASE("file_type_test", "[file][dir]") {
   auto alloc = std::make_shared<dummy_block_allocator>(4);
   auto sm = std::make_shared<dummy_storage_manager>();
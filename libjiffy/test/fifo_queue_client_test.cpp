@@ -81,6 +81,118 @@ TEST_CASE("fifo_queue_client_enqueue_dequeue_test", "[enqueue][dequeue]") {
 }
 
 
+TEST_CASE("fifo_queue_client_enqueue_batch_dequeue_batch_test", "[enqueue_batch][dequeue_batch]") {
+  auto alloc = std::make_shared<sequential_block_allocator>();
+  auto block_names = test_utils::init_block_names(NUM_BLOCKS, STORAGE_SERVICE_PORT, STORAGE_MANAGEMENT_PORT);
+  alloc->add_blocks(block_names);
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  auto blocks = test_utils::init_fifo_queue_blocks(block_names, memory_mode, mem_kind, 134217728, 0, 1);
+
+  auto storage_server = block_server::create(blocks, STORAGE_SERVICE_PORT);
+  std::thread storage_serve_thread([&storage_server] { storage_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_SERVICE_PORT);
+
+  auto mgmt_server = storage_management_server::create(blocks, HOST, STORAGE_MANAGEMENT_PORT);
+  std::thread mgmt_serve_thread([&mgmt_server] { mgmt_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_MANAGEMENT_PORT);
+
+  auto sm = std::make_shared<storage_manager>();
+  auto tree = std::make_shared<directory_tree>(alloc, sm);
+
+  auto dir_server = directory_server::create(tree, HOST, DIRECTORY_SERVICE_PORT);
+  std::thread dir_serve_thread([&dir_server] { dir_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, DIRECTORY_SERVICE_PORT);
+
+  data_status status = tree->create("/sandbox/file.txt", "fifoqueue", "/tmp", NUM_BLOCKS, 1, 0, 0,
+                                    {"0"}, {"regular"});
+
+  fifo_queue_client client(tree, "/sandbox/file.txt", status);
+
+  std::vector<std::string> items;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    items.push_back(std::to_string(i));
+  }
+  REQUIRE_NOTHROW(client.enqueue_batch(std::vector<std::string>(items.begin(), items.begin() + 500)));
+  REQUIRE_NOTHROW(client.enqueue_batch(std::vector<std::string>(items.begin() + 500, items.end())));
+  REQUIRE(client.read_next() == "0");
+  REQUIRE(client.dequeue_batch(300) == std::vector<std::string>(items.begin(), items.begin() + 300));
+  REQUIRE(client.front() == "300");
+  REQUIRE(client.dequeue_batch(1000) == std::vector<std::string>(items.begin() + 300, items.end()));
+  REQUIRE(client.dequeue_batch(10).empty());
+
+  storage_server->stop();
+  if (storage_serve_thread.joinable()) {
+    storage_serve_thread.join();
+  }
+
+  mgmt_server->stop();
+  if (mgmt_serve_thread.joinable()) {
+    mgmt_serve_thread.join();
+  }
+  dir_server->stop();
+  if (dir_serve_thread.joinable()) {
+    dir_serve_thread.join();
+  }
+}
+
+TEST_CASE("fifo_queue_client_dequeue_wait_read_next_wait_test", "[dequeue_wait][read_next_wait]") {
+  auto alloc = std::make_shared<sequential_block_allocator>();
+  auto block_names = test_utils::init_block_names(NUM_BLOCKS, STORAGE_SERVICE_PORT, STORAGE_MANAGEMENT_PORT);
+  alloc->add_blocks(block_names);
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  auto blocks = test_utils::init_fifo_queue_blocks(block_names, memory_mode, mem_kind, 134217728, 0, 1);
+
+  auto storage_server = block_server::create(blocks, STORAGE_SERVICE_PORT);
+  std::thread storage_serve_thread([&storage_server] { storage_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_SERVICE_PORT);
+
+  auto mgmt_server = storage_management_server::create(blocks, HOST, STORAGE_MANAGEMENT_PORT);
+  std::thread mgmt_serve_thread([&mgmt_server] { mgmt_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_MANAGEMENT_PORT);
+
+  auto sm = std::make_shared<storage_manager>();
+  auto tree = std::make_shared<directory_tree>(alloc, sm);
+
+  auto dir_server = directory_server::create(tree, HOST, DIRECTORY_SERVICE_PORT);
+  std::thread dir_serve_thread([&dir_server] { dir_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, DIRECTORY_SERVICE_PORT);
+
+  data_status status = tree->create("/sandbox/file.txt", "fifoqueue", "/tmp", NUM_BLOCKS, 1, 0, 0,
+                                    {"0"}, {"regular"});
+
+  fifo_queue_client consumer(tree, "/sandbox/file.txt", status);
+  REQUIRE_THROWS_AS(consumer.dequeue_wait(100), std::logic_error);
+  REQUIRE_THROWS_AS(consumer.read_next_wait(100), std::logic_error);
+
+  std::thread producer([&tree, &status] {
+    fifo_queue_client client(tree, "/sandbox/file.txt", status);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    client.enqueue("a");
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    client.enqueue("b");
+  });
+  REQUIRE(consumer.read_next_wait(5000) == "a");
+  REQUIRE(consumer.dequeue_wait(5000) == "a");
+  REQUIRE(consumer.dequeue_wait(5000) == "b");
+  producer.join();
+
+  storage_server->stop();
+  if (storage_serve_thread.joinable()) {
+    storage_serve_thread.join();
+  }
+
+  mgmt_server->stop();
+  if (mgmt_serve_thread.joinable()) {
+    mgmt_serve_thread.join();
+  }
+  dir_server->stop();
+  if (dir_serve_thread.joinable()) {
+    dir_serve_thread.join();
+  }
+}
+
 TEST_CASE("fifo_queue_client_enqueue_length_dequeue_test", "[enqueue][dequeue]") {
   auto alloc = std::make_shared<sequential_block_allocator>();
   auto block_names = test_utils::init_block_names(NUM_BLOCKS, STORAGE_SERVICE_PORT, STORAGE_MANAGEMENT_PORT);
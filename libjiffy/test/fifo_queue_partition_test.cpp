@@ -2,8 +2,11 @@
 #include "test_utils.h"
 #include "jiffy/storage/fifoqueue/fifo_queue_defs.h"
 #include "jiffy/storage/fifoqueue/fifo_queue_partition.h"
+#include "jiffy/utils/property_map.h"
 #include <vector>
 #include <string>
+#include <thread>
+#include <chrono>
 
 using namespace ::jiffy::storage;
 using namespace ::jiffy::persistent;
@@ -90,6 +93,112 @@ TEST_CASE("fifo_queue_enqueue_readnext_dequeue", "[enqueue][read_next][dequeue]"
   }
 }
 
+TEST_CASE("fifo_queue_enqueue_batch_dequeue_batch_test", "[enqueue_batch][dequeue_batch]") {
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  {
+    size_t capacity = 134217728;
+    block_memory_manager manager(capacity, memory_mode, mem_kind);
+    fifo_queue_partition block(&manager);
+    std::vector<std::string> items;
+    std::string framed;
+    for (std::size_t i = 0; i < 1000; ++i) {
+      items.push_back(std::to_string(i));
+      string_array::frame(framed, items.back());
+    }
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {"enqueue_batch", framed}));
+    REQUIRE(resp == response{"!ok"});
+    resp.clear();
+    REQUIRE_NOTHROW(block.run_command(resp, {"front"}));
+    REQUIRE(resp[1] == "0");
+    resp.clear();
+    REQUIRE_NOTHROW(block.run_command(resp, {"dequeue_batch", "400"}));
+    REQUIRE(resp[0] == "!ok");
+    REQUIRE(string_array::unframe(resp[1]) == std::vector<std::string>(items.begin(), items.begin() + 400));
+    resp.clear();
+    REQUIRE_NOTHROW(block.run_command(resp, {"dequeue"}));
+    REQUIRE(resp[1] == "400");
+    resp.clear();
+    REQUIRE_NOTHROW(block.run_command(resp, {"dequeue_batch", "1000"}));
+    REQUIRE(string_array::unframe(resp[1]) == std::vector<std::string>(items.begin() + 401, items.end()));
+    resp.clear();
+    REQUIRE_NOTHROW(block.run_command(resp, {"dequeue_batch", "1000"}));
+    REQUIRE(resp[0] == "!msg_not_found");
+    resp.clear();
+    REQUIRE_NOTHROW(block.run_command(resp, {"enqueue_batch", "abc"}));
+    REQUIRE(resp[0] == "!args_error");
+  }
+  {
+    // Only the first five items fit, the rest are redirected
+    size_t capacity = 100;
+    block_memory_manager manager(capacity, memory_mode, mem_kind);
+    property_map conf;
+    conf.set("fifoqueue.auto_scale", "false");
+    fifo_queue_partition block(&manager, "local://tmp", "0", "regular", conf);
+    std::vector<std::string> items;
+    std::string framed;
+    for (std::size_t i = 0; i < 6; ++i) {
+      items.push_back(std::string(10, static_cast<char>('a' + i)));
+      string_array::frame(framed, items.back());
+    }
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {"enqueue_batch", framed}));
+    REQUIRE(resp[0] == "!redirected_enqueue");
+    REQUIRE(resp.back() == std::to_string(5 * (string_array::METADATA_LEN + 10)));
+    resp.clear();
+    REQUIRE_NOTHROW(block.run_command(resp, {"dequeue_batch", "3"}));
+    REQUIRE(string_array::unframe(resp[1]) == std::vector<std::string>(items.begin(), items.begin() + 3));
+    resp.clear();
+    REQUIRE_NOTHROW(block.run_command(resp, {"dequeue_batch", "3"}));
+    REQUIRE(string_array::unframe(resp[1]) == std::vector<std::string>(items.begin() + 3, items.begin() + 5));
+    resp.clear();
+    REQUIRE_NOTHROW(block.run_command(resp, {"dequeue_batch", "3"}));
+    REQUIRE(resp[0] == "!redirected_dequeue");
+  }
+}
+
+TEST_CASE("fifo_queue_dequeue_wait_read_next_wait_test", "[dequeue_wait][read_next_wait]") {
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  block_memory_manager manager(capacity, memory_mode, mem_kind);
+  fifo_queue_partition block(&manager);
+
+  sequence_id seq;
+  seq.client_id = -1;
+  response resp;
+  REQUIRE_NOTHROW(block.run_command(resp, {"dequeue_wait", "10"}));
+  REQUIRE(resp[0] == "!msg_not_found");
+  REQUIRE(block.defer_response(seq, {"dequeue_wait", "10"}, resp));
+  REQUIRE_FALSE(block.defer_response(seq, {"dequeue", "10"}, resp));
+  resp.clear();
+  REQUIRE_NOTHROW(block.run_command(resp, {"read_next_wait", "10000"}));
+  REQUIRE(resp[0] == "!msg_not_found");
+  REQUIRE(block.defer_response(seq, {"read_next_wait", "10000"}, resp));
+  resp.clear();
+  REQUIRE_NOTHROW(block.run_command(resp, {"dequeue_wait", "x"}));
+  REQUIRE(resp[0] == "!args_error");
+
+  // Let the first wait expire while the second is still held
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  resp.clear();
+  REQUIRE_NOTHROW(block.run_command(resp, {"enqueue", "a"}));
+  REQUIRE(resp[0] == "!ok");
+
+  resp.clear();
+  REQUIRE_NOTHROW(block.run_command(resp, {"dequeue_wait", "10"}));
+  REQUIRE(resp[0] == "!ok");
+  REQUIRE_FALSE(block.defer_response(seq, {"dequeue_wait", "10"}, resp));
+  resp.clear();
+  REQUIRE_NOTHROW(block.run_command(resp, {"read_next_wait", "10"}));
+  REQUIRE(resp[0] == "!msg_not_found");
+  resp.clear();
+  REQUIRE_NOTHROW(block.run_command(resp, {"dequeue"}));
+  REQUIRE(resp[0] == "!ok");
+  REQUIRE(resp[1] == "a");
+}
+
 TEST_CASE("fifo_queue_storage_size_test", "[put][size][storage_size][reset]") {
   
   std::string memory_mode = getenv("JIFFY_TEST_MODE");
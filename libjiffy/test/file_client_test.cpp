@@ -88,6 +88,57 @@ TEST_CASE("file_client_write_read_seek_test", "[write][read][seek]") {
 }
 
 
+TEST_CASE("file_client_bulk_load_test", "[bulk_load][read][seek]") {
+  auto alloc = std::make_shared<sequential_block_allocator>();
+  auto block_names = test_utils::init_block_names(NUM_BLOCKS, STORAGE_SERVICE_PORT, STORAGE_MANAGEMENT_PORT);
+  alloc->add_blocks(block_names);
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  auto blocks = test_utils::init_file_blocks(block_names, memory_mode, mem_kind, 134217728);
+
+  auto storage_server = block_server::create(blocks, STORAGE_SERVICE_PORT);
+  std::thread storage_serve_thread([&storage_server] { storage_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_SERVICE_PORT);
+
+  auto mgmt_server = storage_management_server::create(blocks, HOST, STORAGE_MANAGEMENT_PORT);
+  std::thread mgmt_serve_thread([&mgmt_server] { mgmt_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_MANAGEMENT_PORT);
+
+  auto sm = std::make_shared<storage_manager>();
+  auto tree = std::make_shared<directory_tree>(alloc, sm);
+
+  data_status status = tree->create("/sandbox/file.txt", "file", "/tmp", NUM_BLOCKS, 1, 0, 0,
+                                  {"0"}, {"regular"});
+
+  file_client client(tree, "/sandbox/file.txt", status);
+
+  std::string expected;
+  std::size_t i = 0;
+  REQUIRE(client.bulk_load([&](std::string &chunk) {
+    if (i == 1000) {
+      return false;
+    }
+    chunk = std::to_string(i++);
+    expected += chunk;
+    return true;
+  }, 100) == static_cast<int64_t>(expected.size()));
+
+  REQUIRE_NOTHROW(client.seek(0));
+  std::string buffer;
+  REQUIRE(client.read(buffer, expected.size()) == static_cast<int>(expected.size()));
+  REQUIRE(buffer == expected);
+
+  storage_server->stop();
+  if (storage_serve_thread.joinable()) {
+    storage_serve_thread.join();
+  }
+
+  mgmt_server->stop();
+  if (mgmt_serve_thread.joinable()) {
+    mgmt_serve_thread.join();
+  }
+}
+
 TEST_CASE("file_client_concurrent_write_read_seek_test", "[write][read][seek]") {
 
 
@@ -114,6 +114,172 @@ TEST_CASE("hash_table_client_put_update_get_test", "[put][update][get]") {
   }
 }
 
+TEST_CASE("hash_table_client_multi_put_get_remove_test", "[multi_put][multi_get][multi_remove]") {
+  auto alloc = std::make_shared<sequential_block_allocator>();
+  auto block_names = test_utils::init_block_names(NUM_BLOCKS, STORAGE_SERVICE_PORT, STORAGE_MANAGEMENT_PORT);
+  alloc->add_blocks(block_names);
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  auto blocks = test_utils::init_hash_table_blocks(block_names, memory_mode, mem_kind, 134217728, 0, 1);
+  auto storage_server = block_server::create(blocks, STORAGE_SERVICE_PORT);
+  std::thread storage_serve_thread([&storage_server] { storage_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_SERVICE_PORT);
+
+  auto mgmt_server = storage_management_server::create(blocks, HOST, STORAGE_MANAGEMENT_PORT);
+  std::thread mgmt_serve_thread([&mgmt_server] { mgmt_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_MANAGEMENT_PORT);
+
+  auto sm = std::make_shared<storage_manager>();
+  auto tree = std::make_shared<directory_tree>(alloc, sm);
+  data_status status = tree->create("/sandbox/file.txt", "hashtable", "/tmp", NUM_BLOCKS, 1, 0, 0,
+      {"0_21845", "21845_43690", "43690_65536"}, {"regular", "regular", "regular"});
+
+  hash_table_client client(tree, "/sandbox/file.txt", status);
+  std::vector<std::string> keys, values;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    keys.push_back(std::to_string(i));
+    values.push_back(std::to_string(i));
+  }
+  REQUIRE_NOTHROW(client.multi_put(keys, values));
+  REQUIRE(client.multi_get(keys) == values);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    REQUIRE(client.get(keys[i]) == values[i]);
+  }
+  REQUIRE_THROWS_AS(client.multi_get({"0", "1000"}), std::logic_error);
+  REQUIRE(client.multi_upsert({"0", "1000"}, {"a", "b"}) == std::vector<std::string>{"0", ""});
+  REQUIRE(client.get("1000") == "b");
+  REQUIRE_NOTHROW(client.multi_remove(keys));
+  for (std::size_t i = 0; i < 1000; ++i) {
+    REQUIRE_THROWS_AS(client.get(keys[i]), std::logic_error);
+  }
+
+  storage_server->stop();
+  if (storage_serve_thread.joinable()) {
+    storage_serve_thread.join();
+  }
+
+  mgmt_server->stop();
+  if (mgmt_serve_thread.joinable()) {
+    mgmt_serve_thread.join();
+  }
+}
+
+TEST_CASE("hash_table_client_bulk_load_test", "[bulk_load][get]") {
+  auto alloc = std::make_shared<sequential_block_allocator>();
+  auto block_names = test_utils::init_block_names(NUM_BLOCKS, STORAGE_SERVICE_PORT, STORAGE_MANAGEMENT_PORT);
+  alloc->add_blocks(block_names);
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  auto blocks = test_utils::init_hash_table_blocks(block_names, memory_mode, mem_kind, 134217728, 0, 1);
+  auto storage_server = block_server::create(blocks, STORAGE_SERVICE_PORT);
+  std::thread storage_serve_thread([&storage_server] { storage_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_SERVICE_PORT);
+
+  auto mgmt_server = storage_management_server::create(blocks, HOST, STORAGE_MANAGEMENT_PORT);
+  std::thread mgmt_serve_thread([&mgmt_server] { mgmt_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_MANAGEMENT_PORT);
+
+  auto sm = std::make_shared<storage_manager>();
+  auto tree = std::make_shared<directory_tree>(alloc, sm);
+  data_status status = tree->create("/sandbox/file.txt", "hashtable", "/tmp", NUM_BLOCKS, 1, 0, 0,
+      {"0_21845", "21845_43690", "43690_65536"}, {"regular", "regular", "regular"});
+
+  hash_table_client client(tree, "/sandbox/file.txt", status);
+  // Small batches, with every key loaded twice so the second value must win
+  std::size_t i = 0;
+  REQUIRE(client.bulk_load([&i](std::string &key, std::string &value) {
+    if (i == 2000) {
+      return false;
+    }
+    key = std::to_string(i % 1000);
+    value = std::to_string(i);
+    ++i;
+    return true;
+  }, 256) == 2000);
+  for (std::size_t j = 0; j < 1000; ++j) {
+    REQUIRE(client.get(std::to_string(j)) == std::to_string(j + 1000));
+  }
+  REQUIRE_NOTHROW(client.bulk_load({"0", "1000"}, {"a", "b"}));
+  REQUIRE(client.get("0") == "a");
+  REQUIRE(client.get("1000") == "b");
+  REQUIRE_THROWS_AS(client.bulk_load({"0"}, {}), std::invalid_argument);
+
+  storage_server->stop();
+  if (storage_serve_thread.joinable()) {
+    storage_serve_thread.join();
+  }
+
+  mgmt_server->stop();
+  if (mgmt_serve_thread.joinable()) {
+    mgmt_serve_thread.join();
+  }
+}
+
+TEST_CASE("hash_table_client_async_put_get_test", "[put_async][get_async]") {
+  auto alloc = std::make_shared<sequential_block_allocator>();
+  auto block_names = test_utils::init_block_names(NUM_BLOCKS, STORAGE_SERVICE_PORT, STORAGE_MANAGEMENT_PORT);
+  alloc->add_blocks(block_names);
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  auto blocks = test_utils::init_hash_table_blocks(block_names, memory_mode, mem_kind, 134217728, 0, 1);
+  auto storage_server = block_server::create(blocks, STORAGE_SERVICE_PORT);
+  std::thread storage_serve_thread([&storage_server] { storage_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_SERVICE_PORT);
+
+  auto mgmt_server = storage_management_server::create(blocks, HOST, STORAGE_MANAGEMENT_PORT);
+  std::thread mgmt_serve_thread([&mgmt_server] { mgmt_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_MANAGEMENT_PORT);
+
+  auto sm = std::make_shared<storage_manager>();
+  auto tree = std::make_shared<directory_tree>(alloc, sm);
+  data_status status = tree->create("/sandbox/file.txt", "hashtable", "/tmp", NUM_BLOCKS, 1, 0, 0,
+      {"0_21845", "21845_43690", "43690_65536"}, {"regular", "regular", "regular"});
+
+  hash_table_client client(tree, "/sandbox/file.txt", status);
+  std::vector<std::future<void>> puts;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    puts.push_back(client.put_async(std::to_string(i), std::to_string(i)));
+  }
+  for (auto &f: puts) {
+    REQUIRE_NOTHROW(f.get());
+  }
+  std::vector<std::future<std::string>> gets;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    gets.push_back(client.get_async(std::to_string(i)));
+  }
+  for (std::size_t i = 0; i < 1000; ++i) {
+    REQUIRE(gets[i].get() == std::to_string(i));
+  }
+  std::vector<std::future<bool>> exists;
+  for (std::size_t i = 0; i < 2000; ++i) {
+    exists.push_back(client.exists_async(std::to_string(i)));
+  }
+  for (std::size_t i = 0; i < 2000; ++i) {
+    REQUIRE(exists[i].get() == (i < 1000));
+  }
+  REQUIRE_THROWS_AS(client.get_async(std::to_string(1000)).get(), std::logic_error);
+  // Upserting a fresh key has no previous value, upserting it again returns the first value
+  std::vector<std::future<std::string>> upserts;
+  for (std::size_t i = 1000; i < 1100; ++i) {
+    upserts.push_back(client.upsert_async(std::to_string(i), std::to_string(i)));
+  }
+  for (auto &f: upserts) {
+    REQUIRE(f.get().empty());
+  }
+  REQUIRE(client.upsert_async("1000", "new").get() == "1000");
+  REQUIRE(client.get_async("1000").get() == "new");
+
+  storage_server->stop();
+  if (storage_serve_thread.joinable()) {
+    storage_serve_thread.join();
+  }
+
+  mgmt_server->stop();
+  if (mgmt_serve_thread.joinable()) {
+    mgmt_serve_thread.join();
+  }
+}
+
 TEST_CASE("hash_table_client_put_remove_get_test", "[put][remove][get]") {
   auto alloc = std::make_shared<sequential_block_allocator>();
   auto block_names = test_utils::init_block_names(NUM_BLOCKS, STORAGE_SERVICE_PORT, STORAGE_MANAGEMENT_PORT);
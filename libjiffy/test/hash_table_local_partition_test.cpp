@@ -420,4 +420,92 @@ TEST_CASE("hash_table_ls_put_remove_get_binary_test", "[put][update][get]") {
     REQUIRE(resp[0] == "!key_not_found");
   }
   remove("/tmp/0_65536");
-}
\ No newline at end of file
+}
+
+TEST_CASE("hash_table_ls_compaction_test", "[upsert][remove][get][load]") {
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  for (std::string serializer: {"csv", "binary"}) {
+    block_memory_manager manager(capacity, memory_mode, mem_kind);
+    property_map conf;
+    conf.set("hashtable.serializer", serializer);
+    hash_table_partition block(&manager, "local://tmp", "0_65536", "regular", conf);
+    for (std::size_t i = 0; i < 100; ++i) {
+      response resp;
+      REQUIRE_NOTHROW(block.run_command(resp, {"put", std::to_string(i), std::to_string(i)}));
+      REQUIRE(resp[0] == "!ok");
+    }
+    REQUIRE(block.dump("local://tmp/0_65536"));
+
+    {
+      // A small compaction threshold folds the log in several times along the way
+      hash_table_local_store store("/tmp/0_65536", serializer, 1024);
+      REQUIRE(store.open());
+      for (std::size_t round = 0; round < 10; ++round) {
+        for (std::size_t i = 0; i < 200; ++i) {
+          store.upsert(std::to_string(i), std::to_string(i + round * 1000));
+        }
+      }
+      for (std::size_t i = 0; i < 200; i += 2) {
+        REQUIRE(store.remove(std::to_string(i)));
+      }
+      store.compact();
+      REQUIRE_FALSE(hash_table_local_store::has_log("/tmp/0_65536"));
+      REQUIRE(store.put("x", "y"));
+      REQUIRE(hash_table_local_store::has_log("/tmp/0_65536"));
+    }
+
+    hash_table_local_store store("/tmp/0_65536", serializer);
+    REQUIRE(store.open());
+    for (std::size_t i = 0; i < 200; ++i) {
+      std::string value;
+      REQUIRE(store.get(std::to_string(i), value) == (i % 2 == 1));
+      if (i % 2 == 1) {
+        REQUIRE(value == std::to_string(i + 9000));
+      }
+    }
+    std::string value;
+    REQUIRE(store.get("x", value));
+    REQUIRE(value == "y");
+
+    hash_table_partition loaded(&manager, "local://tmp", "0_65536", "regular", conf);
+    REQUIRE_NOTHROW(loaded.load("local://tmp/0_65536"));
+    REQUIRE(loaded.size() == 101);
+    response resp;
+    REQUIRE_NOTHROW(loaded.get(resp, {"get", "199"}));
+    REQUIRE(resp[0] == "!ok");
+    REQUIRE(resp[1] == "9199");
+
+    {
+      // Interrupt installing a compaction after it committed: only the offsets are renamed
+      std::string old_table;
+      {
+        std::ifstream in("/tmp/0_65536", std::ios::binary);
+        old_table.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+      }
+      {
+        hash_table_local_store compacted("/tmp/0_65536", serializer);
+        REQUIRE(compacted.open());
+        compacted.upsert("x", "zz");
+        compacted.compact();
+      }
+      std::rename("/tmp/0_65536", "/tmp/0_65536.compact");
+      std::ofstream("/tmp/0_65536", std::ios::binary) << old_table;
+      std::ofstream("/tmp/0_65536.compact_commit");
+      REQUIRE(hash_table_local_store::has_log("/tmp/0_65536"));
+
+      hash_table_local_store recovered("/tmp/0_65536", serializer);
+      REQUIRE(recovered.open());
+      REQUIRE(recovered.get("x", value));
+      REQUIRE(value == "zz");
+      REQUIRE(recovered.get("199", value));
+      REQUIRE(value == "9199");
+      REQUIRE_FALSE(std::ifstream("/tmp/0_65536.compact_commit"));
+    }
+
+    hash_table_local_store::clear("/tmp/0_65536");
+    remove("/tmp/0_65536");
+    remove("/tmp/0_65536_offset");
+  }
+}
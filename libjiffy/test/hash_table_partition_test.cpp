@@ -1,3 +1,5 @@
+#include <cstring>
+#include <thread>
 #include "catch.hpp"
 #include "test_utils.h"
 #include "jiffy/storage/hashtable/hash_slot.h"
@@ -32,6 +34,87 @@ TEST_CASE("hash_table_put_get_test", "[put][get]") {
 }
 
 
+TEST_CASE("hash_table_opcode_run_command_test", "[put][get][remove]") {
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  block_memory_manager manager(capacity, memory_mode, mem_kind);
+  hash_table_partition block(&manager);
+  auto put_op = command_opcode::encode(hash_table_cmd_id::ht_put);
+  auto get_op = command_opcode::encode(hash_table_cmd_id::ht_get);
+  auto remove_op = command_opcode::encode(hash_table_cmd_id::ht_remove);
+  REQUIRE(block.command_id(put_op) == hash_table_cmd_id::ht_put);
+  REQUIRE(block.command_id("put") == hash_table_cmd_id::ht_put);
+  REQUIRE(block.is_mutator(put_op));
+  REQUIRE(block.is_accessor(get_op));
+  REQUIRE(block.command_name(hash_table_cmd_id::ht_get) == "get");
+  for (std::size_t i = 0; i < 1000; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {put_op, std::to_string(i), std::to_string(i)}));
+    REQUIRE(resp[0] == "!ok");
+  }
+  for (std::size_t i = 0; i < 1000; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {i % 2 ? get_op : "get", std::to_string(i)}));
+    REQUIRE(resp[0] == "!ok");
+    REQUIRE(resp[1] == std::to_string(i));
+  }
+  for (std::size_t i = 0; i < 1000; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {remove_op, std::to_string(i)}));
+    REQUIRE(resp[0] == "!ok");
+  }
+  response resp;
+  REQUIRE_NOTHROW(block.run_command(resp, {command_opcode::encode(200), "0"}));
+  REQUIRE(resp[0] == "!no_such_command");
+}
+
+TEST_CASE("hash_table_slot_opcode_test", "[put][get][remove]") {
+  REQUIRE(hash_slot::get(std::string("123456789")) == 0x31C3);
+  std::string long_key(4096, 'k');
+  uint16_t crc = 0;
+  for (auto c: long_key) {
+    crc ^= static_cast<uint16_t>(static_cast<uint8_t>(c) << 8);
+    for (int i = 0; i < 8; ++i)
+      crc = static_cast<uint16_t>(crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1);
+  }
+  REQUIRE(hash_slot::get(long_key) == crc);
+
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  block_memory_manager manager(capacity, memory_mode, mem_kind);
+  hash_table_partition block(&manager, "local://tmp", "0_32768");
+  for (std::size_t i = 0; i < 1000; ++i) {
+    auto key = std::to_string(i);
+    auto slot = hash_slot::get(key);
+    auto put_op = command_opcode::encode(hash_table_cmd_id::ht_put, slot);
+    REQUIRE(command_opcode::has_slot(put_op));
+    REQUIRE(command_opcode::slot(put_op) == slot);
+    REQUIRE(block.command_id(put_op) == hash_table_cmd_id::ht_put);
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {put_op, key, key}));
+    REQUIRE(resp[0] == (slot < 32768 ? "!ok" : "!block_moved"));
+  }
+  for (std::size_t i = 0; i < 1000; ++i) {
+    auto key = std::to_string(i);
+    auto slot = hash_slot::get(key);
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {command_opcode::encode(hash_table_cmd_id::ht_get, slot), key}));
+    if (slot < 32768) {
+      REQUIRE(resp[0] == "!ok");
+      REQUIRE(resp[1] == key);
+    } else {
+      REQUIRE(resp[0] == "!block_moved");
+    }
+  }
+  // The slot carried by the opcode is trusted over the key
+  response resp;
+  REQUIRE_NOTHROW(block.run_command(resp, {command_opcode::encode(hash_table_cmd_id::ht_get, 40000), "0"}));
+  REQUIRE(resp[0] == "!block_moved");
+}
+
+
 TEST_CASE("hash_table_put_update_get_test", "[put][update][get]") {
   std::string memory_mode = getenv("JIFFY_TEST_MODE");
   void* mem_kind = test_utils::init_kind();
@@ -158,6 +241,221 @@ TEST_CASE("hash_table_put_remove_get_test", "[put][update][get]") {
   }
 }
 
+TEST_CASE("hash_table_open_addressing_index_test", "[put][get][update][remove]") {
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  block_memory_manager manager(capacity, memory_mode, mem_kind);
+  jiffy::utils::property_map conf;
+  conf.set("hashtable.index_type", "open_addressing");
+  hash_table_partition block(&manager, "local://tmp", "0_65536", "regular", conf);
+  for (std::size_t i = 0; i < 10000; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.put(resp, {"put", std::to_string(i), std::to_string(i)}));
+    REQUIRE(resp[0] == "!ok");
+  }
+  REQUIRE(block.size() == 10000);
+  // The slots and entry chunks are allocated from the block
+  REQUIRE(block.storage_size() >= 10000 * (sizeof(std::pair<const binary, binary>) + 8));
+  for (std::size_t i = 0; i < 10000; i += 2) {
+    response resp;
+    REQUIRE_NOTHROW(block.update(resp, {"update", std::to_string(i), std::to_string(i + 10000)}));
+    REQUIRE(resp[0] == "!ok");
+  }
+  for (std::size_t i = 1; i < 10000; i += 2) {
+    response resp;
+    REQUIRE_NOTHROW(block.remove(resp, {"remove", std::to_string(i)}));
+    REQUIRE(resp[0] == "!ok");
+  }
+  REQUIRE(block.size() == 5000);
+  for (std::size_t i = 0; i < 10000; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.get(resp, {"get", std::to_string(i)}));
+    if (i % 2) {
+      REQUIRE(resp[0] == "!key_not_found");
+    } else {
+      REQUIRE(resp[0] == "!ok");
+      REQUIRE(resp[1] == std::to_string(i + 10000));
+    }
+  }
+  conf.set("hashtable.index_type", "no_such_index");
+  REQUIRE_THROWS_AS(hash_table_partition(&manager, "local://tmp", "0_65536", "regular", conf),
+                    std::invalid_argument);
+}
+
+TEST_CASE("hash_table_get_range_data_cursor_test", "[get_range_data][scale_put][scale_remove]") {
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  block_memory_manager manager(capacity, memory_mode, mem_kind);
+  for (auto index_type: {"unordered_map", "open_addressing"}) {
+    jiffy::utils::property_map conf;
+    conf.set("hashtable.index_type", index_type);
+    hash_table_partition src(&manager, "local://tmp", "0_65536", "regular", conf);
+    hash_table_partition dst(&manager, "local://tmp", "32768_65536", "regular", conf);
+    std::size_t in_range = 0;
+    for (std::size_t i = 0; i < 10000; ++i) {
+      response resp;
+      REQUIRE_NOTHROW(src.put(resp, {"put", std::to_string(i), std::to_string(i)}));
+      in_range += hash_slot::get(std::to_string(i)) >= 32768;
+    }
+    // Move the upper half of the slots the way the auto-scaler does, growing the source meanwhile
+    std::size_t cursor = 0, next_key = 10000, transferred = 0;
+    while (true) {
+      auto scan_begin = cursor;
+      response resp;
+      REQUIRE_NOTHROW(src.run_command(resp, {"get_range_data", "32768", "65536", "100", std::to_string(cursor)}));
+      REQUIRE(resp[0] == "!ok");
+      cursor = std::stoull(resp[1]);
+      if (resp.size() == 2) {
+        if (scan_begin == 0 && cursor == 0)
+          break;
+        continue;
+      }
+      arg_list put_args{"scale_put"};
+      arg_list remove_args{"scale_remove"};
+      for (std::size_t i = 2; i < resp.size(); i += 2) {
+        put_args.push_back(resp[i]);
+        put_args.push_back(resp[i + 1]);
+        remove_args.push_back(resp[i]);
+      }
+      transferred += remove_args.size() - 1;
+      response put_resp, remove_resp;
+      REQUIRE_NOTHROW(dst.run_command(put_resp, put_args));
+      REQUIRE_NOTHROW(src.run_command(remove_resp, remove_args));
+      for (std::size_t i = 0; i < 50;) {
+        auto key = std::to_string(next_key++);
+        if (hash_slot::get(key) < 32768) {
+          response put_resp2;
+          REQUIRE_NOTHROW(src.put(put_resp2, {"put", key, key}));
+          ++i;
+        }
+      }
+    }
+    REQUIRE(transferred == in_range);
+    REQUIRE(dst.size() == in_range);
+    for (std::size_t i = 0; i < 10000; ++i) {
+      auto key = std::to_string(i);
+      response resp;
+      auto &owner = hash_slot::get(key) >= 32768 ? dst : src;
+      REQUIRE_NOTHROW(owner.get(resp, {"get", key}));
+      REQUIRE(resp[0] == "!ok");
+      REQUIRE(resp[1] == key);
+    }
+  }
+}
+
+TEST_CASE("hash_table_multi_put_get_remove_test", "[multi_put][multi_get][multi_remove]") {
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  block_memory_manager manager(capacity, memory_mode, mem_kind);
+  hash_table_partition block(&manager);
+  arg_list put_args{"multi_put"};
+  arg_list get_args{"multi_get"};
+  for (std::size_t i = 0; i < 1000; ++i) {
+    put_args.push_back(std::to_string(i));
+    put_args.push_back(std::to_string(i));
+    get_args.push_back(std::to_string(i));
+  }
+  get_args.emplace_back("1000");
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, put_args));
+    REQUIRE(resp.size() == 2001);
+    REQUIRE(resp[0] == "!ok");
+    for (std::size_t i = 0; i < 1000; ++i) {
+      REQUIRE(resp[2 * i + 1] == "1");
+      REQUIRE(resp[2 * i + 2] == "!ok");
+    }
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, put_args));
+    REQUIRE(resp[0] == "!ok");
+    REQUIRE(resp[2] == "!duplicate_key");
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, get_args));
+    REQUIRE(resp[0] == "!ok");
+    for (std::size_t i = 0; i < 1000; ++i) {
+      REQUIRE(resp[3 * i + 1] == "2");
+      REQUIRE(resp[3 * i + 2] == "!ok");
+      REQUIRE(resp[3 * i + 3] == std::to_string(i));
+    }
+    REQUIRE(resp[3001] == "1");
+    REQUIRE(resp[3002] == "!key_not_found");
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {"multi_upsert", "0", "a", "1000", "b"}));
+    REQUIRE(resp == response{"!ok", "2", "!ok", "0", "1", "!ok"});
+  }
+  {
+    arg_list remove_args(get_args);
+    remove_args[0] = "multi_remove";
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, remove_args));
+    REQUIRE(resp[0] == "!ok");
+    REQUIRE(block.empty());
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {"multi_put", "0"}));
+    REQUIRE(resp[0] == "!args_error");
+  }
+}
+
+TEST_CASE("hash_table_bulk_load_test", "[bulk_load][get]") {
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  block_memory_manager manager(capacity, memory_mode, mem_kind);
+  hash_table_partition block(&manager);
+  arg_list load_args{"bulk_load"};
+  for (std::size_t i = 0; i < 1000; ++i) {
+    load_args.push_back(std::to_string(i));
+    load_args.push_back(std::to_string(i));
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, load_args));
+    REQUIRE(resp == response{"!ok"});
+    REQUIRE(block.size() == 1000);
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {"bulk_load", "0", "a", "1000", "b"}));
+    REQUIRE(resp == response{"!ok"});
+    REQUIRE(block.size() == 1001);
+  }
+  for (std::size_t i = 1; i < 1000; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {"get", std::to_string(i)}));
+    REQUIRE(resp[0] == "!ok");
+    REQUIRE(resp[1] == std::to_string(i));
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {"get", "0"}));
+    REQUIRE(resp[1] == "a");
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.run_command(resp, {"bulk_load", "0"}));
+    REQUIRE(resp[0] == "!args_error");
+  }
+  {
+    block_memory_manager small_manager(1024, memory_mode, mem_kind);
+    hash_table_partition small_block(&small_manager);
+    response resp;
+    REQUIRE_NOTHROW(small_block.run_command(resp, {"bulk_load", "key", std::string(2048, 'x')}));
+    REQUIRE(resp[0] == "!full");
+    REQUIRE(small_block.empty());
+  }
+}
+
 TEST_CASE("hash_table_storage_size_test", "[put][size][storage_size][reset]") {
   std::string memory_mode = getenv("JIFFY_TEST_MODE");
   void* mem_kind = test_utils::init_kind();
@@ -174,6 +472,76 @@ TEST_CASE("hash_table_storage_size_test", "[put][size][storage_size][reset]") {
   REQUIRE(block.storage_size() <= block.storage_capacity());
 }
 
+TEST_CASE("hash_table_slab_allocator_test", "[put][remove][storage_size]") {
+  for (std::size_t size = 1; size <= slab_allocator::MAX_SLAB_OBJECT_SIZE; ++size) {
+    auto cls = slab_allocator::size_class(size);
+    REQUIRE(cls < slab_allocator::NUM_SIZE_CLASSES);
+    REQUIRE(slab_allocator::class_size(cls) >= size);
+    REQUIRE((cls == 0 || slab_allocator::class_size(cls - 1) < size));
+  }
+
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  REQUIRE_THROWS_AS(block_memory_manager(capacity, memory_mode, mem_kind, "invalid"), std::invalid_argument);
+  block_memory_manager manager(capacity, memory_mode, mem_kind, "slab");
+
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < 4; ++t) {
+    workers.emplace_back([&manager, t] {
+      std::vector<std::pair<void *, std::size_t>> ptrs;
+      for (std::size_t i = 0; i < 10000; ++i) {
+        auto size = (i * 7 + t) % 6000 + 1;
+        auto ptr = manager.mb_malloc(size);
+        std::memset(ptr, static_cast<int>(t), size);
+        ptrs.emplace_back(ptr, size);
+      }
+      for (auto &p: ptrs) {
+        manager.mb_free(p.first, p.second);
+      }
+    });
+  }
+  for (auto &w: workers) {
+    w.join();
+  }
+  // The workers' caches went back to the shared free lists on exit, emptying every slab
+  REQUIRE(manager.mb_used() == 0);
+  auto ptr = manager.mb_malloc(100);
+  REQUIRE(manager.mb_used() == slab_allocator::SLAB_SIZE);
+  // The freed object stays in this thread's cache, so its slab stays too
+  manager.mb_free(ptr);
+  REQUIRE(manager.mb_used() == slab_allocator::SLAB_SIZE);
+  // Large allocations count the same whether or not the free knows their size
+  ptr = manager.mb_malloc(5001);
+  REQUIRE(manager.mb_used() == slab_allocator::SLAB_SIZE + 5001);
+  manager.mb_free(ptr);
+  REQUIRE(manager.mb_used() == slab_allocator::SLAB_SIZE);
+  ptr = manager.mb_malloc(5001);
+  manager.mb_free(ptr, 5001);
+  REQUIRE(manager.mb_used() == slab_allocator::SLAB_SIZE);
+
+  hash_table_partition block(&manager);
+  auto empty_size = block.storage_size();
+  for (std::size_t i = 0; i < 1000; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.put(resp, {"put", std::to_string(i), std::to_string(i)}));
+    REQUIRE(resp[0] == "!ok");
+  }
+  for (std::size_t i = 0; i < 1000; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.get(resp, {"get", std::to_string(i)}));
+    REQUIRE(resp[0] == "!ok");
+    REQUIRE(resp[1] == std::to_string(i));
+  }
+  REQUIRE(block.storage_size() > empty_size);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.remove(resp, {"remove", std::to_string(i)}));
+    REQUIRE(resp[0] == "!ok");
+  }
+  REQUIRE(block.size() == 0);
+}
+
 TEST_CASE("hash_table_flush_load_test", "[put][sync][reset][load][get]") {
   std::string memory_mode = getenv("JIFFY_TEST_MODE");
   void* mem_kind = test_utils::init_kind();
@@ -197,3 +565,131 @@ TEST_CASE("hash_table_flush_load_test", "[put][sync][reset][load][get]") {
     REQUIRE(resp[1] == std::to_string(i));
   }
 }
+
+TEST_CASE("hash_table_incremental_sync_load_test", "[put][upsert][remove][sync][load][get]") {
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  block_memory_manager manager(capacity, memory_mode, mem_kind);
+  jiffy::utils::property_map conf;
+  conf.set("hashtable.incremental_sync", "true");
+  conf.set("hashtable.auto_scale", "false");
+  hash_table_partition block(&manager, "local://tmp", "0_65536", "regular", conf);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    std::vector<std::string> res;
+    block.run_command(res, {"put", std::to_string(i), std::to_string(i)});
+    REQUIRE(res.front() == "!ok");
+  }
+  REQUIRE(block.sync("local://tmp/test_incremental"));
+  for (std::size_t i = 0; i < 10; ++i) {
+    std::vector<std::string> res;
+    block.run_command(res, {"upsert", std::to_string(i), "updated" + std::to_string(i)});
+    block.run_command(res, {"remove", std::to_string(i + 10)});
+  }
+  REQUIRE(block.sync("local://tmp/test_incremental"));
+  std::vector<std::string> res;
+  block.run_command(res, {"multi_put", "1000", "1000", "1001", "1001"});
+  REQUIRE(block.sync("local://tmp/test_incremental"));
+  REQUIRE_FALSE(block.sync("local://tmp/test_incremental"));
+
+  block_memory_manager manager2(capacity, memory_mode, mem_kind);
+  hash_table_partition loaded(&manager2, "local://tmp", "0_65536", "regular", conf);
+  REQUIRE_NOTHROW(loaded.load("local://tmp/test_incremental"));
+  REQUIRE(loaded.size() == 992);
+  for (std::size_t i = 0; i < 1002; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(loaded.get(resp, {"get", std::to_string(i)}));
+    if (i >= 10 && i < 20) {
+      REQUIRE(resp[0] == "!key_not_found");
+    } else {
+      REQUIRE(resp[0] == "!ok");
+      REQUIRE(resp[1] == (i < 10 ? "updated" : "") + std::to_string(i));
+    }
+  }
+}
+
+TEST_CASE("hash_table_background_sync_load_test", "[put][upsert][sync][dump][load][get]") {
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  block_memory_manager manager(capacity, memory_mode, mem_kind);
+  jiffy::utils::property_map conf;
+  conf.set("hashtable.background_sync", "true");
+  conf.set("hashtable.sync_bytes_per_sec", "10000");
+  conf.set("hashtable.auto_scale", "false");
+  hash_table_partition block(&manager, "local://tmp", "0_65536", "regular", conf);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    std::vector<std::string> res;
+    block.run_command(res, {"put", std::to_string(i), std::to_string(i)});
+    REQUIRE(res.front() == "!ok");
+  }
+  auto storage_size = block.storage_size();
+  REQUIRE(block.sync("local://tmp/test_background"));
+  REQUIRE(!block.is_dirty());
+  // The copy being written is held in the block's memory
+  REQUIRE(block.storage_size() > storage_size);
+  // Written while the sync is still in progress, so not part of the synced table
+  for (std::size_t i = 0; i < 1000; ++i) {
+    std::vector<std::string> res;
+    block.run_command(res, {"upsert", std::to_string(i), "updated" + std::to_string(i)});
+  }
+  REQUIRE(block.is_dirty());
+  // Waits for the sync in progress
+  REQUIRE(block.dump("local://tmp/test_background_dump"));
+
+  block_memory_manager manager2(capacity, memory_mode, mem_kind);
+  hash_table_partition synced(&manager2, "local://tmp", "0_65536", "regular", conf);
+  REQUIRE_NOTHROW(synced.load("local://tmp/test_background"));
+  block_memory_manager manager3(capacity, memory_mode, mem_kind);
+  hash_table_partition dumped(&manager3, "local://tmp", "0_65536", "regular", conf);
+  REQUIRE_NOTHROW(dumped.load("local://tmp/test_background_dump"));
+  for (std::size_t i = 0; i < 1000; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(synced.get(resp, {"get", std::to_string(i)}));
+    REQUIRE(resp[0] == "!ok");
+    REQUIRE(resp[1] == std::to_string(i));
+    resp.clear();
+    REQUIRE_NOTHROW(dumped.get(resp, {"get", std::to_string(i)}));
+    REQUIRE(resp[0] == "!ok");
+    REQUIRE(resp[1] == "updated" + std::to_string(i));
+  }
+}
+
+TEST_CASE("hash_table_background_sync_in_place_test", "[put][upsert][sync][load][get]") {
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  block_memory_manager manager(capacity, memory_mode, mem_kind);
+  jiffy::utils::property_map conf;
+  conf.set("hashtable.background_sync", "true");
+  conf.set("hashtable.sync_copy_bytes", "1");
+  conf.set("hashtable.auto_scale", "false");
+  hash_table_partition block(&manager, "local://tmp", "0_65536", "regular", conf);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    std::vector<std::string> res;
+    block.run_command(res, {"put", std::to_string(i), std::to_string(i)});
+    REQUIRE(res.front() == "!ok");
+  }
+  auto storage_size = block.storage_size();
+  REQUIRE(block.sync("local://tmp/test_background_in_place"));
+  // Too large to copy, so the table is written in place
+  REQUIRE(block.storage_size() == storage_size);
+  // Waits for the table to be written
+  for (std::size_t i = 0; i < 1000; ++i) {
+    std::vector<std::string> res;
+    block.run_command(res, {"upsert", std::to_string(i), "updated" + std::to_string(i)});
+    REQUIRE(res.front() == "!ok");
+  }
+  REQUIRE(block.dump("local://tmp/test_background_in_place_dump"));
+
+  block_memory_manager manager2(capacity, memory_mode, mem_kind);
+  hash_table_partition synced(&manager2, "local://tmp", "0_65536", "regular", conf);
+  REQUIRE_NOTHROW(synced.load("local://tmp/test_background_in_place"));
+  REQUIRE(synced.size() == 1000);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(synced.get(resp, {"get", std::to_string(i)}));
+    REQUIRE(resp[0] == "!ok");
+    REQUIRE(resp[1] == std::to_string(i));
+  }
+}
@@ -188,6 +188,90 @@ TEST_CASE("jiffy_client_create_test", "[put][get][update][remove]") {
   }
 }
 
+TEST_CASE("jiffy_client_async_test", "[put_async][get_async][remove_async]") {
+  auto alloc = std::make_shared<sequential_block_allocator>();
+  auto block_names = test_utils::init_block_names(NUM_BLOCKS,
+                                                  STORAGE_SERVICE_PORT,
+                                                  STORAGE_MANAGEMENT_PORT);
+  alloc->add_blocks(block_names);
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  auto blocks = test_utils::init_hash_table_blocks(block_names, memory_mode, mem_kind);
+  auto sm = std::make_shared<storage_manager>();
+  auto tree = std::make_shared<directory_tree>(alloc, sm);
+
+  auto storage_server = block_server::create(blocks, STORAGE_SERVICE_PORT);
+  std::thread storage_serve_thread([&storage_server] { storage_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_SERVICE_PORT);
+
+  auto mgmt_server = storage_management_server::create(blocks, HOST, STORAGE_MANAGEMENT_PORT);
+  std::thread mgmt_serve_thread([&mgmt_server] { mgmt_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, STORAGE_MANAGEMENT_PORT);
+
+  auto dir_server = directory_server::create(tree, HOST, DIRECTORY_SERVICE_PORT);
+  std::thread dir_serve_thread([&dir_server] { dir_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, DIRECTORY_SERVICE_PORT);
+
+  auto lease_server = lease_server::create(tree, LEASE_PERIOD_MS, HOST, DIRECTORY_LEASE_PORT);
+  std::thread lease_serve_thread([&lease_server] { lease_server->serve(); });
+  test_utils::wait_till_server_ready(HOST, DIRECTORY_LEASE_PORT);
+
+  lease_expiry_worker lmgr(tree, LEASE_PERIOD_MS, LEASE_PERIOD_MS);
+  lmgr.start();
+
+  sync_worker syncer(tree, 1000);
+  syncer.start();
+
+  {
+    jiffy_client client(HOST, DIRECTORY_SERVICE_PORT, DIRECTORY_LEASE_PORT);
+    auto table = client.create_hash_table("/a/file.txt", "/tmp");
+    std::vector<std::future<void>> puts;
+    for (size_t i = 0; i < 1000; i++) {
+      puts.push_back(table->put_async(std::to_string(i), std::to_string(i)));
+    }
+    for (auto &f: puts) {
+      REQUIRE_NOTHROW(f.get());
+    }
+    std::vector<std::future<std::string>> gets;
+    for (size_t i = 0; i < 1000; i++) {
+      gets.push_back(table->get_async(std::to_string(i)));
+    }
+    for (size_t i = 0; i < 1000; i++) {
+      REQUIRE(gets[i].get() == std::to_string(i));
+    }
+    std::vector<std::future<std::string>> removes;
+    for (size_t i = 0; i < 1000; i++) {
+      removes.push_back(table->remove_async(std::to_string(i)));
+    }
+    for (auto &f: removes) {
+      REQUIRE_NOTHROW(f.get());
+    }
+    for (size_t i = 0; i < 1000; i++) {
+      REQUIRE_FALSE(table->exists(std::to_string(i)));
+    }
+  }
+
+  storage_server->stop();
+  if (storage_serve_thread.joinable()) {
+    storage_serve_thread.join();
+  }
+
+  mgmt_server->stop();
+  if (mgmt_serve_thread.joinable()) {
+    mgmt_serve_thread.join();
+  }
+
+  dir_server->stop();
+  if (dir_serve_thread.joinable()) {
+    dir_serve_thread.join();
+  }
+
+  lease_server->stop();
+  if (lease_serve_thread.joinable()) {
+    lease_serve_thread.join();
+  }
+}
+
 TEST_CASE("jiffy_client_open_test", "[put][get][update][remove]") {
   auto alloc = std::make_shared<sequential_block_allocator>();
   auto block_names = test_utils::init_block_names(NUM_BLOCKS,
@@ -33,6 +33,33 @@ TEST_CASE("local_write_test", "[write]") {
   std::remove("/tmp/a.txt");
 }
 
+TEST_CASE("local_write_replace_test", "[write][read]") {
+  std::string memory_mode = getenv("JIFFY_TEST_MODE");
+  void* mem_kind = test_utils::init_kind();
+  size_t capacity = 134217728;
+  block_memory_manager manager(capacity, memory_mode, mem_kind);
+  block_memory_allocator<uint8_t> binary_allocator(&manager);
+  auto ser = std::make_shared<binary_serde>(binary_allocator);
+  local_store store(ser);
+  hash_table_type table;
+  table.emplace(make_binary("key1", binary_allocator), make_binary("value1", binary_allocator));
+  table.emplace(make_binary("key2", binary_allocator), make_binary("value2", binary_allocator));
+  REQUIRE_NOTHROW(store.write(table, "/tmp/b.txt"));
+  table.erase(make_binary("key1", binary_allocator));
+  REQUIRE_NOTHROW(store.write(table, "/tmp/b.txt"));
+  // Written aside and renamed over the previous write
+  REQUIRE_FALSE(std::ifstream("/tmp/b.txt.tmp"));
+  REQUIRE_FALSE(std::ifstream("/tmp/b.txt.tmp_offset"));
+  hash_table_type read;
+  REQUIRE_NOTHROW(store.read("/tmp/b.txt", read));
+  REQUIRE(read.size() == 1);
+  auto it = read.find(make_binary("key2", binary_allocator));
+  REQUIRE(it != read.end());
+  REQUIRE(it->second == make_binary("value2", binary_allocator));
+  std::remove("/tmp/b.txt");
+  std::remove("/tmp/b.txt_offset");
+}
+
 TEST_CASE("local_read_test", "[read]") {
   std::ofstream out("/tmp/a.txt", std::ofstream::out);
   out << "key,value\n";
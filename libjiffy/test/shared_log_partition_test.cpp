@@ -54,6 +54,127 @@ TEST_CASE("shared_log_write_trim_scan_test", "[write][trim][scan]") {
   }
 }
 
+TEST_CASE("shared_log_write_scan_streams_test", "[write][scan]") {
+  block_memory_manager manager;
+  shared_log_partition block(&manager);
+  for (std::size_t i = 0; i < 100; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.write(resp, {"write", std::to_string(i), std::to_string(i) + "_data",
+                                       "a_" + std::to_string(i % 4), "b_" + std::to_string(i % 5)}));
+    REQUIRE(resp[0] == "!ok");
+  }
+  REQUIRE(block.streams_.size() == 9);
+
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.scan(resp, {"scan", "10", "29", "a_3"}));
+    REQUIRE(resp == response{"!ok", "11_data", "15_data", "19_data", "23_data", "27_data"});
+  }
+
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.scan(resp, {"scan", "0", "9", "b_1", "a_0", "b_1"}));
+    REQUIRE(resp == response{"!ok", "0_data", "1_data", "4_data", "6_data", "8_data"});
+  }
+
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.scan(resp, {"scan", "0", "99", "no_such_stream"}));
+    REQUIRE(resp == response{"!ok"});
+  }
+
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.trim(resp, {"trim", "0", "3"}));
+    REQUIRE(resp[0] == "!ok");
+    REQUIRE(resp[1] == std::to_string(4 * (6 + 6)));
+  }
+
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.scan(resp, {"scan", "0", "9", "a_0"}));
+    REQUIRE(resp == response{"!ok", "4_data", "8_data"});
+  }
+}
+
+TEST_CASE("shared_log_index_capacity_test", "[write][get_storage_capacity]") {
+  block_memory_manager manager(1024);
+  shared_log_partition block(&manager);
+  auto entry_size = shared_log_block::entry_size(6, 1);
+  std::size_t num_entries = 0;
+  for (; (num_entries + 1) * entry_size <= 1024; ++num_entries) {
+    response resp;
+    REQUIRE_NOTHROW(block.write(resp, {"write", std::to_string(num_entries), std::to_string(num_entries % 10) + "_data", "stream"}));
+    REQUIRE(resp[0] == "!ok");
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.write(resp, {"write", std::to_string(num_entries), "0_data", "stream"}));
+    REQUIRE(resp[0] == "!block_full");
+  }
+  response resp;
+  block.get_storage_capacity(resp, {"get_storage_capacity"});
+  REQUIRE(resp[0] == "!ok");
+  REQUIRE(resp[1] == "1024");
+  REQUIRE(std::stoul(resp[2]) >= num_entries * sizeof(shared_log_entry));
+  // The stream index lives outside block memory, but still counts
+  REQUIRE(block.storage_size() >= manager.mb_used() + num_entries * sizeof(uint32_t));
+}
+
+TEST_CASE("shared_log_trim_reclaim_test", "[write][trim][scan]") {
+  block_memory_manager manager(1024);
+  shared_log_partition block(&manager);
+  auto entry_size = shared_log_block::entry_size(6, 1);
+  std::size_t num_entries = 1024 / entry_size;
+  for (std::size_t i = 0; i < num_entries; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.write(resp, {"write", std::to_string(i), std::to_string(i % 10) + "_data", "stream"}));
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.trim(resp, {"trim", "0", "9"}));
+    REQUIRE(resp == response{"!ok", std::to_string(10 * (6 + 6)), std::to_string(10 * entry_size)});
+  }
+  for (std::size_t i = num_entries; i < num_entries + 10; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.write(resp, {"write", std::to_string(i), std::to_string(i % 10) + "_data", "stream"}));
+    REQUIRE(resp[0] == "!ok");
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.scan(resp, {"scan", "0", "9", "stream"}));
+    REQUIRE(resp == response{"!ok"});
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.scan(resp, {"scan", "5", std::to_string(num_entries + 9), "stream"}));
+    REQUIRE(resp.size() == num_entries + 1);
+    for (std::size_t i = 1; i < resp.size(); ++i) {
+      REQUIRE(resp[i] == std::to_string((i + 9) % 10) + "_data");
+    }
+  }
+}
+
+TEST_CASE("shared_log_scan_before_partition_test", "[write][scan]") {
+  block_memory_manager manager;
+  shared_log_partition block(&manager);
+  for (std::size_t i = 100; i < 110; ++i) {
+    response resp;
+    REQUIRE_NOTHROW(block.write(resp, {"write", std::to_string(i), std::to_string(i) + "_data", "stream"}));
+    REQUIRE(resp[0] == "!ok");
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.scan(resp, {"scan", "0", "99", "stream"}));
+    REQUIRE(resp == response{"!ok"});
+  }
+  {
+    response resp;
+    REQUIRE_NOTHROW(block.scan(resp, {"scan", "90", "101", "stream"}));
+    REQUIRE(resp == response{"!ok", "100_data", "101_data"});
+  }
+}
+
 TEST_CASE("shared_log_flush_load_test", "[write][sync][reset][load][scan]") {
   block_memory_manager manager;
   shared_log_partition block(&manager);
@@ -91,3 +91,45 @@ TEST_CASE("manager_sync_load_test", "[put][sync][reset][load][get]") {
     serve_thread.join();
   }
 }
+
+TEST_CASE("manager_create_partitions_test", "[create_partitions][path]") {
+  static auto blocks = test_utils::init_hash_table_blocks(3, SERVICE_PORT, MANAGEMENT_PORT);
+  auto server = storage_management_server::create(blocks, HOST, MANAGEMENT_PORT);
+  std::thread serve_thread([&server] { server->serve(); });
+  test_utils::wait_till_server_ready(HOST, MANAGEMENT_PORT);
+
+  storage_manager manager;
+  std::vector<std::string> chain;
+  for (int32_t i = 0; i < 3; ++i) {
+    chain.push_back(block_id_parser::make(HOST, SERVICE_PORT, MANAGEMENT_PORT, i));
+  }
+  std::vector<partition_setup> setups;
+  for (std::size_t i = 0; i < chain.size(); ++i) {
+    partition_setup setup;
+    setup.block_id = chain[i];
+    setup.type = "hashtable";
+    setup.backing_path = "local://tmp";
+    setup.name = "0_65536";
+    setup.metadata = "regular";
+    setup.path = "/path/to/data";
+    setup.chain = chain;
+    setup.role = i == 0 ? chain_role::head : i == chain.size() - 1 ? chain_role::tail : chain_role::mid;
+    setup.next_block_id = i == chain.size() - 1 ? "nil" : chain[i + 1];
+    setups.push_back(setup);
+  }
+  REQUIRE_NOTHROW(manager.create_partitions(setups));
+  for (std::size_t i = 0; i < chain.size(); ++i) {
+    REQUIRE(blocks[i]->impl()->path() == "/path/to/data");
+    REQUIRE(blocks[i]->impl()->chain() == chain);
+    REQUIRE(blocks[i]->impl()->role() == setups[i].role);
+  }
+
+  setups.resize(1);
+  setups[0].type = "no_such_type";
+  REQUIRE_THROWS_AS(manager.create_partitions(setups), storage_management_exception);
+
+  server->stop();
+  if (serve_thread.joinable()) {
+    serve_thread.join();
+  }
+}
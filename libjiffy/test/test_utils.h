@@ -66,7 +66,7 @@ class dummy_storage_manager : public jiffy::storage::storage_management_ops {
 
   std::size_t storage_capacity(const std::string &block_id) override {
     COMMANDS.push_back("storage_capacity:" + block_id);
-    return 0;
+    return CAPACITY;
   }
 
   std::size_t storage_size(const std::string &block_id) override {
@@ -88,6 +88,7 @@ class dummy_storage_manager : public jiffy::storage::storage_management_ops {
   }
 
   std::vector<std::string> COMMANDS{};
+  std::size_t CAPACITY{0};
 };
 using namespace jiffy::utils;
 class sequential_block_allocator : public jiffy::directory::block_allocator {
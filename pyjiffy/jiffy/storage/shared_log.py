@@ -63,16 +63,18 @@ class SharedLogClient(DataStructureClient):
         for ls in logical_streams:
             data += ls
         data += data_
+        # Space the entry takes up in a partition: a 16 byte index record, 4 byte stream ids and the data
+        entry_size = 16 + 4 * len(logical_streams) + len(data_)
 
         if self.cur_partition * self.block_size + self.cur_offset > file_size:
             num_chain_needed = int(self.cur_partition - self.last_partition)
             file_size = (self.cur_partition + 1) * self.block_size
             remain_size = file_size - self.cur_partition * self.block_size - self.cur_offset
-            num_chain_needed += int((len(data) - remain_size) / self.block_size + ((len(data) - remain_size) % self.block_size != 0))
+            num_chain_needed += int((entry_size - remain_size) / self.block_size + ((entry_size - remain_size) % self.block_size != 0))
         else:
             remain_size = file_size - self.cur_partition * self.block_size - self.cur_offset
-            if remain_size < len(data):
-                num_chain_needed = int((len(data) - remain_size) / self.block_size + ((len(data) - remain_size) % self.block_size != 0))
+            if remain_size < entry_size:
+                num_chain_needed = int((entry_size - remain_size) / self.block_size + ((entry_size - remain_size) % self.block_size != 0))
 
         if num_chain_needed and not self.auto_scale:
             return -1
@@ -95,12 +97,12 @@ class SharedLogClient(DataStructureClient):
             self.cur_offset = 0
             self.cur_partition += 1
         # Parallel write
-        remaining_data = len(data)
+        remaining_data = entry_size
         start_partition = self._block_id()
         count = 0
         while remaining_data > 0:
             count += 1
-            if len(data) > self.block_size - self.cur_offset: 
+            if entry_size > self.block_size - self.cur_offset: 
                 self.cur_offset = 0
                 self.cur_partition += 1
                 if self.last_partition < self.cur_partition:
@@ -110,8 +112,8 @@ class SharedLogClient(DataStructureClient):
             arg_list += logical_streams
             
             self.blocks[self._block_id()].send_command(arg_list)
-            remaining_data -= len(data)
-            self.cur_offset += len(data)
+            remaining_data -= entry_size
+            self.cur_offset += entry_size
             if self.last_offset < self.cur_offset and self.cur_partition == self.last_partition:
                 self.last_offset = self.cur_offset
             
@@ -127,7 +129,13 @@ class SharedLogClient(DataStructureClient):
             arg_list = [SharedLogOps.trim, b(str(start_pos)), b(str(end_pos))]
             self.blocks[start_partition + count].send_command(arg_list)
             count += 1
-        ret = []
         for k in range(0, count):
             resp = self.blocks[start_partition + k].recv_response()
+            # Space freed in a partition is reused by later writes to that partition
+            if len(resp) > 2 and resp[0] == b('!ok'):
+                freed = int(resp[2])
+                if start_partition + k == self.cur_partition:
+                    self.cur_offset -= min(self.cur_offset, freed)
+                if start_partition + k == self.last_partition:
+                    self.last_offset -= min(self.last_offset, freed)
         return True
\ No newline at end of file
@@ -67,6 +67,7 @@ int main(int argc, char **argv) {
   std::string address = "127.0.0.1";
   int32_t mgmt_port = 9093;
   int32_t auto_scaling_port = 9094;
+  std::size_t auto_scaling_workers = 8;
   int32_t service_port = 9095;
   std::string memory_mode = "DRAM";
   std::string pmem_path = "";
@@ -74,6 +75,7 @@ int main(int argc, char **argv) {
   std::size_t num_blocks = 64;
   std::size_t num_block_groups = std::thread::hardware_concurrency() / 2;
   std::size_t block_capacity = 134217728;
+  std::string block_allocator = "system";
   double blk_thresh_lo = 0.25;
   double blk_thresh_hi = 0.75;
   std::string storage_trace = "";
@@ -96,6 +98,7 @@ int main(int argc, char **argv) {
         ("storage.host", po::value<std::string>(&address)->default_value("127.0.0.1"))
         ("storage.management_port", po::value<int>(&mgmt_port)->default_value(9093))
         ("storage.auto_scaling_port", po::value<int>(&auto_scaling_port)->default_value(9094))
+        ("storage.auto_scaling_workers", po::value<size_t>(&auto_scaling_workers)->default_value(8))
         ("storage.service_port", po::value<int>(&service_port)->default_value(9095))
         ("storage.memory_mode", po::value<std::string>(&memory_mode)->default_value("DRAM"))
         ("storage.pmem_path", po::value<std::string>(&pmem_path)->default_value(""))
@@ -106,6 +109,7 @@ int main(int argc, char **argv) {
         ("storage.block.num_block_groups",
          po::value<size_t>(&num_block_groups)->default_value(std::thread::hardware_concurrency() / 2))
         ("storage.block.capacity", po::value<size_t>(&block_capacity)->default_value(134217728))
+        ("storage.block.allocator", po::value<std::string>(&block_allocator)->default_value("system"))
         ("storage.block.capacity_threshold_lo", po::value<double>(&blk_thresh_lo)->default_value(0.25))
         ("storage.block.capacity_threshold_hi", po::value<double>(&blk_thresh_hi)->default_value(0.75));
 
@@ -161,11 +165,13 @@ int main(int argc, char **argv) {
     LOG(log_level::info) << "storage.service_port: " << service_port;
     LOG(log_level::info) << "storage.management_port: " << mgmt_port;
     LOG(log_level::info) << "storage.auto_scaling_port: " << auto_scaling_port;
+    LOG(log_level::info) << "storage.auto_scaling_workers: " << auto_scaling_workers;
     LOG(log_level::info) << "storage.memory_mode: " << memory_mode;
     LOG(log_level::info) << "storage.pmem_path: " << pmem_path;
     LOG(log_level::info) << "storage.block.num_blocks: " << num_blocks;
     LOG(log_level::info) << "storage.block.num_block_groups: " << num_block_groups;
     LOG(log_level::info) << "storage.block.capacity: " << block_capacity;
+    LOG(log_level::info) << "storage.block.allocator: " << block_allocator;
     LOG(log_level::info) << "storage.block.capacity_threshold_lo: " << blk_thresh_lo;
     LOG(log_level::info) << "storage.block.capacity_threshold_hi: " << blk_thresh_hi;
     LOG(log_level::info) << "directory.host: " << dir_host;
@@ -201,12 +207,14 @@ int main(int argc, char **argv) {
 
   for (size_t i = 0; i < blocks.size(); ++i) {
     blocks[i] =
-        std::make_shared<block>(block_ids[i], block_capacity, memory_mode, mem_kind, address, auto_scaling_port);
+        std::make_shared<block>(block_ids[i], block_capacity, memory_mode, mem_kind, address, auto_scaling_port,
+                                block_allocator);
   }
   LOG(log_level::info) << "Created " << blocks.size() << " blocks";
 
   std::exception_ptr auto_scaling_exception = nullptr;
-  auto scaling_server = auto_scaling_server::create(dir_host, dir_port, address, auto_scaling_port);
+  auto scaling_server = auto_scaling_server::create(dir_host, dir_port, address, auto_scaling_port,
+                                                     auto_scaling_workers);
   std::thread scaling_serve_thread([&auto_scaling_exception, &scaling_server, &failing_thread, & failure_condition] {
     try {
       scaling_server->serve();
@@ -4,6 +4,19 @@ exception storage_management_exception {
   1: string msg
 }
 
+struct rpc_partition_setup {
+  1: required i32 block_id,
+  2: required string partition_type,
+  3: required string backing_path,
+  4: required string partition_name,
+  5: required string partition_metadata,
+  6: required map<string, string> conf,
+  7: required string path,
+  8: required list<string> chain,
+  9: required i32 chain_role,
+  10: required string next_block_id
+}
+
 service storage_management_service {
   void create_partition(1: i32 block_id, 2: string partition_type, 3: string backing_path, 4: string partition_name,
                         6: string partition_metadata, 7: map<string, string> conf)
@@ -41,4 +54,7 @@ service storage_management_service {
 
   void update_partition_data(1: i32 block_id, 2: string partition_name, 3: string partition_metadata)
     throws (1: storage_management_exception ex),
+
+  void create_partitions(1: list<rpc_partition_setup> partitions)
+    throws (1: storage_management_exception ex),
 }
\ No newline at end of file